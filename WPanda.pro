@@ -1,2 +1,6 @@
 TEMPLATE = subdirs
-SUBDIRS = app test
+SUBDIRS = sim app test bench
+
+app.depends = sim
+test.depends = sim
+bench.depends = sim
@@ -18,6 +18,11 @@ SOURCES += main.cpp
 
 DISTFILES += resources/postinst
 
+# lupdate only reads the sources of this project, so the library is listed for it.
+lupdate_only {
+    include(../sim/sim.pri)
+}
+
 TRANSLATIONS += \
     resources/translations/wpanda_en.ts \
     resources/translations/wpanda_pt_BR.ts
@@ -279,6 +279,10 @@ void CodeGenerator::assignVariablesRec(const QVector<GraphicElement *> &elements
             //      assignVariablesRec(icElms);
             //      out << "    // End of " << ic->getLabel() << endl;
         }
+        if (elm->busWidth() > 1) {
+            throw Pandaception(tr("Bus not supported: ") + elm->objectName());
+        }
+
         if (elm->inputs().isEmpty() || elm->outputs().isEmpty()) {
             continue;
         }
@@ -12,6 +12,7 @@
 #include "graphicelementinput.h"
 #include "lengthdialog.h"
 #include "mainwindow.h"
+#include "netlist.h"
 #include "settings.h"
 #include "simulationblocker.h"
 
@@ -97,6 +98,7 @@ BewavedDolphin::BewavedDolphin(Scene *scene, const bool askConnection, MainWindo
     connect(m_ui->actionExportToPdf,   &QAction::triggered, this, &BewavedDolphin::on_actionExportToPdf_triggered);
     connect(m_ui->actionExportToPng,   &QAction::triggered, this, &BewavedDolphin::on_actionExportToPng_triggered);
     connect(m_ui->actionFitScreen,     &QAction::triggered, this, &BewavedDolphin::on_actionFitScreen_triggered);
+    connect(m_ui->actionGateDelays,    &QAction::toggled,   this, &BewavedDolphin::run);
     connect(m_ui->actionInvert,        &QAction::triggered, this, &BewavedDolphin::on_actionInvert_triggered);
     connect(m_ui->actionLoad,          &QAction::triggered, this, &BewavedDolphin::on_actionLoad_triggered);
     connect(m_ui->actionPaste,         &QAction::triggered, this, &BewavedDolphin::on_actionPaste_triggered);
@@ -346,14 +348,155 @@ void BewavedDolphin::loadSignals(QStringList &inputLabels, QStringList &outputLa
 
 void BewavedDolphin::run()
 {
+    SimulationBlocker simulationBlocker(m_simulation);
+
+    if (m_ui->actionGateDelays->isChecked()) {
+        if (auto *netlist = validNetlist()) {
+            runTimed(netlist);
+            return;
+        }
+    }
+
+    if (auto *netlist = combinationalNetlist()) {
+        runCombinational(netlist);
+        return;
+    }
+
     run2();
-    run2();
+}
+
+Netlist *BewavedDolphin::combinationalNetlist()
+{
+    auto *netlist = validNetlist();
+    return (netlist && netlist->isCombinational()) ? netlist : nullptr;
+}
+
+Netlist *BewavedDolphin::validNetlist()
+{
+    auto *netlist = m_simulation->netlist();
+
+    if (!netlist) {
+        return nullptr;
+    }
+
+    for (auto *output : qAsConst(m_outputs)) {
+        if (!output->logic()->isValid()) {
+            return nullptr;
+        }
+    }
+
+    return netlist;
+}
+
+void BewavedDolphin::loadColumn(Netlist *netlist, const int column)
+{
+    int row = 0;
+
+    for (auto *input : qAsConst(m_inputs)) {
+        for (int port = 0; port < input->outputSize(); ++port) {
+            input->setOn(static_cast<bool>(m_model->index(row, column).data().toInt()), port);
+            ++row;
+        }
+
+        if (input->updateOutputs()) {
+            netlist->loadOutputs(input->logic());
+        }
+    }
+}
+
+void BewavedDolphin::runTimed(Netlist *netlist)
+{
+    qCDebug(zero) << tr("Timed simulation: one column per unit of time.");
+
+    // Starts from the settled state of the first column, so only the changes between columns take time.
+    loadColumn(netlist, 0);
+    netlist->update();
+    netlist->setTimed(true);
+
+    for (int column = 0; column < m_model->columnCount(); ++column) {
+        loadColumn(netlist, column);
+        netlist->advance(netlist->time() + 1);
+
+        int row = m_inputPorts;
+
+        for (auto *output : qAsConst(m_outputs)) {
+            for (int port = 0; port < output->inputSize(); ++port) {
+                createElement(row, column, netlist->value(netlist->inputSlot(output->logic(), port)), false);
+                ++row;
+            }
+        }
+    }
+
+    netlist->setTimed(false);
+    restoreInputs();
+}
+
+void BewavedDolphin::runCombinational(Netlist *netlist)
+{
+    qCDebug(zero) << tr("Combinational circuit: simulating 64 columns at once.");
+    const int columns = m_model->columnCount();
+    QVector<QVector<quint64>> inputWords(m_inputPorts, QVector<quint64>((columns + 63) / 64, 0));
+
+    for (int row = 0; row < m_inputPorts; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            if (m_model->index(row, column).data().toInt() != 0) {
+                inputWords[row][column / 64] |= quint64(1) << (column % 64);
+            }
+        }
+    }
+
+    QVector<QVector<quint64>> outputWords;
+    simulateCombinational(netlist, inputWords, outputWords);
+
+    qCDebug(four) << tr("Setting the computed output values to the waveform results.");
+
+    for (int row = 0; row < outputWords.size(); ++row) {
+        for (int column = 0; column < columns; ++column) {
+            const int value = (outputWords.at(row).at(column / 64) >> (column % 64)) & 1;
+            createElement(m_inputPorts + row, column, value, false);
+        }
+    }
+}
+
+void BewavedDolphin::simulateCombinational(Netlist *netlist, const QVector<QVector<quint64>> &inputWords, QVector<QVector<quint64>> &outputWords)
+{
+    QVector<int> inputSlots;
+    QVector<int> outputSlots;
+
+    for (auto *input : qAsConst(m_inputs)) {
+        for (int port = 0; port < input->outputSize(); ++port) {
+            inputSlots.append(netlist->outputSlot(input->logic(), port));
+        }
+    }
+
+    for (auto *output : qAsConst(m_outputs)) {
+        for (int port = 0; port < output->inputSize(); ++port) {
+            outputSlots.append(netlist->inputSlot(output->logic(), port));
+        }
+    }
+
+    const int words = inputWords.isEmpty() ? 0 : inputWords.constFirst().size();
+    outputWords = QVector<QVector<quint64>>(outputSlots.size(), QVector<quint64>(words, 0));
+    auto lanes = netlist->lanes();
+
+    for (int word = 0; word < words; ++word) {
+        for (int row = 0; row < inputSlots.size(); ++row) {
+            lanes[inputSlots.at(row)] = inputWords.at(row).at(word);
+        }
+
+        netlist->updateLanes(lanes);
+
+        for (int row = 0; row < outputSlots.size(); ++row) {
+            outputWords[row][word] = lanes[outputSlots.at(row)];
+        }
+    }
 }
 
 void BewavedDolphin::run2()
 {
     qCDebug(zero) << tr("Creating class to pause main window simulator while creating waveform.");
     SimulationBlocker simulationBlocker(m_simulation);
+    QStringList oscillating;
 
     for (int column = 0; column < m_model->columnCount(); ++column) {
         qCDebug(four) << tr("Itr: ") << column << tr(", inputs: ") << m_inputs.size();
@@ -368,9 +511,10 @@ void BewavedDolphin::run2()
         }
 
         qCDebug(four) << tr("Updating the values of the circuit logic based on current input values.");
-        m_simulation->update();
-        m_simulation->update();
-        m_simulation->update();
+
+        if (!m_simulation->evaluateUntilStable()) {
+            oscillating.append(QString::number(column));
+        }
 
         qCDebug(four) << tr("Setting the computed output values to the waveform results.");
         row = m_inputPorts;
@@ -384,6 +528,12 @@ void BewavedDolphin::run2()
         }
     }
 
+    if (!oscillating.isEmpty()) {
+        const QString message = tr("The circuit did not settle at columns %1, it may oscillate.").arg(oscillating.join(", "));
+        qCDebug(zero) << message;
+        m_ui->statusbar->showMessage(message);
+    }
+
     qCDebug(three) << tr("Setting inputs back to old values.");
     restoreInputs();
 }
@@ -574,6 +724,13 @@ void BewavedDolphin::print()
 
 void BewavedDolphin::saveToTxt(QTextStream &stream)
 {
+    SimulationBlocker simulationBlocker(m_simulation);
+
+    if (auto *netlist = combinationalNetlist()) {
+        saveCombinationalToTxt(netlist, stream);
+        return;
+    }
+
     on_actionCombinational_triggered();
 
     const int truthTableSize = std::pow(2, m_inputPorts);
@@ -600,6 +757,53 @@ void BewavedDolphin::saveToTxt(QTextStream &stream)
     }
 }
 
+void BewavedDolphin::saveCombinationalToTxt(Netlist *netlist, QTextStream &stream)
+{
+    qCDebug(zero) << tr("Combinational circuit: writing the truth table without filling the waveform.");
+    const int truthTableSize = std::pow(2, m_inputPorts);
+    const int words = (truthTableSize + 63) / 64;
+
+    // Same signals as on_actionCombinational_triggered(): row N toggles every 2^N columns, up to 2^19.
+    const quint64 patterns[] = {0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+                                0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000};
+
+    QVector<QVector<quint64>> inputWords(m_inputPorts, QVector<quint64>(words, 0));
+
+    for (int row = 0; row < m_inputPorts; ++row) {
+        const int shift = std::min(row, 19);
+
+        for (int word = 0; word < words; ++word) {
+            inputWords[row][word] = (shift < 6) ? patterns[shift] : (((word >> (shift - 6)) & 1) ? ~quint64(0) : 0);
+        }
+    }
+
+    QVector<QVector<quint64>> outputWords;
+    simulateCombinational(netlist, inputWords, outputWords);
+
+    const auto writeRow = [&](const int row) {
+        const auto &rowWords = (row < m_inputPorts) ? inputWords.at(row) : outputWords.at(row - m_inputPorts);
+        QString line(truthTableSize, '0');
+
+        for (int column = 0; column < truthTableSize; ++column) {
+            if ((rowWords.at(column / 64) >> (column % 64)) & 1) {
+                line[column] = '1';
+            }
+        }
+
+        stream << line << " : \"" << m_model->verticalHeaderItem(row)->text() << "\"\n";
+    };
+
+    for (int row = 0; row < m_inputs.size(); ++row) {
+        writeRow(row);
+    }
+
+    stream << "\n";
+
+    for (int row = m_inputs.size(); row < m_inputPorts + outputWords.size(); ++row) {
+        writeRow(row);
+    }
+}
+
 void BewavedDolphin::on_actionSetTo0_triggered()
 {
     qCDebug(zero) << tr("Pressed 0.");
@@ -14,6 +14,7 @@
 
 class GraphicsView;
 class MainWindow;
+class Netlist;
 class QItemSelection;
 class QSaveFile;
 
@@ -68,6 +69,9 @@ protected:
 private:
     Q_DISABLE_COPY(BewavedDolphin)
 
+    Netlist *combinationalNetlist();
+    //! Netlist of the simulation, or nullptr if any output is not connected.
+    Netlist *validNetlist();
     bool checkSave();
     int sectionFirstColumn(const QItemSelection &ranges);
     int sectionFirstRow(const QItemSelection &ranges);
@@ -80,6 +84,8 @@ private:
     void load(QDataStream &stream);
     void load(QFile &file);
     void load(const QString &fileName);
+    //! Sets the inputs to the values of @p column and copies them to @p netlist.
+    void loadColumn(Netlist *netlist, const int column);
     void loadElements();
     void loadFromTerminal();
     void loadNewTable();
@@ -116,10 +122,15 @@ private:
     void restoreInputs();
     void run();
     void run2();
+    void runCombinational(Netlist *netlist);
+    //! Fills the waveform with the propagation delays of the elements, one column per unit of simulated time.
+    void runTimed(Netlist *netlist);
     void save(QDataStream &stream);
     void save(QSaveFile &file);
     void save(const QString &fileName);
+    void saveCombinationalToTxt(Netlist *netlist, QTextStream &stream);
     void setLength(const int simLength, const bool runSimulation);
+    void simulateCombinational(Netlist *netlist, const QVector<QVector<quint64>> &inputWords, QVector<QVector<quint64>> &outputWords);
     void zoomChanged();
 
     Ui::BewavedDolphin *m_ui;
@@ -0,0 +1,116 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "clockqueue.h"
+
+#include "logicelement.h"
+#include "netlist.h"
+
+#include <cmath>
+#include <limits>
+
+void ClockQueue::addClock(LogicElement *logic, const double frequency)
+{
+    if (frequency <= 0) {
+        return;
+    }
+
+    const ClockData clock{logic, qMax(static_cast<double>(second) / (2 * frequency), 1.0), m_time, 0};
+    m_clocks.push_back(clock);
+    m_wheel.schedule({nextEdge(clock), static_cast<int>(m_clocks.size()) - 1});
+}
+
+void ClockQueue::clear()
+{
+    m_wheel.clear();
+    m_clocks.clear();
+    m_time = 0;
+    m_rebase = true;
+}
+
+bool ClockQueue::isEmpty() const
+{
+    return m_clocks.empty();
+}
+
+quint64 ClockQueue::time() const
+{
+    return m_time;
+}
+
+double ClockQueue::realTimeFactor() const
+{
+    return m_realTimeFactor;
+}
+
+void ClockQueue::setRealTimeFactor(const double factor)
+{
+    m_realTimeFactor = qMax(factor, 0.0);
+    m_rebase = true;
+}
+
+void ClockQueue::rebase()
+{
+    m_rebase = true;
+}
+
+quint64 ClockQueue::nextEdge(const ClockData &clock)
+{
+    return clock.origin + static_cast<quint64>(std::llround(static_cast<double>(clock.edges + 1) * clock.halfPeriod));
+}
+
+bool ClockQueue::advance(Netlist *netlist, const quint64 time, const std::chrono::steady_clock::time_point deadline)
+{
+    int instants = 0;
+
+    while (m_wheel.takeNext(time, m_due)) {
+        for (const auto &edge : m_due) {
+            auto &clock = m_clocks[edge.clock];
+            clock.logic->setOutputValue(!clock.logic->outputValue());
+            netlist->loadOutputs(clock.logic);
+            ++clock.edges;
+            m_wheel.schedule({nextEdge(clock), edge.clock});
+        }
+
+        m_due.clear();
+        m_time = m_wheel.time();
+        netlist->update();
+
+        // Reading the clock costs about as much as a small update, so the deadline is only checked now and then.
+        if ((++instants % 16 == 0) && (std::chrono::steady_clock::now() >= deadline)) {
+            return false;
+        }
+    }
+
+    if (time != std::numeric_limits<quint64>::max()) {
+        m_time = time;
+    }
+
+    return true;
+}
+
+void ClockQueue::run(Netlist *netlist, const std::chrono::microseconds budget)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if (m_rebase) {
+        m_wallBase = now;
+        m_timeBase = m_time;
+        m_rebase = false;
+    }
+
+    if (m_clocks.empty()) {
+        return;
+    }
+
+    quint64 target = std::numeric_limits<quint64>::max();
+
+    if (m_realTimeFactor > 0) {
+        const double elapsed = std::chrono::duration<double, std::nano>(now - m_wallBase).count() * m_realTimeFactor;
+        target = m_timeBase + static_cast<quint64>(elapsed);
+    }
+
+    if (!advance(netlist, target, now + budget) && (m_realTimeFactor > 0)) {
+        m_rebase = true;
+    }
+}
@@ -0,0 +1,85 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "timingwheel.h"
+
+#include <QtGlobal>
+
+#include <chrono>
+#include <vector>
+
+class LogicElement;
+class Netlist;
+
+/**
+ * @brief Clocks of a simulation, toggled by events on a simulated time base.
+ *
+ * Each clock edge is an event on a TimingWheel, keyed by its time in nanoseconds of simulated time, so a clock
+ * costs nothing between its edges and clocks far faster than the wall-clock timer are not aliased. Edges are
+ * applied straight to the logic elements of the clocks, and the netlist is updated once per instant with edges.
+ *
+ * The simulated time follows the wall-clock time scaled by a real-time factor. With a factor of zero, every run
+ * simulates as many edges as fit in its budget of wall-clock time.
+ */
+class ClockQueue
+{
+public:
+    //! Simulated time that passes in a second, in nanoseconds.
+    static constexpr quint64 second = 1'000'000'000;
+
+    //! Toggles the output of @p logic every half period of @p frequency, starting half a period from now.
+    void addClock(LogicElement *logic, const double frequency);
+
+    //! Removes every clock and moves the simulated time back to zero.
+    void clear();
+
+    bool isEmpty() const;
+
+    //! Current simulated time, in nanoseconds.
+    quint64 time() const;
+
+    //! Seconds of simulated time per second of wall-clock time, or zero to run as fast as possible.
+    double realTimeFactor() const;
+    void setRealTimeFactor(const double factor);
+
+    //! Counts the wall-clock time from the next run() again, so the time spent paused is not simulated.
+    void rebase();
+
+    /**
+     * @brief Applies, in order, every clock edge due until @p time, updating @p netlist after each instant.
+     *
+     * Stops early once @p deadline is passed and returns false, with the simulated time at the last instant applied.
+     */
+    bool advance(Netlist *netlist, const quint64 time, const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+
+    //! Catches up with the wall-clock time, spending at most @p budget of it. When the edges do not fit in the
+    //! budget, the rest are dropped instead of being made up for later, so the simulation slows down.
+    void run(Netlist *netlist, const std::chrono::microseconds budget);
+
+private:
+    struct Edge {
+        quint64 time;
+        int clock;
+    };
+
+    struct ClockData {
+        LogicElement *logic;
+        double halfPeriod;
+        quint64 origin;
+        quint64 edges;
+    };
+
+    //! Time of the next edge of a clock, counted from its origin so rounding errors do not add up.
+    static quint64 nextEdge(const ClockData &clock);
+
+    TimingWheel<Edge> m_wheel;
+    std::vector<ClockData> m_clocks;
+    std::vector<Edge> m_due;
+    std::chrono::steady_clock::time_point m_wallBase;
+    double m_realTimeFactor = 1.0;
+    bool m_rebase = true;
+    quint64 m_time = 0;
+    quint64 m_timeBase = 0;
+};
@@ -139,6 +139,19 @@ GraphicElement *findElm(const int id)
     return dynamic_cast<GraphicElement *>(ElementFactory::itemById(id));
 }
 
+QList<GraphicElement *> graphicElements(const QList<QGraphicsItem *> &items)
+{
+    QList<GraphicElement *> elements;
+
+    for (auto *item : items) {
+        if (item->type() == GraphicElement::Type) {
+            elements.append(qgraphicsitem_cast<GraphicElement *>(item));
+        }
+    }
+
+    return elements;
+}
+
 void saveItems(QByteArray &itemData, const QList<QGraphicsItem *> &items, const QList<int> &otherIds)
 {
     itemData.clear();
@@ -224,8 +237,11 @@ void AddItemsCommand::undo()
     SimulationBlocker blocker(m_scene->simulation());
     const auto items = findItems(m_ids);
     saveItems(m_itemData, items, m_otherIds);
+    NetlistDelta delta;
+    delta.removed = graphicElements(items);
     deleteItems(m_scene, items);
-    m_scene->setCircuitUpdateRequired();
+    delta.rewired = findElements(m_otherIds);
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void AddItemsCommand::redo()
@@ -233,7 +249,11 @@ void AddItemsCommand::redo()
     qCDebug(zero) << text();
     SimulationBlocker blocker(m_scene->simulation());
     loadItems(m_scene, m_itemData, m_ids, m_otherIds);
-    m_scene->setCircuitUpdateRequired();
+    // The first redo finds the items added by the constructor.
+    NetlistDelta delta;
+    delta.added = graphicElements(findItems(m_ids));
+    delta.rewired = findElements(m_otherIds);
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 DeleteItemsCommand::DeleteItemsCommand(const QList<QGraphicsItem *> &items, Scene *scene, QUndoCommand *parent)
@@ -249,8 +269,10 @@ void DeleteItemsCommand::undo()
 {
     qCDebug(zero) << text();
     SimulationBlocker blocker(m_scene->simulation());
-    loadItems(m_scene, m_itemData, m_ids, m_otherIds);
-    m_scene->setCircuitUpdateRequired();
+    NetlistDelta delta;
+    delta.added = graphicElements(loadItems(m_scene, m_itemData, m_ids, m_otherIds));
+    delta.rewired = findElements(m_otherIds);
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void DeleteItemsCommand::redo()
@@ -259,8 +281,11 @@ void DeleteItemsCommand::redo()
     SimulationBlocker blocker(m_scene->simulation());
     const auto items = findItems(m_ids);
     saveItems(m_itemData, items, m_otherIds);
+    NetlistDelta delta;
+    delta.removed = graphicElements(items);
     deleteItems(m_scene, items);
-    m_scene->setCircuitUpdateRequired();
+    delta.rewired = findElements(m_otherIds);
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 RotateCommand::RotateCommand(const QList<GraphicElement *> &items, const int angle, Scene *scene, QUndoCommand *parent)
@@ -388,14 +413,19 @@ void UpdateCommand::undo()
 {
     qCDebug(zero) << text();
     loadData(m_oldData);
-    m_scene->setCircuitUpdateRequired();
+    // Elements whose ports or IC file changed get their logic generated again.
+    NetlistDelta delta;
+    delta.rewired = findElements(m_ids);
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void UpdateCommand::redo()
 {
     qCDebug(zero) << text();
     loadData(m_newData);
-    m_scene->setCircuitUpdateRequired();
+    NetlistDelta delta;
+    delta.rewired = findElements(m_ids);
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void UpdateCommand::loadData(QByteArray &itemData)
@@ -483,7 +513,10 @@ void SplitCommand::redo()
     conn1->updatePosFromPorts();
     conn2->updatePosFromPorts();
 
-    m_scene->setCircuitUpdateRequired();
+    NetlistDelta delta;
+    delta.added = {node};
+    delta.rewired = {elm2};
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void SplitCommand::undo()
@@ -509,7 +542,10 @@ void SplitCommand::undo()
     delete conn2;
     delete node;
 
-    m_scene->setCircuitUpdateRequired();
+    NetlistDelta delta;
+    delta.removed = {node};
+    delta.rewired = {elm2};
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 MorphCommand::MorphCommand(const QList<GraphicElement *> &elements, ElementType type, Scene *scene, QUndoCommand *parent)
@@ -540,7 +576,11 @@ void MorphCommand::undo()
     }
 
     transferConnections(newElms, oldElms);
-    m_scene->setCircuitUpdateRequired();
+
+    NetlistDelta delta;
+    delta.added = oldElms;
+    delta.removed = newElms;
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void MorphCommand::redo()
@@ -555,7 +595,11 @@ void MorphCommand::redo()
     }
 
     transferConnections(oldElms, newElms);
-    m_scene->setCircuitUpdateRequired();
+
+    NetlistDelta delta;
+    delta.added = newElms;
+    delta.removed = oldElms;
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void MorphCommand::transferConnections(QList<GraphicElement *> from, QList<GraphicElement *> to)
@@ -736,7 +780,10 @@ void ChangeInputSizeCommand::redo()
         m_order.append(elm->id());
     }
 
-    m_scene->setCircuitUpdateRequired();
+    // The resized elements get their logic generated again, and their neighbors lost a connection.
+    NetlistDelta delta;
+    delta.rewired = serializationOrder;
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void ChangeInputSizeCommand::undo()
@@ -764,7 +811,9 @@ void ChangeInputSizeCommand::undo()
         elm->setSelected(true);
     }
 
-    m_scene->setCircuitUpdateRequired();
+    NetlistDelta delta;
+    delta.rewired = serializationOrder;
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 ChangeOutputSizeCommand::ChangeOutputSizeCommand(const QList<GraphicElement *> &elements, const int newOutputSize, Scene *scene, QUndoCommand *parent)
@@ -827,7 +876,10 @@ void ChangeOutputSizeCommand::redo()
         m_order.append(elm->id());
     }
 
-    m_scene->setCircuitUpdateRequired();
+    // The resized elements get their logic generated again, and their neighbors lost a connection.
+    NetlistDelta delta;
+    delta.rewired = serializationOrder;
+    m_scene->setCircuitUpdateRequired(delta);
 }
 
 void ChangeOutputSizeCommand::undo()
@@ -855,5 +907,7 @@ void ChangeOutputSizeCommand::undo()
         elm->setSelected(true);
     }
 
-    m_scene->setCircuitUpdateRequired();
+    NetlistDelta delta;
+    delta.rewired = serializationOrder;
+    m_scene->setCircuitUpdateRequired(delta);
 }
@@ -2,9 +2,6 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "common.h"
-#include "graphicelement.h"
-#include "qneport.h"
-#include "qneconnection.h"
 
 Q_LOGGING_CATEGORY(zero,  "0")
 Q_LOGGING_CATEGORY(one,   "1")
@@ -36,50 +33,3 @@ Pandaception::Pandaception(const QString &message)
     : std::runtime_error(message.toStdString())
 {
 }
-
-QVector<GraphicElement *> Common::sortGraphicElements(QVector<GraphicElement *> elements)
-{
-    QHash<GraphicElement *, bool> beingVisited;
-    QHash<GraphicElement *, int> priorities;
-
-    for (auto *elm : elements) {
-        calculatePriority(elm, beingVisited, priorities);
-    }
-
-    std::sort(elements.begin(), elements.end(), [priorities](const auto &e1, const auto &e2) {
-        return priorities.value(e1) > priorities.value(e2);
-    });
-
-    return elements;
-}
-
-int Common::calculatePriority(GraphicElement *elm, QHash<GraphicElement *, bool> &beingVisited, QHash<GraphicElement *, int> &priorities)
-{
-    if (!elm) {
-        return 0;
-    }
-
-    if (beingVisited.contains(elm) && beingVisited.value(elm)) {
-        return 0;
-    }
-
-    if (priorities.contains(elm)) {
-        return priorities.value(elm);
-    }
-
-    beingVisited[elm] = true;
-    int max = 0;
-
-    for (auto *port : elm->outputs()) {
-        for (auto *conn : port->connections()) {
-            if (auto *successor = conn->endPort()) {
-                max = qMax(calculatePriority(successor->graphicElement(), beingVisited, priorities), max);
-            }
-        }
-    }
-
-    int priority = max + 1;
-    priorities[elm] = priority;
-    beingVisited[elm] = false;
-    return priority;
-}
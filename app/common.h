@@ -44,5 +44,4 @@ class Common
 {
 public:
     static QVector<GraphicElement *> sortGraphicElements(QVector<GraphicElement *> elements);
-    static int calculatePriority(GraphicElement *elm, QHash<GraphicElement *, bool> &beingVisited, QHash<GraphicElement *, int> &priorities);
 };
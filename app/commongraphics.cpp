@@ -0,0 +1,33 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "common.h"
+#include "graphicelement.h"
+#include "levelizer.h"
+#include "qneport.h"
+#include "qneconnection.h"
+
+QVector<GraphicElement *> Common::sortGraphicElements(QVector<GraphicElement *> elements)
+{
+    const auto successors = [](const GraphicElement *elm) {
+        QVector<GraphicElement *> successors;
+
+        for (auto *port : elm->outputs()) {
+            for (auto *conn : port->connections()) {
+                if (auto *successor = conn->endPort(); successor && successor->graphicElement()) {
+                    successors.append(successor->graphicElement());
+                }
+            }
+        }
+
+        return successors;
+    };
+
+    const Levelizer<GraphicElement *> levelizer(elements, successors, [](const GraphicElement *) { return -1; });
+
+    std::stable_sort(elements.begin(), elements.end(), [&levelizer](const auto &e1, const auto &e2) {
+        return levelizer.priority(e1) > levelizer.priority(e2);
+    });
+
+    return elements;
+}
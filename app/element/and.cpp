@@ -22,4 +22,5 @@ And::And(QGraphicsItem *parent)
     setPixmap(0);
 
     setCanChangeSkin(true);
+    setHasBusWidth(true);
 }
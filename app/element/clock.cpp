@@ -6,10 +6,6 @@
 #include "globalproperties.h"
 #include "qneport.h"
 
-#include <chrono>
-
-using namespace std::chrono_literals;
-
 namespace
 {
     int id = qRegisterMetaType<Clock>();
@@ -40,25 +36,6 @@ Clock::Clock(QGraphicsItem *parent)
     Clock::setOff();
 }
 
-void Clock::updateClock()
-{
-    if (m_locked) {
-        return;
-    }
-
-    if (m_reset) {
-        resetClock();
-        return;
-    }
-
-    const auto duration = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - m_timePoint);
-
-    if (duration > m_interval) {
-        m_timePoint = std::chrono::steady_clock::now();
-        setOn(!m_isOn);
-    }
-}
-
 bool Clock::isOn(const int port) const
 {
     Q_UNUSED(port)
@@ -131,27 +108,16 @@ float Clock::frequency() const
 
 void Clock::setFrequency(const float freq)
 {
-    if (qFuzzyIsNull(freq)) {
-        return;
-    }
-
-    std::chrono::duration<float, std::milli> auxInterval = 1s / (2 * freq);
-
-    if (auxInterval.count() <= 0) {
+    if (qFuzzyIsNull(freq) || (freq < 0)) {
         return;
     }
 
-    m_interval = auxInterval;
     m_frequency = static_cast<double>(freq);
-    m_timePoint = std::chrono::steady_clock::now();
-    m_reset = true;
 }
 
 void Clock::resetClock()
 {
     setOn();
-    m_timePoint = std::chrono::steady_clock::now();
-    m_reset = false;
 }
 
 QString Clock::genericProperties()
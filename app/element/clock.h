@@ -23,14 +23,10 @@ public:
     void setOn() override;
     void setOn(const bool value, const int port = 0) override;
     void setSkin(const bool defaultSkin, const QString &fileName) override;
-    void updateClock();
 
 private:
     bool m_isOn = false;
-    bool m_reset = true;
     double m_frequency = 0;
-    std::chrono::duration<float, std::milli> m_interval{};
-    std::chrono::steady_clock::time_point m_timePoint;
 };
 
 Q_DECLARE_METATYPE(Clock)
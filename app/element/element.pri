@@ -13,6 +13,7 @@ SOURCES += \
     $$PWD/inputswitch.cpp \
     $$PWD/inputvcc.cpp \
     $$PWD/jkflipflop.cpp \
+    $$PWD/joiner.cpp \
     $$PWD/led.cpp \
     $$PWD/line.cpp \
     $$PWD/mux.cpp \
@@ -22,6 +23,7 @@ SOURCES += \
     $$PWD/not.cpp \
     $$PWD/or.cpp \
     $$PWD/remotedevice.cpp \
+    $$PWD/splitter.cpp \
     $$PWD/srflipflop.cpp \
     $$PWD/text.cpp \
     $$PWD/tflipflop.cpp \
@@ -43,6 +45,7 @@ HEADERS += \
     $$PWD/inputswitch.h \
     $$PWD/inputvcc.h \
     $$PWD/jkflipflop.h \
+    $$PWD/joiner.h \
     $$PWD/led.h \
     $$PWD/line.h \
     $$PWD/mux.h \
@@ -52,6 +55,7 @@ HEADERS += \
     $$PWD/not.h \
     $$PWD/or.h \
     $$PWD/remotedevice.h \
+    $$PWD/splitter.h \
     $$PWD/srflipflop.h \
     $$PWD/text.h \
     $$PWD/tflipflop.h \
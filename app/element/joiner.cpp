@@ -0,0 +1,44 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "joiner.h"
+
+#include "globalproperties.h"
+#include "qneport.h"
+
+namespace
+{
+    int id = qRegisterMetaType<Joiner>();
+}
+
+Joiner::Joiner(QGraphicsItem *parent)
+    : GraphicElement(ElementType::Joiner, ElementGroup::Mux, ":/basic/joiner.svg", tr("JOINER"), tr("Joiner"), 2, 16, 1, 1, parent)
+{
+    if (GlobalProperties::skipInit) {
+        return;
+    }
+
+    m_defaultSkins << m_pixmapPath;
+    m_alternativeSkins = m_defaultSkins;
+    setPixmap(0);
+
+    setCanChangeSkin(true);
+
+    Joiner::updatePortsProperties();
+}
+
+int Joiner::portWidth(const QNEPort *port) const
+{
+    return port->isOutput() ? inputSize() : 1;
+}
+
+void Joiner::updatePortsProperties()
+{
+    GraphicElement::updatePortsProperties();
+
+    for (int index = 0; index < inputSize(); ++index) {
+        inputPort(index)->setName(QString::number(index));
+    }
+
+    outputPort()->setName("Out");
+}
@@ -0,0 +1,20 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "graphicelement.h"
+
+//! Joins single wires into a bus, the first input being the lowest bit.
+class Joiner : public GraphicElement
+{
+    Q_OBJECT
+
+public:
+    explicit Joiner(QGraphicsItem *parent = nullptr);
+
+    int portWidth(const QNEPort *port) const override;
+    void updatePortsProperties() override;
+};
+
+Q_DECLARE_METATYPE(Joiner)
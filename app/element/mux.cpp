@@ -23,6 +23,7 @@ Mux::Mux(QGraphicsItem *parent)
     setPixmap(0);
 
     setCanChangeSkin(true);
+    setHasBusWidth(true);
 
     Mux::updatePortsProperties();
 }
@@ -35,3 +36,9 @@ void Mux::updatePortsProperties()
 
     outputPort(0)->setPos(48, 32); outputPort(0)->setName("Out");
 }
+
+int Mux::portWidth(const QNEPort *port) const
+{
+    // The select input stays a single wire.
+    return (port->isInput() && (port->index() == 2)) ? 1 : busWidth();
+}
@@ -12,6 +12,7 @@ class Mux : public GraphicElement
 public:
     explicit Mux(QGraphicsItem *parent = nullptr);
 
+    int portWidth(const QNEPort *port) const override;
     void updatePortsProperties() override;
 };
 
@@ -22,4 +22,5 @@ Not::Not(QGraphicsItem *parent)
     setPixmap(0);
 
     setCanChangeSkin(true);
+    setHasBusWidth(true);
 }
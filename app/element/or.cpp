@@ -22,4 +22,5 @@ Or::Or(QGraphicsItem *parent)
     setPixmap(0);
 
     setCanChangeSkin(true);
+    setHasBusWidth(true);
 }
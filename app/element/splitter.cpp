@@ -0,0 +1,44 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "splitter.h"
+
+#include "globalproperties.h"
+#include "qneport.h"
+
+namespace
+{
+    int id = qRegisterMetaType<Splitter>();
+}
+
+Splitter::Splitter(QGraphicsItem *parent)
+    : GraphicElement(ElementType::Splitter, ElementGroup::Mux, ":/basic/splitter.svg", tr("SPLITTER"), tr("Splitter"), 1, 1, 2, 16, parent)
+{
+    if (GlobalProperties::skipInit) {
+        return;
+    }
+
+    m_defaultSkins << m_pixmapPath;
+    m_alternativeSkins = m_defaultSkins;
+    setPixmap(0);
+
+    setCanChangeSkin(true);
+
+    Splitter::updatePortsProperties();
+}
+
+int Splitter::portWidth(const QNEPort *port) const
+{
+    return port->isInput() ? outputSize() : 1;
+}
+
+void Splitter::updatePortsProperties()
+{
+    GraphicElement::updatePortsProperties();
+
+    inputPort()->setName("In");
+
+    for (int index = 0; index < outputSize(); ++index) {
+        outputPort(index)->setName(QString::number(index));
+    }
+}
@@ -0,0 +1,20 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "graphicelement.h"
+
+//! Splits a bus into single wires, one output per bit, the first output being the lowest bit.
+class Splitter : public GraphicElement
+{
+    Q_OBJECT
+
+public:
+    explicit Splitter(QGraphicsItem *parent = nullptr);
+
+    int portWidth(const QNEPort *port) const override;
+    void updatePortsProperties() override;
+};
+
+Q_DECLARE_METATYPE(Splitter)
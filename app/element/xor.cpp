@@ -22,4 +22,5 @@ Xor::Xor(QGraphicsItem *parent)
     setPixmap(0);
 
     setCanChangeSkin(true);
+    setHasBusWidth(true);
 }
@@ -30,10 +30,12 @@ ElementEditor::ElementEditor(QWidget *parent)
 
     m_ui->checkBoxLocked->installEventFilter(this);
     m_ui->comboBoxAudio->installEventFilter(this);
+    m_ui->comboBoxBusWidth->installEventFilter(this);
     m_ui->comboBoxColor->installEventFilter(this);
     m_ui->comboBoxInputSize->installEventFilter(this);
     m_ui->comboBoxOutputSize->installEventFilter(this);
     m_ui->comboBoxValue->installEventFilter(this);
+    m_ui->spinBoxDelay->installEventFilter(this);
     m_ui->doubleSpinBoxFrequency->installEventFilter(this);
     m_ui->lineEditElementLabel->installEventFilter(this);
     m_ui->lineEditTrigger->installEventFilter(this);
@@ -41,6 +43,7 @@ ElementEditor::ElementEditor(QWidget *parent)
 
     connect(m_ui->checkBoxLocked,         &QCheckBox::clicked,                              this, &ElementEditor::inputLocked);
     connect(m_ui->comboBoxAudio,          qOverload<int>(&QComboBox::currentIndexChanged),  this, &ElementEditor::apply);
+    connect(m_ui->comboBoxBusWidth,       qOverload<int>(&QComboBox::currentIndexChanged),  this, &ElementEditor::apply);
     connect(m_ui->comboBoxColor,          qOverload<int>(&QComboBox::currentIndexChanged),  this, &ElementEditor::apply);
     connect(m_ui->comboBoxInputSize,      qOverload<int>(&QComboBox::currentIndexChanged),  this, &ElementEditor::inputIndexChanged);
     connect(m_ui->comboBoxOutputSize,     qOverload<int>(&QComboBox::currentIndexChanged),  this, &ElementEditor::outputIndexChanged);
@@ -51,6 +54,7 @@ ElementEditor::ElementEditor(QWidget *parent)
     connect(m_ui->pushButtonChangeSkin,   &QPushButton::clicked,                            this, &ElementEditor::updateElementSkin);
     connect(m_ui->pushButtonDefaultSkin,  &QPushButton::clicked,                            this, &ElementEditor::defaultSkin);
     connect(m_ui->spinBoxPriority,        qOverload<int>(&QSpinBox::valueChanged),          this, &ElementEditor::priorityChanged);
+    connect(m_ui->spinBoxDelay,           qOverload<int>(&QSpinBox::valueChanged),          this, &ElementEditor::apply);
     connect(m_ui->pushButtonCustomConfig, &QPushButton::clicked,                            this, &ElementEditor::openCustomConfig);
 }
 
@@ -372,6 +376,8 @@ void ElementEditor::setCurrentElements(const QList<GraphicElement *> &elements)
     m_hasRotation = m_hasSameLabel = m_hasSameColors = m_hasSameFrequency = m_hasSameAudio = m_hasOnlyInputs = false;
     m_hasSameInputSize = m_hasSameOutputSize = m_hasSameOutputValue = m_hasSameTrigger = m_canMorph = m_hasSameType = false;
     m_canChangeSkin = m_hasSamePriority = false;
+    m_hasBusWidth = m_hasSameBusWidth = false;
+    m_hasDelay = m_hasSameDelay = false;
     m_hasElements = false;
 
     if (elements.isEmpty()) {
@@ -385,6 +391,8 @@ void ElementEditor::setCurrentElements(const QList<GraphicElement *> &elements)
     m_hasSameInputSize = m_hasSameOutputSize = m_hasSameOutputValue = m_hasSameTrigger = m_canMorph = m_hasSameType = true;
     m_hasRotation = m_hasSameLabel = m_hasSameColors = m_hasSameFrequency = m_hasSameAudio = m_hasOnlyInputs = true;
     m_canChangeSkin = m_hasSamePriority = true;
+    m_hasBusWidth = m_hasSameBusWidth = true;
+    m_hasDelay = m_hasSameDelay = true;
     m_hasElements = true;
     m_hasCustomConfig = true;
     show();
@@ -407,6 +415,8 @@ void ElementEditor::setCurrentElements(const QList<GraphicElement *> &elements)
         m_canChangeSkin &= elm->canChangeSkin();
         m_hasColors &= elm->hasColors();
         m_hasAudio &= elm->hasAudio();
+        m_hasBusWidth &= elm->hasBusWidth();
+        m_hasDelay &= (elm->elementType() != ElementType::IC);
         m_hasFrequency &= elm->hasFrequency();
         minimumInputs = std::max(minimumInputs, elm->minInputSize());
         maximumInputs = std::min(maximumInputs, elm->maxInputSize());
@@ -420,6 +430,8 @@ void ElementEditor::setCurrentElements(const QList<GraphicElement *> &elements)
         m_hasSameFrequency &= qFuzzyCompare(elm->frequency(), firstElement->frequency());
         m_hasSameInputSize &= (elm->inputSize() == firstElement->inputSize());
         m_hasSameOutputSize &= (elm->outputSize() == firstElement->outputSize());
+        m_hasSameBusWidth &= (elm->busWidth() == firstElement->busWidth());
+        m_hasSameDelay &= (elm->delay() == firstElement->delay());
         maxCurrentOutputSize = std::min(maxCurrentOutputSize, elm->outputSize());
 
         if (auto *elmInput = qobject_cast<GraphicElementInput *>(elm); elmInput && (group == ElementGroup::Input) && (firstElement->elementGroup() == ElementGroup::Input)) {
@@ -504,6 +516,13 @@ void ElementEditor::setCurrentElements(const QList<GraphicElement *> &elements)
         m_ui->spinBoxPriority->setValue(0);
     }
 
+    /* Delay */
+    // The elements of an IC keep the delays of the IC file.
+    m_ui->labelDelay->setVisible(m_hasDelay);
+    m_ui->spinBoxDelay->setVisible(m_hasDelay);
+    m_ui->spinBoxDelay->setEnabled(m_hasDelay);
+    m_ui->spinBoxDelay->setValue(m_hasSameDelay ? firstElement->delay() : -1);
+
     /* Frequency */
     m_ui->doubleSpinBoxFrequency->setVisible(m_hasFrequency);
     m_ui->doubleSpinBoxFrequency->setEnabled(m_hasFrequency);
@@ -576,6 +595,26 @@ void ElementEditor::setCurrentElements(const QList<GraphicElement *> &elements)
         }
     }
 
+    /* Bus width */
+    m_ui->comboBoxBusWidth->clear();
+    m_ui->labelBusWidth->setVisible(m_hasBusWidth);
+    m_ui->comboBoxBusWidth->setVisible(m_hasBusWidth);
+    m_ui->comboBoxBusWidth->setEnabled(m_hasBusWidth);
+
+    if (m_hasBusWidth) {
+        // The same widths as the output sizes, so a splitter can be fed by any bus.
+        for (const int width : {1, 2, 3, 4, 6, 8, 10, 12, 16}) {
+            m_ui->comboBoxBusWidth->addItem(QString::number(width), width);
+        }
+
+        if (m_hasSameBusWidth) {
+            m_ui->comboBoxBusWidth->setCurrentText(QString::number(firstElement->busWidth()));
+        } else {
+            m_ui->comboBoxBusWidth->addItem(m_manyBusWidths);
+            m_ui->comboBoxBusWidth->setCurrentText(m_manyBusWidths);
+        }
+    }
+
     /* Output value */
     m_ui->comboBoxValue->clear();
     m_ui->labelValue->setVisible(m_hasOnlyInputs);
@@ -662,6 +701,14 @@ void ElementEditor::apply()
             elm->setColor(m_ui->comboBoxColor->currentData().toString());
         }
 
+        if (elm->hasBusWidth() && m_ui->comboBoxBusWidth->currentData().isValid()) {
+            elm->setBusWidth(m_ui->comboBoxBusWidth->currentData().toInt());
+        }
+
+        if ((elm->elementType() != ElementType::IC) && (m_hasSameDelay || (m_ui->spinBoxDelay->value() != -1))) {
+            elm->setDelay(m_ui->spinBoxDelay->value());
+        }
+
         if (elm->hasAudio() && (m_ui->comboBoxAudio->currentText() != m_manyAudios)) {
             elm->setAudio(m_ui->comboBoxAudio->currentText());
         }
@@ -54,6 +54,7 @@ private:
     Ui::ElementEditor *m_ui;
     QList<GraphicElement *> m_elements;
     QString m_manyAudios = tr("<Many sounds>");
+    QString m_manyBusWidths = tr("<Many values>");
     QString m_manyColors = tr("<Many colors>");
     QString m_manyFreq = tr("<Many values>");
     QString m_manyIS = tr("<Many values>");
@@ -70,14 +71,18 @@ private:
     bool m_canMorph = false;
     bool m_hasAnyProperty = false;
     bool m_hasAudio = false;
+    bool m_hasBusWidth = false;
     bool m_hasColors = false;
+    bool m_hasDelay = false;
     bool m_hasElements = false;
     bool m_hasFrequency = false;
     bool m_hasLabel = false;
     bool m_hasOnlyInputs = false;
     bool m_hasRotation = false;
     bool m_hasSameAudio = false;
+    bool m_hasSameBusWidth = false;
     bool m_hasSameColors = false;
+    bool m_hasSameDelay = false;
     bool m_hasSameFrequency = false;
     bool m_hasSameInputSize = false;
     bool m_hasSameLabel = false;
@@ -6,12 +6,16 @@
 #include "common.h"
 #include "globalproperties.h"
 #include "graphicelement.h"
+#include "logicarena.h"
 #include "logicand.h"
+#include "logicbusgate.h"
+#include "logicbusmux.h"
 #include "logicdemux.h"
 #include "logicdflipflop.h"
 #include "logicdlatch.h"
 #include "logicinput.h"
 #include "logicjkflipflop.h"
+#include "logicjoiner.h"
 #include "logicmux.h"
 #include "logicnand.h"
 #include "logicnode.h"
@@ -20,6 +24,7 @@
 #include "logicnot.h"
 #include "logicor.h"
 #include "logicoutput.h"
+#include "logicsplitter.h"
 #include "logicsrflipflop.h"
 #include "logictflipflop.h"
 #include "logicxnor.h"
@@ -152,41 +157,55 @@ int ElementFactory::nextId()
     return m_lastId++;
 }
 
-std::shared_ptr<LogicElement> ElementFactory::buildLogicElement(GraphicElement *elm)
+std::shared_ptr<LogicElement> ElementFactory::buildLogicElement(GraphicElement *elm, LogicArena &arena)
 {
+    // Gates with a bus width compute whole words instead of bits.
+    if (const int width = elm->busWidth(); width > 1) {
+        switch (elm->elementType()) {
+        case ElementType::And: return arena.make<LogicBusGate>(LogicType::BusAnd, elm->inputSize(), width);
+        case ElementType::Mux: return arena.make<LogicBusMux>(width);
+        case ElementType::Not: return arena.make<LogicBusGate>(LogicType::BusNot, 1, width);
+        case ElementType::Or:  return arena.make<LogicBusGate>(LogicType::BusOr, elm->inputSize(), width);
+        case ElementType::Xor: return arena.make<LogicBusGate>(LogicType::BusXor, elm->inputSize(), width);
+        default:               throw Pandaception(tr("Bus not supported: ") + elm->objectName());
+        }
+    }
+
     switch (elm->elementType()) {
     case ElementType::Clock:
     case ElementType::InputButton:
     case ElementType::InputRotary:
-    case ElementType::InputSwitch: return std::make_shared<LogicInput>(false, elm->outputSize());
+    case ElementType::InputSwitch: return arena.make<LogicInput>(false, elm->outputSize());
 
     case ElementType::Buzzer:
     case ElementType::Display14:
     case ElementType::Display7:
-    case ElementType::Led:         return std::make_shared<LogicOutput>(elm->inputSize());
-
-    case ElementType::And:         return std::make_shared<LogicAnd>(elm->inputSize());
-    case ElementType::DFlipFlop:   return std::make_shared<LogicDFlipFlop>();
-    case ElementType::Demux:       return std::make_shared<LogicDemux>();
-    case ElementType::InputGnd:    return std::make_shared<LogicInput>(false);
-    case ElementType::InputVcc:    return std::make_shared<LogicInput>(true);
-    case ElementType::JKFlipFlop:  return std::make_shared<LogicJKFlipFlop>();
-    case ElementType::Mux:         return std::make_shared<LogicMux>();
-    case ElementType::Nand:        return std::make_shared<LogicNand>(elm->inputSize());
-    case ElementType::Node:        return std::make_shared<LogicNode>();
-    case ElementType::Nor:         return std::make_shared<LogicNor>(elm->inputSize());
-    case ElementType::Not:         return std::make_shared<LogicNot>();
-    case ElementType::Or:          return std::make_shared<LogicOr>(elm->inputSize());
-    case ElementType::RemoteDevice:return std::make_shared<LogicRemoteDevice>(dynamic_cast<RemoteDevice*>(elm));
-    case ElementType::SRFlipFlop:  return std::make_shared<LogicSRFlipFlop>();
-    case ElementType::TFlipFlop:   return std::make_shared<LogicTFlipFlop>();
-    case ElementType::Xnor:        return std::make_shared<LogicXnor>(elm->inputSize());
-    case ElementType::Xor:         return std::make_shared<LogicXor>(elm->inputSize());
-
-    case ElementType::DLatch:      return std::make_shared<LogicDLatch>();
+    case ElementType::Led:         return arena.make<LogicOutput>(elm->inputSize());
+
+    case ElementType::And:         return arena.make<LogicAnd>(elm->inputSize());
+    case ElementType::DFlipFlop:   return arena.make<LogicDFlipFlop>();
+    case ElementType::Demux:       return arena.make<LogicDemux>();
+    case ElementType::InputGnd:    return arena.make<LogicInput>(false);
+    case ElementType::InputVcc:    return arena.make<LogicInput>(true);
+    case ElementType::JKFlipFlop:  return arena.make<LogicJKFlipFlop>();
+    case ElementType::Joiner:      return arena.make<LogicJoiner>(elm->inputSize());
+    case ElementType::Mux:         return arena.make<LogicMux>();
+    case ElementType::Nand:        return arena.make<LogicNand>(elm->inputSize());
+    case ElementType::Node:        return arena.make<LogicNode>();
+    case ElementType::Nor:         return arena.make<LogicNor>(elm->inputSize());
+    case ElementType::Not:         return arena.make<LogicNot>();
+    case ElementType::Or:          return arena.make<LogicOr>(elm->inputSize());
+    case ElementType::RemoteDevice:return arena.make<LogicRemoteDevice>(dynamic_cast<RemoteDevice*>(elm));
+    case ElementType::SRFlipFlop:  return arena.make<LogicSRFlipFlop>();
+    case ElementType::Splitter:    return arena.make<LogicSplitter>(elm->outputSize());
+    case ElementType::TFlipFlop:   return arena.make<LogicTFlipFlop>();
+    case ElementType::Xnor:        return arena.make<LogicXnor>(elm->inputSize());
+    case ElementType::Xor:         return arena.make<LogicXor>(elm->inputSize());
+
+    case ElementType::DLatch:      return arena.make<LogicDLatch>();
 
     case ElementType::Line:
-    case ElementType::Text:        return std::make_shared<LogicNone>();
+    case ElementType::Text:        return arena.make<LogicNone>();
 
     default:                       throw Pandaception(tr("Not implemented yet: ") + elm->objectName());
     }
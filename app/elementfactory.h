@@ -10,6 +10,7 @@
 
 class GraphicElement;
 class ItemWithId;
+class LogicArena;
 class LogicElement;
 class QNEConnection;
 
@@ -27,7 +28,7 @@ public:
     static ElementType textToType(const QString &text);
     static GraphicElement *buildElement(const ElementType type);
     static ItemWithId *itemById(const int id);
-    static std::shared_ptr<LogicElement> buildLogicElement(GraphicElement *elm);
+    static std::shared_ptr<LogicElement> buildLogicElement(GraphicElement *elm, LogicArena &arena);
     static QPixmap pixmap(const ElementType type);
     static QString property(const ElementType type, const QString &property);
     static QString translatedName(const ElementType type);
@@ -7,11 +7,16 @@
 #include "elementfactory.h"
 #include "graphicelement.h"
 #include "ic.h"
+#include "logicarena.h"
+#include "netlist.h"
 #include "qneconnection.h"
 #include "qneport.h"
 
-ElementMapping::ElementMapping(const QVector<GraphicElement *> &elements)
-    : m_elements(elements)
+#include <algorithm>
+
+ElementMapping::ElementMapping(const QVector<GraphicElement *> &elements, const std::shared_ptr<LogicArena> &arena)
+    : m_arena(arena)
+    , m_elements(elements)
 {
     qCDebug(three) << tr("Generate Map.");
     generateMap();
@@ -28,23 +33,98 @@ ElementMapping::~ElementMapping()
 void ElementMapping::generateMap()
 {
     for (auto *elm : qAsConst(m_elements)) {
-        if (elm->elementType() == ElementType::IC) {
-            auto *ic = qobject_cast<IC *>(elm);
-            m_logicElms.append(ic->generateMap()->m_logicElms);
-            continue;
-        }
+        mapElement(elm);
+    }
+}
+
+void ElementMapping::mapElement(GraphicElement *elm)
+{
+    MappedElement mapped;
+    mapped.inputSize = elm->inputSize();
+    mapped.outputSize = elm->outputSize();
+    mapped.busWidth = elm->busWidth();
+    mapped.delay = elm->delay();
 
+    if (elm->elementType() == ElementType::IC) {
+        mapped.icMapping = qobject_cast<IC *>(elm)->generateMap(m_arena);
+        m_logicElms.append(mapped.icMapping->m_logicElms);
+    } else {
         generateLogic(elm);
+        mapped.logic = elm->logic();
+    }
+
+    m_mappedElements.insert(elm, mapped);
+}
+
+void ElementMapping::unmapElement(GraphicElement *elm, QVector<LogicElement *> &dirty, QSet<LogicElement *> &removed, QVector<std::shared_ptr<ElementMapping>> &removedMappings)
+{
+    const auto mapped = m_mappedElements.take(elm);
+    QVector<LogicElement *> logics;
+
+    if (mapped.icMapping) {
+        removedMappings.append(mapped.icMapping);
+
+        for (const auto &logic : qAsConst(mapped.icMapping->m_logicElms)) {
+            logics.append(logic.get());
+        }
+    } else {
+        logics.append(mapped.logic);
+    }
+
+    // Predecessors lose a successor, so their priorities must be computed again. Successors lose an input, and
+    // are connected again as they are rewired by the same edit.
+    for (auto *logic : qAsConst(logics)) {
+        for (const auto &inputPair : logic->inputPairs()) {
+            dirty.append(inputPair.logic);
+        }
+
+        logic->clearPredecessors();
+        logic->clearSucessors();
+        removed.insert(logic);
+    }
+}
+
+bool ElementMapping::isStale(GraphicElement *elm) const
+{
+    const auto mapped = m_mappedElements.value(elm);
+
+    if ((mapped.inputSize != elm->inputSize()) || (mapped.outputSize != elm->outputSize()) || (mapped.busWidth != elm->busWidth())
+        || (mapped.delay != elm->delay())) {
+        return true;
+    }
+
+    // Loading an IC again replaces its elements, which have no logic yet.
+    if (elm->elementType() == ElementType::IC) {
+        return !qobject_cast<IC *>(elm)->isMapped();
     }
+
+    return (mapped.logic != elm->logic());
 }
 
 void ElementMapping::generateLogic(GraphicElement *elm)
 {
-    auto logic = ElementFactory::buildLogicElement(elm);
+    auto logic = ElementFactory::buildLogicElement(elm, *m_arena);
+    logic->setDelay(elm->delay());
     elm->setLogic(logic.get());
     m_logicElms.append(logic);
 }
 
+QVector<LogicElement *> ElementMapping::inputLogics(GraphicElement *elm)
+{
+    if (elm->elementType() != ElementType::IC) {
+        return {elm->logic()};
+    }
+
+    auto *ic = qobject_cast<IC *>(elm);
+    QVector<LogicElement *> logics;
+
+    for (auto *inputPort : elm->inputs()) {
+        logics.append(ic->inputLogic(inputPort->index()));
+    }
+
+    return logics;
+}
+
 void ElementMapping::connectElements()
 {
     for (auto *elm : qAsConst(m_elements)) {
@@ -75,7 +155,15 @@ void ElementMapping::applyConnection(GraphicElement *elm, QNEInputPort *inputPor
     }
 
     if (connections.size() == 1) {
-        if (auto *outputPort = connections.constFirst()->startPort()) {
+        auto *outputPort = connections.constFirst()->startPort();
+
+        // A bus connected to a port of another width, which only an old or edited file can hold, is left open.
+        if (outputPort && (outputPort->width() != inputPort->width())) {
+            qCDebug(zero) << tr("Connection between ports of different widths is ignored.");
+            outputPort = nullptr;
+        }
+
+        if (outputPort) {
             if (auto *predecessorElement = outputPort->graphicElement()) {
                 if (predecessorElement->elementType() == ElementType::IC) {
                     auto *predecessorLogic = qobject_cast<IC *>(predecessorElement)->outputLogic(outputPort->index());
@@ -90,26 +178,159 @@ void ElementMapping::applyConnection(GraphicElement *elm, QNEInputPort *inputPor
 
 void ElementMapping::sort()
 {
-    sortLogicElements();
-    validateElements();
+    Netlist::levelize(m_logicElms);
+
+    // The scene shows every port and may run in timed mode, so only the passes that keep both are applied.
+    qCDebug(three) << tr("Compiling netlist.");
+    m_netlist = std::make_unique<Netlist>(m_logicElms, Netlist::SafeOptimizations);
 }
 
-void ElementMapping::sortLogicElements()
+bool ElementMapping::update(const NetlistDelta &delta, const QVector<GraphicElement *> &elements)
 {
-    for (auto logic : qAsConst(m_logicElms)) {
-        logic->calculatePriority();
+    // Removed logic elements and IC mappings, including the global GND and VCC of the latter, are kept alive
+    // until the new netlist took over the state of the old one.
+    QVector<LogicElement *> dirty;
+    QSet<LogicElement *> removed;
+    QVector<std::shared_ptr<ElementMapping>> removedMappings;
+
+    for (auto *elm : delta.removed) {
+        if (!m_mappedElements.contains(elm)) {
+            return false;
+        }
+
+        unmapElement(elm, dirty, removed, removedMappings);
+    }
+
+    QVector<GraphicElement *> generated;
+    QSet<GraphicElement *> isGenerated;
+
+    for (auto *elm : delta.added) {
+        if (!isGenerated.contains(elm)) {
+            isGenerated.insert(elm);
+            generated.append(elm);
+        }
+    }
+
+    for (auto *elm : delta.rewired) {
+        if (!m_mappedElements.contains(elm)) {
+            return false;
+        }
+
+        if (!isGenerated.contains(elm) && isStale(elm)) {
+            isGenerated.insert(elm);
+            generated.append(elm);
+        }
+    }
+
+    qCDebug(three) << tr("Generating logic of %1 elements.").arg(generated.size());
+
+    auto rewired = delta.rewired;
+
+    for (auto *elm : qAsConst(generated)) {
+        if (m_mappedElements.contains(elm)) {
+            unmapElement(elm, dirty, removed, removedMappings);
+        }
+
+        mapElement(elm);
+        rewired.append(elm);
+
+        // The elements driven by a new logic element are connected to it again.
+        for (auto *outputPort : elm->outputs()) {
+            for (auto *connection : outputPort->connections()) {
+                if (auto *inputPort = connection->endPort(); inputPort && inputPort->graphicElement()) {
+                    rewired.append(inputPort->graphicElement());
+                }
+            }
+        }
     }
 
-    std::sort(m_logicElms.begin(), m_logicElms.end(), [](const auto &logic1, const auto &logic2) {
-        return *logic1 > *logic2;
+    const auto removedBegin = std::stable_partition(m_logicElms.begin(), m_logicElms.end(), [&removed](const auto &logic) {
+        return !removed.contains(logic.get());
     });
+
+    const QVector<std::shared_ptr<LogicElement>> retired(removedBegin, m_logicElms.end());
+    m_logicElms.erase(removedBegin, m_logicElms.end());
+
+    if (m_mappedElements.size() != elements.size()) {
+        return false;
+    }
+
+    for (auto *elm : elements) {
+        if (!m_mappedElements.contains(elm)) {
+            return false;
+        }
+    }
+
+    // The arena does not reuse the memory of retired logic, so once it holds more of that than of live logic a new
+    // mapping, with an arena of its own, is cheaper to keep around.
+    m_retiredCount += retired.size();
+
+    if (m_retiredCount > m_logicElms.size()) {
+        return false;
+    }
+
+    std::sort(rewired.begin(), rewired.end());
+    rewired.erase(std::unique(rewired.begin(), rewired.end()), rewired.end());
+
+    // Both the old and the new predecessors of a rewired element have a different fan-out.
+    for (auto *elm : qAsConst(rewired)) {
+        for (auto *logic : inputLogics(elm)) {
+            for (const auto &inputPair : logic->inputPairs()) {
+                dirty.append(inputPair.logic);
+            }
+
+            logic->clearPredecessors();
+        }
+    }
+
+    for (auto *elm : qAsConst(rewired)) {
+        for (auto *inputPort : elm->inputs()) {
+            applyConnection(elm, inputPort);
+        }
+
+        for (auto *logic : inputLogics(elm)) {
+            for (const auto &inputPair : logic->inputPairs()) {
+                dirty.append(inputPair.logic);
+            }
+        }
+    }
+
+    m_elements = elements;
+
+    // A priority depends only on the fan-out, so it changes for the elements whose fan-out changed and for
+    // everything upstream of them.
+    QSet<LogicElement *> visited;
+
+    while (!dirty.isEmpty()) {
+        auto *logic = dirty.takeLast();
+
+        if (!logic || visited.contains(logic)) {
+            continue;
+        }
+
+        visited.insert(logic);
+        logic->clearPriority();
+
+        for (const auto &inputPair : logic->inputPairs()) {
+            dirty.append(inputPair.logic);
+        }
+    }
+
+    qCDebug(three) << tr("Levelizing again %1 of %2 logic elements.").arg(visited.size()).arg(m_logicElms.size());
+
+    const auto previous = std::move(m_netlist);
+    sort();
+
+    if (previous) {
+        m_netlist->takeState(*previous);
+    }
+
+    return true;
 }
 
-void ElementMapping::validateElements()
+Netlist *ElementMapping::netlist() const
 {
-    for (auto logic : qAsConst(m_logicElms)) {
-        logic->validate();
-    }
+    return m_netlist.get();
 }
 
 const QVector<std::shared_ptr<LogicElement>> &ElementMapping::logicElms() const
@@ -6,6 +6,9 @@
 #include "logicinput.h"
 
 #include <QCoreApplication>
+#include <QHash>
+#include <QSet>
+#include <QVector>
 #include <memory>
 
 class Clock;
@@ -13,33 +16,78 @@ class GraphicElement;
 class GraphicElementInput;
 class IC;
 class ICMapping;
+class LogicArena;
+class Netlist;
 class QNEInputPort;
 class QNEPort;
 
+//! Elements touched by an edit of the scene, used to patch an ElementMapping instead of building it again.
+struct NetlistDelta {
+    //! Elements added to the scene, or whose logic must be generated again.
+    QList<GraphicElement *> added;
+    //! Elements removed from the scene. They may be deleted already, so they are only used as keys.
+    QList<GraphicElement *> removed;
+    //! Elements whose input connections changed.
+    QList<GraphicElement *> rewired;
+};
+
 class ElementMapping
 {
     Q_DECLARE_TR_FUNCTIONS(ElementMapping)
 
 public:
-    explicit ElementMapping(const QVector<GraphicElement *> &elements);
+    //! Maps @p elements, allocating their logic in @p arena. The mappings of ICs share the arena of their parent.
+    explicit ElementMapping(const QVector<GraphicElement *> &elements, const std::shared_ptr<LogicArena> &arena);
     ~ElementMapping();
 
+    Netlist *netlist() const;
     const QVector<std::shared_ptr<LogicElement> > &logicElms() const;
+
+    //! Sorts the logic elements in levelized order and compiles them into a Netlist.
     void sort();
 
+    /**
+     * @brief Applies an edit of the scene to the mapping and compiles the netlist again.
+     *
+     * Only the logic of the added elements (and of the ones whose ports or IC file changed) is generated, only the
+     * inputs of the touched elements are connected again and only the priorities upstream of the rewired edges
+     * are computed again. Logic elements that are kept hold on to their values and state.
+     * Returns false if the delta does not lead to @p elements, the elements now on the scene, or if more logic
+     * has been retired than is still in use; the mapping must then be built again from scratch.
+     */
+    bool update(const NetlistDelta &delta, const QVector<GraphicElement *> &elements);
+
 private:
     Q_DISABLE_COPY(ElementMapping)
 
+    //! Logic generated for an element, with the port counts, bus width and delay it was generated for.
+    struct MappedElement {
+        std::shared_ptr<ElementMapping> icMapping;
+        LogicElement *logic = nullptr;
+        int busWidth = 1;
+        int delay = -1;
+        int inputSize = 0;
+        int outputSize = 0;
+    };
+
+    //! Logic elements that the input ports of @p elm are connected to.
+    static QVector<LogicElement *> inputLogics(GraphicElement *elm);
+
+    bool isStale(GraphicElement *elm) const;
     void applyConnection(GraphicElement *elm, QNEInputPort *inputPort);
     void connectElements();
     void generateLogic(GraphicElement *elm);
     void generateMap();
+    void mapElement(GraphicElement *elm);
     void setDefaultValue(GraphicElement *elm, QNEPort *in);
-    void sortLogicElements();
-    void validateElements();
+    void unmapElement(GraphicElement *elm, QVector<LogicElement *> &dirty, QSet<LogicElement *> &removed, QVector<std::shared_ptr<ElementMapping>> &removedMappings);
 
+    std::shared_ptr<LogicArena> m_arena;
     LogicInput m_globalGND{false};
     LogicInput m_globalVCC{true};
+    QHash<GraphicElement *, MappedElement> m_mappedElements;
     QVector<GraphicElement *> m_elements;
     QVector<std::shared_ptr<LogicElement>> m_logicElms;
+    qsizetype m_retiredCount = 0;
+    std::unique_ptr<Netlist> m_netlist;
 };
@@ -30,6 +30,7 @@ public:
         InputVcc = 12,
         JKFlipFlop = 18,
         JKLatch = 16,
+        Joiner = 31,
         Led = 3,
         Line = 29,
         Mux = 24,
@@ -40,6 +41,7 @@ public:
         Or = 6,
         RemoteDevice = 30,
         SRFlipFlop = 19,
+        Splitter = 32,
         TFlipFlop = 20,
         Text = 28,
         Unknown = 0,
@@ -0,0 +1,211 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "faultsimulator.h"
+
+#include "common.h"
+#include "netlist.h"
+#include "threadpool.h"
+
+#include <algorithm>
+
+FaultSimulator::FaultSimulator(const Netlist &netlist)
+    : m_netlist(netlist)
+{
+    if (netlist.m_hasCustom) {
+        throw Pandaception(tr("Fault simulation does not support custom elements."));
+    }
+
+    for (int element = 0; element < netlist.elementCount(); ++element) {
+        for (int slot = netlist.m_outputBegin[element]; slot < netlist.m_outputEnd[element]; ++slot) {
+            if (netlist.m_types[element] == LogicType::Input) {
+                m_inputSlots.append(slot);
+            } else if (netlist.m_types[element] == LogicType::Output) {
+                m_observedSlots.append(slot);
+            }
+        }
+    }
+}
+
+const QVector<int> &FaultSimulator::inputSlots() const
+{
+    return m_inputSlots;
+}
+
+void FaultSimulator::setInputSlots(const QVector<int> &inputs)
+{
+    m_inputSlots = inputs;
+}
+
+const QVector<int> &FaultSimulator::observedSlots() const
+{
+    return m_observedSlots;
+}
+
+void FaultSimulator::setObservedSlots(const QVector<int> &observed)
+{
+    m_observedSlots = observed;
+}
+
+QVector<FaultSimulator::Fault> FaultSimulator::faults() const
+{
+    QVector<Fault> faults;
+    faults.reserve(2 * m_netlist.slotCount());
+
+    for (int element = 0; element < m_netlist.elementCount(); ++element) {
+        // Elements that are not evaluated either have no slots of their own, as aliases, or drive no output.
+        if (m_netlist.m_types[element] == LogicType::None) {
+            continue;
+        }
+
+        const int begin = m_netlist.m_outputBegin[element];
+
+        for (int slot = begin; slot < m_netlist.m_outputEnd[element]; ++slot) {
+            faults.append({m_netlist.m_logic[element], element, slot - begin, slot, false});
+            faults.append({m_netlist.m_logic[element], element, slot - begin, slot, true});
+        }
+    }
+
+    return faults;
+}
+
+FaultSimulator::Report FaultSimulator::run(const QVector<QVector<bool>> &vectors) const
+{
+    return run(vectors, faults());
+}
+
+FaultSimulator::Report FaultSimulator::run(const QVector<QVector<bool>> &vectors, const QVector<Fault> &faults) const
+{
+    for (int vector = 0; vector < vectors.size(); ++vector) {
+        if (vectors.at(vector).size() != m_inputSlots.size()) {
+            throw Pandaception(tr("Vector %1 has %2 values, but there are %3 inputs.").arg(vector).arg(vectors.at(vector).size()).arg(m_inputSlots.size()));
+        }
+    }
+
+    // Every machine starts from the current state of the netlist.
+    const std::vector<quint64> lanes = m_netlist.lanes();
+    std::vector<quint64> state(3 * static_cast<size_t>(m_netlist.elementCount()));
+
+    for (int element = 0; element < m_netlist.elementCount(); ++element) {
+        const quint8 bits = m_netlist.m_state[element];
+        state[3 * element] = (bits & Netlist::LastClk) ? ~quint64(0) : 0;
+        state[3 * element + 1] = (bits & Netlist::LastValue) ? ~quint64(0) : 0;
+        state[3 * element + 2] = (bits & Netlist::LastK) ? ~quint64(0) : 0;
+    }
+
+    Report report;
+    report.faults = faults;
+    report.detectedBy.resize(faults.size());
+
+    const int batchCount = (faults.size() + faultsPerBatch - 1) / faultsPerBatch;
+    int *detectedBy = report.detectedBy.data();
+
+    ThreadPool::instance().run(batchCount, [&](const int batch) {
+        const int first = batch * faultsPerBatch;
+        runBatch(vectors, lanes, state, faults.constData() + first, qMin(faultsPerBatch, faults.size() - first), detectedBy + first);
+    });
+
+    return report;
+}
+
+void FaultSimulator::runBatch(const QVector<QVector<bool>> &vectors, std::vector<quint64> lanes, std::vector<quint64> state, const Fault *first, const int count, int *detectedBy) const
+{
+    const int elementCount = m_netlist.elementCount();
+
+    // Lanes forced by a fault in each slot, and the values they are forced to. Lane 0 is the fault-free machine.
+    std::vector<quint64> forceMask(lanes.size(), 0);
+    std::vector<quint64> forceValue(lanes.size(), 0);
+    std::vector<quint8> forced(elementCount, 0);
+    quint64 active = 0;
+
+    for (int index = 0; index < count; ++index) {
+        const Fault &fault = first[index];
+        const quint64 lane = quint64(1) << (index + 1);
+
+        forceMask[fault.slot] |= lane;
+        forceValue[fault.slot] |= fault.stuckAt ? lane : 0;
+        forced[fault.element] = 1;
+        active |= lane;
+        detectedBy[index] = -1;
+    }
+
+    const auto sweep = [&] {
+        for (int element = 0; element < elementCount; ++element) {
+            m_netlist.evaluateLanes(element, lanes, state);
+
+            if (forced[element]) {
+                for (int slot = m_netlist.m_outputBegin[element]; slot < m_netlist.m_outputEnd[element]; ++slot) {
+                    lanes[slot] = (lanes[slot] & ~forceMask[slot]) | forceValue[slot];
+                }
+            }
+        }
+    };
+
+    std::vector<quint64> previous;
+    quint64 detected = 0;
+
+    for (int vector = 0; (vector < vectors.size()) && (detected != active); ++vector) {
+        const auto &values = vectors.at(vector);
+
+        for (int index = 0; index < m_inputSlots.size(); ++index) {
+            lanes[m_inputSlots.at(index)] = values.at(index) ? ~quint64(0) : 0;
+        }
+
+        if (m_netlist.isCombinational()) {
+            sweep();
+        } else {
+            // Once a sweep changes nothing, the memory elements have seen their inputs as they are, so the next one
+            // would not change anything either.
+            for (int pass = 0; pass < maxSettlePasses; ++pass) {
+                previous = lanes;
+                sweep();
+
+                if (lanes == previous) {
+                    break;
+                }
+            }
+        }
+
+        quint64 difference = 0;
+
+        for (const int slot : m_observedSlots) {
+            difference |= lanes[slot] ^ (~quint64(0) * (lanes[slot] & 1));
+        }
+
+        quint64 newlyDetected = difference & active & ~detected;
+        detected |= newlyDetected;
+
+        while (newlyDetected != 0) {
+            detectedBy[qCountTrailingZeroBits(newlyDetected) - 1] = vector;
+            newlyDetected &= newlyDetected - 1;
+        }
+    }
+}
+
+int FaultSimulator::Report::detectedCount() const
+{
+    return static_cast<int>(std::count_if(detectedBy.cbegin(), detectedBy.cend(), [](const int vector) { return vector >= 0; }));
+}
+
+double FaultSimulator::Report::coverage() const
+{
+    return faults.isEmpty() ? 100.0 : 100.0 * detectedCount() / faults.size();
+}
+
+QVector<FaultSimulator::Fault> FaultSimulator::Report::undetected() const
+{
+    QVector<Fault> undetected;
+
+    for (int index = 0; index < faults.size(); ++index) {
+        if (detectedBy.at(index) < 0) {
+            undetected.append(faults.at(index));
+        }
+    }
+
+    return undetected;
+}
+
+QString FaultSimulator::Report::summary() const
+{
+    return tr("%1 of %2 faults detected (%3%)").arg(detectedCount()).arg(faults.size()).arg(coverage(), 0, 'f', 1);
+}
@@ -0,0 +1,83 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QVector>
+
+#include <vector>
+
+class LogicElement;
+class Netlist;
+
+/**
+ * @brief Grades input vectors by the stuck-at faults they detect on the outputs of the elements of a Netlist.
+ *
+ * Each word of the simulation holds 64 machines: the fault-free one in bit 0 and one faulty machine per other
+ * bit, each with a single output slot forced to 0 or 1. Vectors are applied in order, each one settling the
+ * machines in levelized sweeps, so memory elements carry their state from a vector to the next. A fault is
+ * detected by the first vector after which one of the observed slots of its machine differs from the fault-free
+ * one. Batches of faults are spread over the ThreadPool; the netlist itself is not changed.
+ */
+class FaultSimulator
+{
+    Q_DECLARE_TR_FUNCTIONS(FaultSimulator)
+
+public:
+    //! An output slot of an element stuck at a value.
+    struct Fault {
+        const LogicElement *logic = nullptr;
+        int element = 0;
+        int port = 0;
+        int slot = 0;
+        bool stuckAt = false;
+    };
+
+    struct Report {
+        QVector<Fault> faults;
+        //! Index of the first vector that detects each fault, or -1 for the faults no vector detects.
+        QVector<int> detectedBy;
+
+        int detectedCount() const;
+        //! Percentage of the faults detected, 100 for a netlist without faults.
+        double coverage() const;
+        QVector<Fault> undetected() const;
+        QString summary() const;
+    };
+
+    //! Simulates @p netlist, from its state when run() is called. Throws if it has custom elements, which have no form that
+    //! runs on lanes.
+    explicit FaultSimulator(const Netlist &netlist);
+
+    //! Slots set by each vector, in order. The output slots of every input element by default.
+    const QVector<int> &inputSlots() const;
+    void setInputSlots(const QVector<int> &inputs);
+
+    //! Slots compared against the fault-free machine. The output slots of every output element by default.
+    const QVector<int> &observedSlots() const;
+    void setObservedSlots(const QVector<int> &observed);
+
+    //! Stuck-at-0 and stuck-at-1 on every output slot of every evaluated element.
+    QVector<Fault> faults() const;
+
+    //! Simulates @p faults, every fault by default, over @p vectors, which hold a value per input slot each.
+    Report run(const QVector<QVector<bool>> &vectors) const;
+    Report run(const QVector<QVector<bool>> &vectors, const QVector<Fault> &faults) const;
+
+private:
+    Q_DISABLE_COPY(FaultSimulator)
+
+    //! Machines besides the fault-free one in each word.
+    static constexpr int faultsPerBatch = 63;
+    //! Sweeps a vector may take to settle. Machines still changing after them oscillate, and are compared as they are.
+    static constexpr int maxSettlePasses = 64;
+
+    //! Simulates @p count faults from @p first, starting from @p lanes and @p state, and writes the vector that
+    //! detects each one to @p detectedBy.
+    void runBatch(const QVector<QVector<bool>> &vectors, std::vector<quint64> lanes, std::vector<quint64> state, const Fault *first, const int count, int *detectedBy) const;
+
+    const Netlist &m_netlist;
+    QVector<int> m_inputSlots;
+    QVector<int> m_observedSlots;
+};
@@ -17,6 +17,7 @@
 #include <QPainter>
 #include <QPixmap>
 #include <QStyleOptionGraphicsItem>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -156,6 +157,8 @@ void GraphicElement::save(QDataStream &stream) const
     map.insert("maxOutputSize", m_maxOutputSize);
     map.insert("trigger", m_trigger);
     map.insert("priority", m_priority);
+    map.insert("busWidth", m_busWidth);
+    map.insert("delay", m_delay);
 
     stream << map;
 
@@ -297,6 +300,14 @@ void GraphicElement::loadNewFormat(QDataStream &stream, QMap<quint64, QNEPort *>
         setPriority(map.value("priority").toULongLong());
     }
 
+    if (map.contains("busWidth")) {
+        setBusWidth(map.value("busWidth").toInt());
+    }
+
+    if (map.contains("delay")) {
+        setDelay(map.value("delay").toInt());
+    }
+
     // -------------------------------------------
 
     QList<QMap<QString, QVariant>> inputMap; stream >> inputMap;
@@ -824,6 +835,42 @@ bool GraphicElement::hasAudio() const
     return m_hasAudio;
 }
 
+bool GraphicElement::hasBusWidth() const
+{
+    return m_hasBusWidth;
+}
+
+void GraphicElement::setHasBusWidth(const bool hasBusWidth)
+{
+    m_hasBusWidth = hasBusWidth;
+}
+
+int GraphicElement::busWidth() const
+{
+    return m_busWidth;
+}
+
+void GraphicElement::setBusWidth(const int busWidth)
+{
+    if (!m_hasBusWidth) {
+        return;
+    }
+
+    m_busWidth = std::clamp(busWidth, 1, maxBusWidth);
+
+    for (auto *port : qAsConst(m_inputPorts)) {
+        port->updateConnections();
+    }
+
+    update();
+}
+
+int GraphicElement::portWidth(const QNEPort *port) const
+{
+    Q_UNUSED(port)
+    return m_busWidth;
+}
+
 void GraphicElement::setHasAudio(const bool hasAudio)
 {
     m_hasAudio = hasAudio;
@@ -1033,6 +1080,16 @@ int GraphicElement::priority() const
     return m_priority;
 }
 
+int GraphicElement::delay() const
+{
+    return m_delay;
+}
+
+void GraphicElement::setDelay(const int delay)
+{
+    m_delay = std::max(delay, -1);
+}
+
 void GraphicElement::setOutputSize(const int size)
 {
     if ((size >= minOutputSize()) && (size <= maxOutputSize())) {
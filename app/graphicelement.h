@@ -10,6 +10,7 @@
 #include <QGraphicsItem>
 #include <QKeySequence>
 #include <QPixmapCache>
+#include <QVector>
 #include <QVersionNumber>
 #include <memory>
 
@@ -70,6 +71,7 @@ public:
     QString label() const;
     bool canChangeSkin() const;
     bool hasAudio() const;
+    bool hasBusWidth() const;
     bool hasColors() const;
     bool hasFrequency() const;
     bool hasLabel() const;
@@ -79,6 +81,10 @@ public:
     bool isValid();
     const QVector<QNEInputPort *> &inputs() const;
     const QVector<QNEOutputPort *> &outputs() const;
+    //! Number of bits carried by the ports of the element, 1 unless it has a bus width.
+    int busWidth() const;
+    //! Propagation delay in timed simulation, or -1 for the default of the element type.
+    int delay() const;
     int inputSize() const;
     int maxInputSize() const;
     int maxOutputSize() const;
@@ -90,9 +96,13 @@ public:
     virtual QString audio() const;
     virtual QString color() const;
     virtual QString genericProperties();
+    //! Number of bits carried by @p port. Elements that mix buses and single wires override it.
+    virtual int portWidth(const QNEPort *port) const;
     virtual void refresh();
     virtual void setAudio(const QString &audio);
+    void setBusWidth(const int busWidth);
     virtual void setColor(const QString &color);
+    void setDelay(const int delay);
     virtual void setFrequency(const float freq);
     virtual void setSkin(const bool defaultSkin, const QString &fileName);
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
@@ -119,6 +129,7 @@ protected:
     bool sceneEvent(QEvent *event) override;
     void setCanChangeSkin(const bool canChangeSkin);
     void setHasAudio(const bool hasAudio);
+    void setHasBusWidth(const bool hasBusWidth);
     void setHasColors(const bool hasColors);
     void setHasFrequency(const bool hasFrequency);
     void setHasLabel(const bool hasLabel);
@@ -192,6 +203,7 @@ private:
     QString m_labelText;
     bool m_canChangeSkin = false;
     bool m_hasAudio = false;
+    bool m_hasBusWidth = false;
     bool m_hasColors = false;
     bool m_hasFrequency = false;
     bool m_hasLabel = false;
@@ -199,6 +211,8 @@ private:
     bool m_rotatable = true;
     bool m_selected = false;
     bool m_customPixmap = false;
+    int m_busWidth = 1;
+    int m_delay = -1;
     qreal m_angle = 0;
     quint64 m_maxInputSize = 0;
     quint64 m_maxOutputSize = 0;
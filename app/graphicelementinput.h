@@ -22,15 +22,27 @@ public:
     virtual void setOn() = 0;
     virtual void setOn(const bool value, const int port = 0) = 0;
     void setLocked(const bool locked) { m_locked = locked; }
-    void updateOutputs();
+
+    //! Copies the input state to its logic element and returns true if any output has changed.
+    bool updateOutputs();
 
 protected:
     bool m_locked = false;
 };
 
-inline void GraphicElementInput::updateOutputs()
+inline bool GraphicElementInput::updateOutputs()
 {
+    auto *logic_ = logic();
+    bool changed = false;
+
     for (int portIndex = 0; portIndex < outputSize(); ++portIndex) {
-        logic()->setOutputValue(portIndex, isOn(portIndex));
+        const bool value = isOn(portIndex);
+
+        if (logic_->outputValue(portIndex) != value) {
+            logic_->setOutputValue(portIndex, value);
+            changed = true;
+        }
     }
+
+    return changed;
 }
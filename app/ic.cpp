@@ -389,9 +389,14 @@ void IC::loadOutputsLabels()
     }
 }
 
-ElementMapping *IC::generateMap() const
+std::unique_ptr<ElementMapping> IC::generateMap(const std::shared_ptr<LogicArena> &arena) const
 {
-    return new ElementMapping(m_icElements);
+    return std::make_unique<ElementMapping>(m_icElements, arena);
+}
+
+bool IC::isMapped() const
+{
+    return std::all_of(m_icElements.cbegin(), m_icElements.cend(), [](const auto *elm) { return elm->logic() != nullptr; });
 }
 
 void IC::refresh()
@@ -24,7 +24,10 @@ public:
 
     static void copyFiles(const QFileInfo &srcFile);
 
-    ElementMapping *generateMap() const;
+    //! Flattens the elements of the IC into a mapping of their own, which owns their global GND and VCC.
+    std::unique_ptr<ElementMapping> generateMap(const std::shared_ptr<LogicArena> &arena) const;
+    //! Whether the logic of the elements of the IC was generated since its file was last loaded.
+    bool isMapped() const;
     LogicElement *inputLogic(const int index);
     LogicElement *outputLogic(const int index);
     void load(QDataStream &stream, QMap<quint64, QNEPort *> &portMap, const QVersionNumber version) override;
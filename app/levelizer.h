@@ -0,0 +1,204 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QVector>
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Iterative levelization of a graph of elements with feedback loops.
+ *
+ * Strongly connected components are found with Tarjan's algorithm on an explicit stack, so long chains of
+ * elements cannot overflow the call stack. Every element gets the priority of its component: one more than the
+ * highest priority among the components it drives, so sinks get 1 and every edge goes to a lower priority,
+ * except the edges inside a feedback loop. Elements of a loop share its priority and its component.
+ */
+template<typename Node>
+class Levelizer
+{
+public:
+    /**
+     * @brief Levelizes @p nodes and the nodes they reach.
+     *
+     * @p successors returns the successors of a node. @p knownPriority returns the priority of a node that was
+     * already levelized, or -1; those nodes are not visited again, which is valid as long as every node upstream
+     * of a changed edge is levelized again.
+     */
+    template<typename Successors, typename KnownPriority>
+    Levelizer(const QVector<Node> &nodes, Successors successors, KnownPriority knownPriority);
+
+    //! Priority of a levelized node.
+    int priority(const Node &node) const;
+
+    //! Node that identifies the feedback loop of a levelized node, or a null node if it is not part of one.
+    Node component(const Node &node) const;
+
+private:
+    int add(const Node &node);
+    void findComponents();
+
+    QHash<Node, int> m_indices;
+    QVector<Node> m_nodes;
+    std::vector<int> m_component;
+    std::vector<int> m_edgeBegin;
+    std::vector<int> m_edges;
+    std::vector<int> m_knownPriority;
+    std::vector<int> m_priority;
+};
+
+template<typename Node>
+template<typename Successors, typename KnownPriority>
+Levelizer<Node>::Levelizer(const QVector<Node> &nodes, Successors successors, KnownPriority knownPriority)
+{
+    for (const auto &node : nodes) {
+        if (knownPriority(node) < 0) {
+            add(node);
+        }
+    }
+
+    // Nodes reached for the first time are appended, so this also numbers the nodes outside of the list.
+    for (int index = 0; index < m_nodes.size(); ++index) {
+        m_edgeBegin.push_back(static_cast<int>(m_edges.size()));
+        int known = 0;
+
+        for (const auto &successor : successors(m_nodes.at(index))) {
+            if (const int priority = knownPriority(successor); priority >= 0) {
+                known = std::max(known, priority);
+                continue;
+            }
+
+            m_edges.push_back(add(successor));
+        }
+
+        m_knownPriority.push_back(known);
+    }
+
+    m_edgeBegin.push_back(static_cast<int>(m_edges.size()));
+
+    findComponents();
+}
+
+template<typename Node>
+int Levelizer<Node>::add(const Node &node)
+{
+    if (const int index = m_indices.value(node, -1); index != -1) {
+        return index;
+    }
+
+    m_indices.insert(node, m_nodes.size());
+    m_nodes.append(node);
+    return m_nodes.size() - 1;
+}
+
+template<typename Node>
+void Levelizer<Node>::findComponents()
+{
+    const int count = m_nodes.size();
+
+    std::vector<int> order(count, -1);
+    std::vector<int> lowLink(count, 0);
+    std::vector<int> componentOf(count, -1);
+    std::vector<int> members;
+    std::vector<std::pair<int, int>> callStack;
+    int visited = 0;
+    int componentCount = 0;
+
+    m_component.assign(count, -1);
+    m_priority.assign(count, 0);
+
+    const auto visit = [&](const int node) {
+        order[node] = lowLink[node] = visited++;
+        members.push_back(node);
+        callStack.emplace_back(node, m_edgeBegin[node]);
+    };
+
+    for (int root = 0; root < count; ++root) {
+        if (order[root] != -1) {
+            continue;
+        }
+
+        visit(root);
+
+        while (!callStack.empty()) {
+            const int node = callStack.back().first;
+            int &edge = callStack.back().second;
+
+            if (edge < m_edgeBegin[node + 1]) {
+                const int successor = m_edges[edge++];
+
+                if (order[successor] == -1) {
+                    visit(successor);
+                } else if (componentOf[successor] == -1) {
+                    lowLink[node] = std::min(lowLink[node], order[successor]);
+                }
+
+                continue;
+            }
+
+            callStack.pop_back();
+
+            if (!callStack.empty()) {
+                const int parent = callStack.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+
+            if (lowLink[node] != order[node]) {
+                continue;
+            }
+
+            // Components are completed downstream first, so every component this one drives has its priority.
+            // The node that completes a component is its first member on the stack.
+            auto first = members.cend();
+
+            do {
+                --first;
+            } while (*first != node);
+
+            const int component = componentCount++;
+            bool loop = (members.cend() - first) > 1;
+            int priority = 0;
+
+            for (auto member = first; member != members.cend(); ++member) {
+                componentOf[*member] = component;
+            }
+
+            for (auto member = first; member != members.cend(); ++member) {
+                priority = std::max(priority, m_knownPriority[*member]);
+
+                for (int index = m_edgeBegin[*member]; index < m_edgeBegin[*member + 1]; ++index) {
+                    const int successor = m_edges[index];
+
+                    if (componentOf[successor] == component) {
+                        loop = true;
+                    } else {
+                        priority = std::max(priority, m_priority[successor]);
+                    }
+                }
+            }
+
+            for (auto member = first; member != members.cend(); ++member) {
+                m_priority[*member] = priority + 1;
+                m_component[*member] = loop ? node : -1;
+            }
+
+            members.erase(first, members.cend());
+        }
+    }
+}
+
+template<typename Node>
+int Levelizer<Node>::priority(const Node &node) const
+{
+    return m_priority.at(m_indices.value(node));
+}
+
+template<typename Node>
+Node Levelizer<Node>::component(const Node &node) const
+{
+    const int component = m_component.at(m_indices.value(node));
+    return (component == -1) ? Node() : m_nodes.at(component);
+}
@@ -0,0 +1,42 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logicarena.h"
+
+#include <algorithm>
+
+namespace
+{
+    //! Large enough for about a thousand gates, so a big circuit takes only a few hundred blocks.
+    const size_t blockSize = 64 * 1024;
+}
+
+std::shared_ptr<LogicArena> LogicArena::create()
+{
+    return std::shared_ptr<LogicArena>(new LogicArena());
+}
+
+LogicArena::~LogicArena()
+{
+    // Destroyed in reverse order of construction, like the members of a class.
+    for (auto destructor = m_destructors.crbegin(); destructor != m_destructors.crend(); ++destructor) {
+        destructor->destroy(destructor->object);
+    }
+}
+
+void *LogicArena::allocate(const size_t size, const size_t alignment)
+{
+    void *pointer = m_current;
+    size_t space = m_available;
+
+    if (!std::align(alignment, size, pointer, space)) {
+        space = std::max(size + alignment, blockSize);
+        m_blocks.emplace_back(new char[space]);
+        pointer = m_blocks.back().get();
+        std::align(alignment, size, pointer, space);
+    }
+
+    m_current = static_cast<char *>(pointer) + size;
+    m_available = space - size;
+    return pointer;
+}
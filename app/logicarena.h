@@ -0,0 +1,60 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Memory of the logic elements of a simulation layer.
+ *
+ * Elements are carved out of large blocks, and the shared pointers handed out share the ownership of the whole
+ * arena instead of having a control block each. Building a layer of any size costs a handful of allocations, and
+ * the last pointer to go away frees all of them at once. The memory of an element is not reused before that, so
+ * ElementMapping::update() gives up on a mapping, and the arena with it, once most of that memory is retired.
+ */
+class LogicArena : public std::enable_shared_from_this<LogicArena>
+{
+public:
+    static std::shared_ptr<LogicArena> create();
+    ~LogicArena();
+
+    //! Constructs a @p T in the arena.
+    template<typename T, typename... Args>
+    std::shared_ptr<T> make(Args &&...args);
+
+private:
+    Q_DISABLE_COPY(LogicArena)
+
+    struct Destructor {
+        void *object;
+        void (*destroy)(void *);
+    };
+
+    LogicArena() = default;
+
+    void *allocate(const size_t size, const size_t alignment);
+
+    std::vector<Destructor> m_destructors;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char *m_current = nullptr;
+    size_t m_available = 0;
+};
+
+template<typename T, typename... Args>
+std::shared_ptr<T> LogicArena::make(Args &&...args)
+{
+    auto *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        m_destructors.push_back({object, [](void *pointer) { static_cast<T *>(pointer)->~T(); }});
+    }
+
+    return std::shared_ptr<T>(shared_from_this(), object);
+}
@@ -3,11 +3,16 @@
 
 #include "logicelement.h"
 
+#include <algorithm>
+#include <functional>
+
 LogicElement::LogicElement(const int inputSize, const int outputSize)
-    : m_inputValues(inputSize, false)
-    , m_inputPairs(inputSize, {})
-    , m_outputValues(outputSize, false)
+    : m_inputValues(inputSize)
+    , m_inputPairs(inputSize)
+    , m_outputValues(outputSize)
 {
+    std::fill(m_inputValues.begin(), m_inputValues.end(), false);
+    std::fill(m_outputValues.begin(), m_outputValues.end(), false);
 }
 
 bool LogicElement::isValid() const
@@ -15,6 +20,24 @@ bool LogicElement::isValid() const
     return m_isValid;
 }
 
+void LogicElement::clearPredecessors()
+{
+    for (auto &inputPair : m_inputPairs) {
+        if (inputPair.logic) {
+            auto &successors = inputPair.logic->m_successors;
+            successors.erase(std::remove(successors.begin(), successors.end(), this), successors.end());
+        }
+
+        inputPair = {};
+    }
+}
+
+void LogicElement::clearPriority()
+{
+    m_priority = -1;
+    m_component = nullptr;
+}
+
 void LogicElement::clearSucessors()
 {
     for (const auto &logic : qAsConst(m_successors)) {
@@ -35,22 +58,59 @@ bool LogicElement::updateInputs()
         return false;
     }
 
+    int bit = 0;
+
     for (int index = 0; index < m_inputPairs.size(); ++index) {
-        m_inputValues[index] = inputValue(index);
+        const auto &inputPair = m_inputPairs.at(index);
+
+        for (int offset = 0; offset < inputWidth(index); ++offset) {
+            m_inputValues[bit++] = inputPair.logic->outputValue(inputPair.port + offset);
+        }
     }
 
     return true;
 }
 
+int LogicElement::inputWidth(const int index) const
+{
+    Q_UNUSED(index)
+    return 1;
+}
+
+quint64 LogicElement::inputWord(const int bit, const int width) const
+{
+    quint64 word = 0;
+
+    for (int offset = 0; offset < width; ++offset) {
+        word |= static_cast<quint64>(m_inputValues.at(bit + offset)) << offset;
+    }
+
+    return word;
+}
+
+void LogicElement::setOutputWord(const quint64 word)
+{
+    for (int index = 0; index < m_outputValues.size(); ++index) {
+        setOutputValue(index, (word >> index) & 1);
+    }
+}
+
 void LogicElement::connectPredecessor(const int index, LogicElement *logic, const int port)
 {
     m_inputPairs[index] = {logic, port};
-    logic->m_successors.insert(this);
+
+    // The inputs of an element are connected one after the other, so a repeated successor is always the last one.
+    if (logic->m_successors.isEmpty() || (logic->m_successors.last() != this)) {
+        logic->m_successors.append(this);
+    }
 }
 
 void LogicElement::setOutputValue(const int index, const bool value)
 {
-    m_outputValues[index] = value;
+    if (m_outputValues.at(index) != value) {
+        m_outputValues[index] = value;
+        m_outputChanged = true;
+    }
 }
 
 void LogicElement::setOutputValue(const bool value)
@@ -58,6 +118,59 @@ void LogicElement::setOutputValue(const bool value)
     setOutputValue(0, value);
 }
 
+bool LogicElement::evaluate()
+{
+    m_outputChanged = false;
+    updateLogic();
+    return m_outputChanged;
+}
+
+const QVarLengthArray<LogicElement *, 4> &LogicElement::successors() const
+{
+    return m_successors;
+}
+
+const QVarLengthArray<InputPair, 4> &LogicElement::inputPairs() const
+{
+    return m_inputPairs;
+}
+
+LogicElement *LogicElement::component() const
+{
+    return m_component;
+}
+
+int LogicElement::delay() const
+{
+    return m_delay;
+}
+
+void LogicElement::setDelay(const int delay)
+{
+    m_delay = delay;
+}
+
+int LogicElement::priority() const
+{
+    return m_priority;
+}
+
+void LogicElement::setPriority(const int priority, LogicElement *component)
+{
+    m_priority = priority;
+    m_component = component;
+}
+
+int LogicElement::sortIndex() const
+{
+    return m_sortIndex;
+}
+
+void LogicElement::setSortIndex(const int sortIndex)
+{
+    m_sortIndex = sortIndex;
+}
+
 void LogicElement::validate()
 {
     m_isValid = std::all_of(m_inputPairs.cbegin(), m_inputPairs.cend(),
@@ -72,30 +185,12 @@ void LogicElement::validate()
 
 bool LogicElement::operator>(const LogicElement &other) const
 {
-    return (m_priority > other.m_priority);
-}
-
-int LogicElement::calculatePriority()
-{
-    if (m_beingVisited) {
-        return 0;
-    }
-
-    if (m_priority != -1) {
-        return m_priority;
+    // The elements of a feedback loop are kept together, after the other elements of the same priority.
+    if (m_priority != other.m_priority) {
+        return (m_priority > other.m_priority);
     }
 
-    m_beingVisited = true;
-    int max = 0;
-
-    for (auto *logic : qAsConst(m_successors)) {
-        max = qMax(logic->calculatePriority(), max);
-    }
-
-    const int priority = max + 1;
-    m_priority = priority;
-    m_beingVisited = false;
-    return priority;
+    return std::less<>()(m_component, other.m_component);
 }
 
 bool LogicElement::outputValue(const int index) const
@@ -3,8 +3,7 @@
 
 #pragma once
 
-#include <QSet>
-#include <QVector>
+#include <QVarLengthArray>
 
 class LogicElement;
 
@@ -13,7 +12,17 @@ struct InputPair {
     int port = 0;
 };
 
-//! Represent logic elements in the simulation layer
+//! Kind of logic computed by an element, used to compile it into a Netlist
+enum class LogicType : quint8 {
+    And, BusAnd, BusMux, BusNot, BusOr, BusXor, Custom, DFlipFlop, DLatch, Demux, Input, JKFlipFlop, Joiner, Mux, Nand, Node, None, Nor, Not, Or,
+    Output, SRFlipFlop, Splitter, TFlipFlop, Xnor, Xor
+};
+
+//! Widest bus, so a bus always fits in a single word of a Netlist.
+constexpr int maxBusWidth = 64;
+
+//! Represent logic elements in the simulation layer. Ports and successors are stored inline up to a typical
+//! size, so building an element allocates nothing besides the element itself.
 class LogicElement
 {
 public:
@@ -24,28 +33,58 @@ public:
     bool inputValue(const int index = 0) const;
     bool isValid() const;
     bool outputValue(const int index = 0) const;
-    int calculatePriority();
+    const QVarLengthArray<LogicElement *, 4> &successors() const;
+    const QVarLengthArray<InputPair, 4> &inputPairs() const;
+    //! Element that identifies the feedback loop this element is part of, or nullptr outside of loops.
+    LogicElement *component() const;
+    //! Propagation delay of the element in timed simulation, or -1 for the default of its type.
+    int delay() const;
+    //! Priority given by Netlist::levelize(), or -1 if the element was not levelized yet.
+    int priority() const;
+    int sortIndex() const;
+    //! Number of bits read by an input port. A bus input reads consecutive outputs of its predecessor, starting at
+    //! the port of its InputPair.
+    virtual int inputWidth(const int index) const;
+    virtual LogicType type() const { return LogicType::Custom; }
     virtual void updateLogic() = 0;
+
+    //! Runs updateLogic() and returns true if any output value has changed.
+    bool evaluate();
+
+    //! Disconnects every input, removing this element from the successors of its predecessors.
+    void clearPredecessors();
+    //! Forgets the priority, so Netlist::levelize() computes it again after the fan-out changed.
+    void clearPriority();
     void clearSucessors();
     void connectPredecessor(const int index, LogicElement *logic, const int port);
+    void setDelay(const int delay);
     void setOutputValue(const bool value);
     void setOutputValue(const int index, const bool value);
+    void setPriority(const int priority, LogicElement *component);
+    void setSortIndex(const int sortIndex);
     void validate();
     size_t getInputAmount() { return m_inputPairs.size(); }
     size_t getOutputAmount() { return m_outputValues.size(); }
 
 protected:
+    //! Bits [@p bit, @p bit + @p width) of the input values, the first one in the lowest bit.
+    quint64 inputWord(const int bit, const int width) const;
     bool updateInputs();
+    //! Sets every output value from the bits of @p word.
+    void setOutputWord(const quint64 word);
 
-    QVector<bool> m_inputValues;
+    QVarLengthArray<bool, 8> m_inputValues;
 
 private:
     Q_DISABLE_COPY(LogicElement)
 
-    QSet<LogicElement *> m_successors;
-    QVector<InputPair> m_inputPairs;
-    QVector<bool> m_outputValues;
-    bool m_beingVisited = false;
+    QVarLengthArray<InputPair, 4> m_inputPairs;
+    QVarLengthArray<LogicElement *, 4> m_successors;
+    LogicElement *m_component = nullptr;
+    QVarLengthArray<bool, 8> m_outputValues;
     bool m_isValid = true;
+    bool m_outputChanged = false;
+    int m_delay = -1;
     int m_priority = -1;
+    int m_sortIndex = -1;
 };
@@ -4,6 +4,7 @@
 #include "logicand.h"
 
 #include <functional>
+#include <numeric>
 
 LogicAnd::LogicAnd(const int inputSize)
     : LogicElement(inputSize, 1)
@@ -10,6 +10,7 @@ class LogicAnd : public LogicElement
 public:
     explicit LogicAnd(const int inputSize);
 
+    LogicType type() const override { return LogicType::And; }
     void updateLogic() override;
 
 private:
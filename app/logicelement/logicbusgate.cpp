@@ -0,0 +1,43 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logicbusgate.h"
+
+#include <algorithm>
+
+LogicBusGate::LogicBusGate(const LogicType type, const int inputSize, const int width)
+    : LogicElement(inputSize, width)
+    , m_type(type)
+    , m_width(width)
+{
+    m_inputValues.resize(inputSize * width);
+    std::fill(m_inputValues.begin(), m_inputValues.end(), false);
+}
+
+int LogicBusGate::inputWidth(const int index) const
+{
+    Q_UNUSED(index)
+    return m_width;
+}
+
+void LogicBusGate::updateLogic()
+{
+    if (!updateInputs()) {
+        return;
+    }
+
+    quint64 result = inputWord(0, m_width);
+
+    for (int index = 1; index < inputPairs().size(); ++index) {
+        const quint64 word = inputWord(index * m_width, m_width);
+
+        switch (m_type) {
+        case LogicType::BusAnd: result &= word; break;
+        case LogicType::BusOr:  result |= word; break;
+        case LogicType::BusXor: result ^= word; break;
+        default:                                break;
+        }
+    }
+
+    setOutputWord((m_type == LogicType::BusNot) ? ~result : result);
+}
@@ -0,0 +1,24 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "logicelement.h"
+
+//! And, Or, Xor or Not applied bitwise to buses of the same width.
+class LogicBusGate : public LogicElement
+{
+public:
+    //! Gate of @p type (BusAnd, BusOr, BusXor or BusNot) over @p inputSize buses of @p width bits.
+    explicit LogicBusGate(const LogicType type, const int inputSize, const int width);
+
+    LogicType type() const override { return m_type; }
+    int inputWidth(const int index) const override;
+    void updateLogic() override;
+
+private:
+    Q_DISABLE_COPY(LogicBusGate)
+
+    const LogicType m_type;
+    const int m_width;
+};
@@ -0,0 +1,30 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logicbusmux.h"
+
+#include <algorithm>
+
+LogicBusMux::LogicBusMux(const int width)
+    : LogicElement(3, width)
+    , m_width(width)
+{
+    m_inputValues.resize(2 * width + 1);
+    std::fill(m_inputValues.begin(), m_inputValues.end(), false);
+}
+
+int LogicBusMux::inputWidth(const int index) const
+{
+    return (index == 2) ? 1 : m_width;
+}
+
+void LogicBusMux::updateLogic()
+{
+    if (!updateInputs()) {
+        return;
+    }
+
+    const bool choice = m_inputValues.at(2 * m_width);
+
+    setOutputWord(inputWord(choice ? m_width : 0, m_width));
+}
@@ -0,0 +1,22 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "logicelement.h"
+
+//! Multiplexer of two buses, selected by a single bit.
+class LogicBusMux : public LogicElement
+{
+public:
+    explicit LogicBusMux(const int width);
+
+    LogicType type() const override { return LogicType::BusMux; }
+    int inputWidth(const int index) const override;
+    void updateLogic() override;
+
+private:
+    Q_DISABLE_COPY(LogicBusMux)
+
+    const int m_width;
+};
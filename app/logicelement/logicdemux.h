@@ -10,6 +10,7 @@ class LogicDemux : public LogicElement
 public:
     explicit LogicDemux();
 
+    LogicType type() const override { return LogicType::Demux; }
     void updateLogic() override;
 
 private:
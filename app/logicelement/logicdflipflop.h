@@ -10,6 +10,7 @@ class LogicDFlipFlop : public LogicElement
 public:
     explicit LogicDFlipFlop();
 
+    LogicType type() const override { return LogicType::DFlipFlop; }
     void updateLogic() override;
 
 private:
@@ -10,6 +10,7 @@ class LogicDLatch : public LogicElement
 public:
     explicit LogicDLatch();
 
+    LogicType type() const override { return LogicType::DLatch; }
     void updateLogic() override;
 
 private:
@@ -1,10 +1,13 @@
 SOURCES += \
     $$PWD/logicand.cpp \
+    $$PWD/logicbusgate.cpp \
+    $$PWD/logicbusmux.cpp \
     $$PWD/logicdemux.cpp \
     $$PWD/logicdflipflop.cpp \
     $$PWD/logicdlatch.cpp \
     $$PWD/logicinput.cpp \
     $$PWD/logicjkflipflop.cpp \
+    $$PWD/logicjoiner.cpp \
     $$PWD/logicmux.cpp \
     $$PWD/logicnand.cpp \
     $$PWD/logicnode.cpp \
@@ -12,7 +15,7 @@ SOURCES += \
     $$PWD/logicnot.cpp \
     $$PWD/logicor.cpp \
     $$PWD/logicoutput.cpp \
-    $$PWD/logicremotedevice.cpp \
+    $$PWD/logicsplitter.cpp \
     $$PWD/logicsrflipflop.cpp \
     $$PWD/logictflipflop.cpp \
     $$PWD/logicxnor.cpp \
@@ -20,11 +23,14 @@ SOURCES += \
 
 HEADERS += \
     $$PWD/logicand.h \
+    $$PWD/logicbusgate.h \
+    $$PWD/logicbusmux.h \
     $$PWD/logicdemux.h \
     $$PWD/logicdflipflop.h \
     $$PWD/logicdlatch.h \
     $$PWD/logicinput.h \
     $$PWD/logicjkflipflop.h \
+    $$PWD/logicjoiner.h \
     $$PWD/logicmux.h \
     $$PWD/logicnand.h \
     $$PWD/logicnode.h \
@@ -33,7 +39,7 @@ HEADERS += \
     $$PWD/logicnot.h \
     $$PWD/logicor.h \
     $$PWD/logicoutput.h \
-    $$PWD/logicremotedevice.h \
+    $$PWD/logicsplitter.h \
     $$PWD/logicsrflipflop.h \
     $$PWD/logictflipflop.h \
     $$PWD/logicxnor.h \
@@ -10,6 +10,7 @@ class LogicInput : public LogicElement
 public:
     explicit LogicInput(const bool defaultValue = false, const int nOutputs = 1);
 
+    LogicType type() const override { return LogicType::Input; }
     void updateLogic() override;
 
 private:
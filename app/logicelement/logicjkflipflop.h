@@ -10,6 +10,7 @@ class LogicJKFlipFlop : public LogicElement
 public:
     explicit LogicJKFlipFlop();
 
+    LogicType type() const override { return LogicType::JKFlipFlop; }
     void updateLogic() override;
 
 private:
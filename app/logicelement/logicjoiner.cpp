@@ -0,0 +1,18 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logicjoiner.h"
+
+LogicJoiner::LogicJoiner(const int width)
+    : LogicElement(width, width)
+{
+}
+
+void LogicJoiner::updateLogic()
+{
+    if (!updateInputs()) {
+        return;
+    }
+
+    setOutputWord(inputWord(0, static_cast<int>(m_inputValues.size())));
+}
@@ -0,0 +1,19 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "logicelement.h"
+
+//! Joins single bits into a bus, the first input in the lowest bit.
+class LogicJoiner : public LogicElement
+{
+public:
+    explicit LogicJoiner(const int width);
+
+    LogicType type() const override { return LogicType::Joiner; }
+    void updateLogic() override;
+
+private:
+    Q_DISABLE_COPY(LogicJoiner)
+};
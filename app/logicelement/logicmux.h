@@ -10,6 +10,7 @@ class LogicMux : public LogicElement
 public:
     explicit LogicMux();
 
+    LogicType type() const override { return LogicType::Mux; }
     void updateLogic() override;
 
 private:
@@ -4,6 +4,7 @@
 #include "logicnand.h"
 
 #include <functional>
+#include <numeric>
 
 LogicNand::LogicNand(const int inputSize)
     : LogicElement(inputSize, 1)
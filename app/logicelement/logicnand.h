@@ -10,6 +10,7 @@ class LogicNand : public LogicElement
 public:
     explicit LogicNand(const int inputSize);
 
+    LogicType type() const override { return LogicType::Nand; }
     void updateLogic() override;
 
 private:
@@ -10,6 +10,7 @@ class LogicNode : public LogicElement
 public:
     explicit LogicNode();
 
+    LogicType type() const override { return LogicType::Node; }
     void updateLogic() override;
 
 private:
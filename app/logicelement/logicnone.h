@@ -10,6 +10,8 @@ class LogicNone : public LogicElement
 public:
     explicit LogicNone() : LogicElement(0, 0) {}
 
+    LogicType type() const override { return LogicType::None; }
+
 private:
     Q_DISABLE_COPY(LogicNone)
 
@@ -4,6 +4,7 @@
 #include "logicnor.h"
 
 #include <functional>
+#include <numeric>
 
 LogicNor::LogicNor(const int inputSize)
     : LogicElement(inputSize, 1)
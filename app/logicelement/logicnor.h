@@ -10,6 +10,7 @@ class LogicNor : public LogicElement
 public:
     explicit LogicNor(const int inputSize);
 
+    LogicType type() const override { return LogicType::Nor; }
     void updateLogic() override;
 
 private:
@@ -10,6 +10,7 @@ class LogicNot : public LogicElement
 public:
     explicit LogicNot();
 
+    LogicType type() const override { return LogicType::Not; }
     void updateLogic() override;
 
 private:
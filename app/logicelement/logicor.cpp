@@ -4,6 +4,7 @@
 #include "logicor.h"
 
 #include <functional>
+#include <numeric>
 
 LogicOr::LogicOr(const int inputSize)
     : LogicElement(inputSize, 1)
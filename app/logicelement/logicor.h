@@ -10,6 +10,7 @@ class LogicOr : public LogicElement
 public:
     explicit LogicOr(const int inputSize);
 
+    LogicType type() const override { return LogicType::Or; }
     void updateLogic() override;
 
 private:
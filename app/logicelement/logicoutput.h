@@ -10,6 +10,7 @@ class LogicOutput : public LogicElement
 public:
     explicit LogicOutput(const int inputSize);
 
+    LogicType type() const override { return LogicType::Output; }
     void updateLogic() override;
 
 private:
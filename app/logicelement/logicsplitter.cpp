@@ -0,0 +1,28 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "logicsplitter.h"
+
+#include <algorithm>
+
+LogicSplitter::LogicSplitter(const int width)
+    : LogicElement(1, width)
+{
+    m_inputValues.resize(width);
+    std::fill(m_inputValues.begin(), m_inputValues.end(), false);
+}
+
+int LogicSplitter::inputWidth(const int index) const
+{
+    Q_UNUSED(index)
+    return static_cast<int>(m_inputValues.size());
+}
+
+void LogicSplitter::updateLogic()
+{
+    if (!updateInputs()) {
+        return;
+    }
+
+    setOutputWord(inputWord(0, static_cast<int>(m_inputValues.size())));
+}
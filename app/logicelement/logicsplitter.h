@@ -0,0 +1,20 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "logicelement.h"
+
+//! Splits a bus into one output per bit, the lowest bit first.
+class LogicSplitter : public LogicElement
+{
+public:
+    explicit LogicSplitter(const int width);
+
+    LogicType type() const override { return LogicType::Splitter; }
+    int inputWidth(const int index) const override;
+    void updateLogic() override;
+
+private:
+    Q_DISABLE_COPY(LogicSplitter)
+};
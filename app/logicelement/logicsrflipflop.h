@@ -10,6 +10,7 @@ class LogicSRFlipFlop : public LogicElement
 public:
     explicit LogicSRFlipFlop();
 
+    LogicType type() const override { return LogicType::SRFlipFlop; }
     void updateLogic() override;
 
 private:
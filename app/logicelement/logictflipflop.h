@@ -10,6 +10,7 @@ class LogicTFlipFlop : public LogicElement
 public:
     explicit LogicTFlipFlop();
 
+    LogicType type() const override { return LogicType::TFlipFlop; }
     void updateLogic() override;
 
 private:
@@ -4,6 +4,7 @@
 #include "logicxnor.h"
 
 #include <functional>
+#include <numeric>
 
 LogicXnor::LogicXnor(const int inputSize)
     : LogicElement(inputSize, 1)
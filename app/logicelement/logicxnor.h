@@ -10,6 +10,7 @@ class LogicXnor : public LogicElement
 public:
     explicit LogicXnor(const int inputSize);
 
+    LogicType type() const override { return LogicType::Xnor; }
     void updateLogic() override;
 
 private:
@@ -4,6 +4,7 @@
 #include "logicxor.h"
 
 #include <functional>
+#include <numeric>
 
 LogicXor::LogicXor(const int inputSize)
     : LogicElement(inputSize, 1)
@@ -10,6 +10,7 @@ class LogicXor : public LogicElement
 public:
     explicit LogicXor(const int inputSize);
 
+    LogicType type() const override { return LogicType::Xor; }
     void updateLogic() override;
 
 private:
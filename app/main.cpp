@@ -2,13 +2,19 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "application.h"
+#include "batchgrader.h"
 #include "common.h"
+#include "equivalencechecker.h"
+#include "faultcoverage.h"
 #include "globalproperties.h"
+#include "headlesscircuit.h"
 #include "mainwindow.h"
 #include "protocol.h"
+#include "truthtable.h"
 
 #include <QCommandLineParser>
 #include <QMessageBox>
+#include <QTextStream>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -68,6 +74,48 @@ int main(int argc, char *argv[])
             QCoreApplication::translate("main", "Export circuit to waveform text file, reading input from terminal"));
         parser.addOption(terminalFileOption);
 
+        QCommandLineOption profileFileOption(
+            {"p", "profile"},
+            QCoreApplication::translate("main", "Simulate circuit for 5 seconds and save its performance counters to <profile-file> as JSON"),
+            QCoreApplication::translate("main", "profile file"));
+        parser.addOption(profileFileOption);
+
+        QCommandLineOption truthTableFileOption(
+            {"t", "truth-table"},
+            QCoreApplication::translate("main", "Export the truth table of a combinational circuit to <truth-table-file>, without opening a window"),
+            QCoreApplication::translate("main", "truth table file"));
+        parser.addOption(truthTableFileOption);
+
+        QCommandLineOption gradeOption(
+            {"g", "grade"},
+            QCoreApplication::translate("main", "Grade the circuits listed in <manifest> against their golden traces, without opening a window"),
+            QCoreApplication::translate("main", "manifest"));
+        parser.addOption(gradeOption);
+
+        QCommandLineOption resultsFileOption(
+            {"r", "results"},
+            QCoreApplication::translate("main", "Write the results of --grade to <results-file> as JSON"),
+            QCoreApplication::translate("main", "results file"),
+            "results.json");
+        parser.addOption(resultsFileOption);
+
+        QCommandLineOption nativeOption(
+            {"n", "native"},
+            QCoreApplication::translate("main", "Run the sequential circuits of --grade as native code built by the system C++ compiler, or by the interpreter if there is none"));
+        parser.addOption(nativeOption);
+
+        QCommandLineOption equivalenceFileOption(
+            {"e", "equivalence"},
+            QCoreApplication::translate("main", "Check whether the combinational circuit is equivalent to <reference-file>, without opening a window. Prints a counterexample and exits with 2 if they differ"),
+            QCoreApplication::translate("main", "reference file"));
+        parser.addOption(equivalenceFileOption);
+
+        QCommandLineOption faultCoverageOption(
+            {"f", "fault-coverage"},
+            QCoreApplication::translate("main", "Print the stuck-at fault coverage of the vectors in <stimulus-file> and the faults they miss, without opening a window"),
+            QCoreApplication::translate("main", "stimulus file"));
+        parser.addOption(faultCoverageOption);
+
         parser.process(app);
 
         if (const QString verbosity = parser.value(verbosityOption); !verbosity.isEmpty()) {
@@ -106,6 +154,55 @@ int main(int argc, char *argv[])
             exit(0);
         }
 
+        if (const QString profileFile = parser.value(profileFileOption); !profileFile.isEmpty()) {
+            if (!args.empty()) {
+                GlobalProperties::verbose = false;
+                MainWindow window;
+                window.loadPandaFile(args.at(0));
+                window.exportProfile(profileFile);
+            }
+            exit(0);
+        }
+
+        if (const QString truthTableFile = parser.value(truthTableFileOption); !truthTableFile.isEmpty()) {
+            if (!args.empty()) {
+                GlobalProperties::verbose = false;
+                const HeadlessCircuit circuit(args.at(0));
+                TruthTable(circuit).save(truthTableFile);
+            }
+            exit(0);
+        }
+
+        if (const QString manifestFile = parser.value(gradeOption); !manifestFile.isEmpty()) {
+            GlobalProperties::verbose = false;
+            BatchGrader grader(manifestFile);
+            grader.setNative(parser.isSet(nativeOption));
+            grader.save(parser.value(resultsFileOption));
+            exit(0);
+        }
+
+        if (const QString referenceFile = parser.value(equivalenceFileOption); !referenceFile.isEmpty()) {
+            if (!args.empty()) {
+                GlobalProperties::verbose = false;
+                const HeadlessCircuit circuit(args.at(0));
+                const HeadlessCircuit reference(referenceFile);
+                const EquivalenceChecker checker(circuit, reference);
+                const auto result = checker.run();
+                QTextStream(stdout) << result.summary(checker.inputLabels()) << '\n';
+                exit(result.equivalent ? 0 : 2);
+            }
+            exit(0);
+        }
+
+        if (const QString stimulusFile = parser.value(faultCoverageOption); !stimulusFile.isEmpty()) {
+            if (!args.empty()) {
+                GlobalProperties::verbose = false;
+                const FaultCoverage faultCoverage(args.at(0), stimulusFile);
+                QTextStream(stdout) << faultCoverage.report(faultCoverage.run());
+            }
+            exit(0);
+        }
+
         auto *window = new MainWindow();
         app.setMainWindow(window);
         window->show();
@@ -117,8 +214,11 @@ int main(int argc, char *argv[])
             window->loadPandaFile(args.at(0));
         }
     } catch (const std::exception &e) {
+        // The modes that run without a window turn verbose off, and have nowhere else to report the error.
         if (GlobalProperties::verbose) {
             QMessageBox::critical(nullptr, QObject::tr("Error!"), e.what());
+        } else {
+            QTextStream(stderr) << e.what() << '\n';
         }
         exit(1);
     }
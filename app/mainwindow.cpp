@@ -13,6 +13,7 @@
 #include "globalproperties.h"
 #include "graphicsview.h"
 #include "ic.h"
+#include "netlist.h"
 #include "recentfiles.h"
 #include "settings.h"
 #include "simulation.h"
@@ -27,6 +28,10 @@
 #include <QDebug>
 #include <QDesktopServices>
 #include <QFileDialog>
+#include <QEventLoop>
+#include <QInputDialog>
+#include <QJsonDocument>
+#include <QLabel>
 #include <QLoggingCategory>
 #include <QMessageBox>
 #include <QPdfWriter>
@@ -34,6 +39,7 @@
 #include <QSaveFile>
 #include <QShortcut>
 #include <QTemporaryFile>
+#include <QTimer>
 #include <QTranslator>
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
@@ -42,6 +48,8 @@
 #define SKIPEMPTYPARTS Qt::SkipEmptyParts
 #endif
 
+using namespace std::chrono_literals;
+
 MainWindow::MainWindow(const QString &fileName, QWidget *parent)
     : QMainWindow(parent)
     , m_ui(new Ui::MainWindow)
@@ -73,9 +81,34 @@ MainWindow::MainWindow(const QString &fileName, QWidget *parent)
     connect(&ThemeManager::instance(), &ThemeManager::themeChanged, this, &MainWindow::updateTheme);
     updateTheme();
     setFastMode(Settings::value("fastMode").toBool());
+
+    m_ui->actionRealTime->setData(1.0);
+    m_ui->actionRealTime10->setData(10.0);
+    m_ui->actionRealTime100->setData(100.0);
+    m_ui->actionRealTime1000->setData(1000.0);
+    m_ui->actionUnlimitedSpeed->setData(0.0);
+
+    auto *speedGroup = new QActionGroup(this);
+    const auto speedActions = m_ui->menuSpeed->actions();
+
+    for (auto *action : speedActions) {
+        speedGroup->addAction(action);
+    }
+
+    speedGroup->setExclusive(true);
+    connect(speedGroup, &QActionGroup::triggered, this, &MainWindow::on_speedGroup_triggered);
+    setRealTimeFactor(Settings::contains("realTimeFactor") ? Settings::value("realTimeFactor").toDouble() : 1.0);
     m_ui->actionLabelsUnderIcons->setChecked(Settings::value("labelsUnderIcons").toBool());
     m_ui->mainToolBar->setToolButtonStyle(Settings::value("labelsUnderIcons").toBool() ? Qt::ToolButtonTextUnderIcon : Qt::ToolButtonIconOnly);
 
+    m_performanceLabel = new QLabel(this);
+    m_ui->statusBar->addPermanentWidget(m_performanceLabel);
+    m_performanceTimer = new QTimer(this);
+    m_performanceTimer->setInterval(1s);
+    connect(m_performanceTimer, &QTimer::timeout, this, &MainWindow::updatePerformance);
+    m_ui->actionPerformance->setChecked(Settings::value("showPerformance").toBool());
+    on_actionPerformance_triggered(m_ui->actionPerformance->isChecked());
+
     qCDebug(zero) << tr("Setting left side menus.");
     auto *shortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_F), this);
     connect(shortcut, &QShortcut::activated, m_ui->lineEditSearch, qOverload<>(&QWidget::setFocus));
@@ -155,17 +188,20 @@ MainWindow::MainWindow(const QString &fileName, QWidget *parent)
     connect(m_ui->actionMute,             &QAction::triggered,        this,                &MainWindow::on_actionMute_triggered);
     connect(m_ui->actionNew,              &QAction::triggered,        this,                &MainWindow::on_actionNew_triggered);
     connect(m_ui->actionOpen,             &QAction::triggered,        this,                &MainWindow::on_actionOpen_triggered);
+    connect(m_ui->actionPerformance,      &QAction::triggered,        this,                &MainWindow::on_actionPerformance_triggered);
     connect(m_ui->actionPlay,             &QAction::toggled,          this,                &MainWindow::on_actionPlay_toggled);
     connect(m_ui->actionPortuguese,       &QAction::triggered,        this,                &MainWindow::on_actionPortuguese_triggered);
     connect(m_ui->actionReloadFile,       &QAction::triggered,        this,                &MainWindow::on_actionReloadFile_triggered);
     connect(m_ui->actionRename,           &QAction::triggered,        m_ui->elementEditor, &ElementEditor::renameAction);
     connect(m_ui->actionResetZoom,        &QAction::triggered,        this,                &MainWindow::on_actionResetZoom_triggered);
     connect(m_ui->actionRestart,          &QAction::triggered,        this,                &MainWindow::on_actionRestart_triggered);
+    connect(m_ui->actionRewind,           &QAction::triggered,        this,                &MainWindow::on_actionRewind_triggered);
     connect(m_ui->actionRotateLeft,       &QAction::triggered,        this,                &MainWindow::on_actionRotateLeft_triggered);
     connect(m_ui->actionRotateRight,      &QAction::triggered,        this,                &MainWindow::on_actionRotateRight_triggered);
     connect(m_ui->actionSave,             &QAction::triggered,        this,                &MainWindow::on_actionSave_triggered);
     connect(m_ui->actionSaveAs,           &QAction::triggered,        this,                &MainWindow::on_actionSaveAs_triggered);
     connect(m_ui->actionSelectAll,        &QAction::triggered,        this,                &MainWindow::on_actionSelectAll_triggered);
+    connect(m_ui->actionTrace,            &QAction::triggered,        this,                &MainWindow::on_actionTrace_triggered);
     connect(m_ui->actionWaveform,         &QAction::triggered,        this,                &MainWindow::on_actionWaveform_triggered);
     connect(m_ui->actionWires,            &QAction::triggered,        this,                &MainWindow::on_actionWires_triggered);
     connect(m_ui->actionZoomIn,           &QAction::triggered,        this,                &MainWindow::on_actionZoomIn_triggered);
@@ -222,6 +258,7 @@ void MainWindow::createNewTab()
     connect(workspace, &WorkSpace::fileChanged, this, &MainWindow::setCurrentFile);
 
     workspace->view()->setFastMode(m_ui->actionFastMode->isChecked());
+    workspace->simulation()->setRealTimeFactor(m_realTimeFactor);
     workspace->scene()->updateTheme();
 
     qCDebug(zero) << tr("Adding tab. #tabs: ") << m_ui->tab->count() << tr(", current tab: ") << m_tabIndex;
@@ -723,6 +760,8 @@ void MainWindow::tabChanged(const int newTabIndex)
     m_currentTab = qobject_cast<WorkSpace *>(m_ui->tab->currentWidget());
     qCDebug(zero) << tr("Selecting tab: ") << newTabIndex;
     connectTab();
+    m_ui->actionTrace->setChecked(m_currentTab->simulation()->isTracing());
+    m_lastCounters = m_currentTab->simulation()->counters().sample();
     qCDebug(zero) << tr("New tab selected. Dolphin fileName: ") << m_currentTab->dolphinFileName();
 }
 
@@ -862,6 +901,39 @@ void MainWindow::exportToWaveFormFile(const QString &fileName)
     bewavedDolphin->print();
 }
 
+void MainWindow::exportProfile(const QString &fileName, const std::chrono::milliseconds duration)
+{
+    if (fileName.isEmpty()) {
+        throw Pandaception(tr("Missing file name."));
+    }
+
+    // Generated again, so the mapping and sorting of the circuit are counted as well.
+    auto *simulation = m_currentTab->simulation();
+    simulation->restart();
+    simulation->counters().reset();
+    simulation->start();
+
+    QEventLoop loop;
+    QTimer::singleShot(duration, &loop, &QEventLoop::quit);
+    loop.exec();
+
+    simulation->stop();
+
+    auto profile = simulation->counters().sample().toJson();
+    const auto *netlist = simulation->netlist();
+    profile.insert("file", m_currentFile.fileName());
+    profile.insert("elements", netlist ? netlist->elementCount() : 0);
+
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw Pandaception(tr("Error opening file: ") + file.errorString());
+    }
+
+    file.write(QJsonDocument(profile).toJson());
+    qCDebug(zero) << tr("Profile written to ") << fileName;
+}
+
 void MainWindow::exportToWaveFormTerminal()
 {
     auto *bewavedDolphin = new BewavedDolphin(m_currentTab->scene(), false, this);
@@ -1153,6 +1225,73 @@ void MainWindow::on_actionPlay_toggled(const bool checked)
     checked ? simulation->start() : simulation->stop();
 }
 
+void MainWindow::on_actionTrace_triggered(const bool checked)
+{
+    if (!m_currentTab) {
+        m_ui->actionTrace->setChecked(false);
+        return;
+    }
+
+    auto *simulation = m_currentTab->simulation();
+
+    if (!checked) {
+        simulation->stopTrace();
+        return;
+    }
+
+    QString path;
+
+    if (m_currentFile.exists()) {
+        path = m_currentFile.absolutePath();
+    }
+
+    const QString fileName = QFileDialog::getSaveFileName(this, tr("Record Trace"), path, tr("VCD files (*.vcd)"));
+
+    if (fileName.isEmpty()) {
+        m_ui->actionTrace->setChecked(false);
+        return;
+    }
+
+    const auto selected = m_currentTab->scene()->selectedElements();
+    auto elements = QVector<GraphicElement *>(selected.cbegin(), selected.cend());
+
+    if (elements.isEmpty()) {
+        elements = m_currentTab->scene()->elements();
+    }
+
+    try {
+        simulation->startTrace(fileName, elements);
+    } catch (const Pandaception &e) {
+        m_ui->actionTrace->setChecked(false);
+        QMessageBox::critical(this, tr("Error!"), e.what());
+    }
+}
+
+void MainWindow::on_actionRewind_triggered()
+{
+    if (!m_currentTab) {
+        return;
+    }
+
+    auto *simulation = m_currentTab->simulation();
+    SimulationBlocker simulationBlocker(simulation);
+    auto *netlist = simulation->netlist();
+
+    if (!netlist) {
+        return;
+    }
+
+    // Cycles go past the range of an int within minutes of fast clocks, so they are asked for as a double.
+    const double first = static_cast<double>(netlist->firstCycle());
+    const double last = static_cast<double>(netlist->cycle());
+    bool ok = false;
+    const double cycle = QInputDialog::getDouble(this, tr("Rewind"), tr("Cycle (%1 to %2):").arg(first, 0, 'f', 0).arg(last, 0, 'f', 0), last, first, last, 0, &ok);
+
+    if (ok && !simulation->rewind(static_cast<quint64>(cycle))) {
+        QMessageBox::warning(this, tr("Rewind"), tr("This cycle is not kept anymore."));
+    }
+}
+
 void MainWindow::on_actionRestart_triggered()
 {
     if (!m_currentTab) {
@@ -1180,7 +1319,7 @@ void MainWindow::populateLeftMenu()
 {
     m_ui->tabElements->setCurrentIndex(0);
     QStringList inOutElements = {"InputVcc", "InputGnd", "InputButton", "InputSwitch", "InputRotary", "Clock", "Led", "Display7", "Display14", "Buzzer"};
-    QStringList gatesElements = {"And", "Or", "Not", "Nand", "Nor", "Xor", "Xnor", "Mux", "Demux", "Node"};
+    QStringList gatesElements = {"And", "Or", "Not", "Nand", "Nor", "Xor", "Xnor", "Mux", "Demux", "Splitter", "Joiner", "Node"};
     QStringList memoryElements = {"DLatch", "DFlipFlop", "JKFlipFlop", "SRFlipFlop", "TFlipFlop"};
     QStringList miscElements = {"Text", "Line"};
 
@@ -1202,6 +1341,57 @@ void MainWindow::populateLeftMenu()
     populateMenu(m_ui->verticalSpacer_Misc, miscElements, m_ui->scrollAreaWidgetContents_Misc->layout());
 }
 
+void MainWindow::setRealTimeFactor(const double factor)
+{
+    m_realTimeFactor = qMax(factor, 0.0);
+
+    const auto speedActions = m_ui->menuSpeed->actions();
+
+    for (auto *action : speedActions) {
+        action->setChecked(qFuzzyCompare(action->data().toDouble() + 1, m_realTimeFactor + 1));
+    }
+
+    for (int tab = 0; tab < m_ui->tab->count(); ++tab) {
+        if (auto *workspace = qobject_cast<WorkSpace *>(m_ui->tab->widget(tab))) {
+            workspace->simulation()->setRealTimeFactor(m_realTimeFactor);
+        }
+    }
+}
+
+void MainWindow::on_speedGroup_triggered(QAction *action)
+{
+    setRealTimeFactor(action->data().toDouble());
+    Settings::setValue("realTimeFactor", m_realTimeFactor);
+}
+
+void MainWindow::on_actionPerformance_triggered(const bool checked)
+{
+    m_performanceLabel->setVisible(checked);
+    m_performanceLabel->clear();
+    checked ? m_performanceTimer->start() : m_performanceTimer->stop();
+    Settings::setValue("showPerformance", checked);
+
+    if (m_currentTab) {
+        m_lastCounters = m_currentTab->simulation()->counters().sample();
+    }
+}
+
+void MainWindow::updatePerformance()
+{
+    if (!m_currentTab) {
+        m_performanceLabel->clear();
+        return;
+    }
+
+    const auto counters = m_currentTab->simulation()->counters().sample();
+    m_performanceLabel->setText(counters.since(m_lastCounters).summary());
+    m_performanceLabel->setToolTip(tr("%1 simulation layers generated: %2 ms mapping, %3 ms sorting")
+                                       .arg(counters.initializations)
+                                       .arg(std::chrono::duration<double, std::milli>(counters.mappingTime).count(), 0, 'f', 1)
+                                       .arg(std::chrono::duration<double, std::milli>(counters.sortingTime).count(), 0, 'f', 1));
+    m_lastCounters = counters;
+}
+
 void MainWindow::on_actionFastMode_triggered(const bool checked)
 {
     setFastMode(checked);
@@ -3,13 +3,19 @@
 
 #pragma once
 
+#include "simulationcounters.h"
+
 #include <QDir>
 #include <QMainWindow>
 #include <QSpacerItem>
 #include <QTranslator>
 #include <QDomDocument>
 
+#include <chrono>
+
 class ElementLabel;
+class QLabel;
+class QTimer;
 class RecentFiles;
 class WorkSpace;
 
@@ -51,6 +57,9 @@ public:
     //! Saves the current beWavedDolphin (waveform simulator) file
     void exportToWaveFormFile(const QString &fileName);
 
+    //! Runs the simulation of the current tab for @p duration and saves its performance counters as JSON.
+    void exportProfile(const QString &fileName, const std::chrono::milliseconds duration = std::chrono::seconds(5));
+
     //! Loads a .panda file
     void loadPandaFile(const QString &fileName);
 
@@ -66,6 +75,8 @@ public:
     void retranslateUi();
     void setDolphinFileName(const QString &fileName);
     void setFastMode(const bool fastMode);
+    //! Sets the real-time factor of the clocks of every tab. See Simulation::setRealTimeFactor().
+    void setRealTimeFactor(const double factor);
     QDomDocument* loadRemoteFunctions();
 
 signals:
@@ -102,16 +113,19 @@ private:
     void on_actionMute_triggered(const bool checked);
     void on_actionNew_triggered();
     void on_actionOpen_triggered();
+    void on_actionPerformance_triggered(const bool checked);
     void on_actionPlay_toggled(const bool checked);
     void on_actionPortuguese_triggered();
     void on_actionReloadFile_triggered();
     void on_actionResetZoom_triggered() const;
     void on_actionRestart_triggered();
+    void on_actionRewind_triggered();
     void on_actionRotateLeft_triggered();
     void on_actionRotateRight_triggered();
     void on_actionSaveAs_triggered();
     void on_actionSave_triggered();
     void on_actionSelectAll_triggered();
+    void on_actionTrace_triggered(const bool checked);
     void on_actionWaveform_triggered();
     void on_actionGamefication_triggered();
     void on_actionWires_triggered(const bool checked);
@@ -121,11 +135,14 @@ private:
     void on_lineEditSearch_textChanged(const QString &text);
     void on_pushButtonAddIC_clicked();
     void on_pushButtonRemoveIC_clicked();
+    void on_speedGroup_triggered(QAction *action);
     void openRecentFile();
     void populateLeftMenu();
     void removeICFile(const QString &icFileName);
     void tabChanged(const int newTabIndex);
     void updateICList();
+    //! Shows the performance counters of the current tab since the last call.
+    void updatePerformance();
     void updateRecentFileActions();
     void updateSettings();
     void updateTheme();
@@ -151,7 +168,11 @@ private:
     RecentFiles *m_recentFiles = nullptr;
 
     QFileInfo m_currentFile;
+    QLabel *m_performanceLabel = nullptr;
+    QTimer *m_performanceTimer = nullptr;
+    SimulationCounters::Sample m_lastCounters;
     WorkSpace *m_currentTab = nullptr;
+    double m_realTimeFactor = 1.0;
     int m_tabIndex = -1;
 
     int m_lastTabIndex = -1;
@@ -0,0 +1,393 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "nativecode.h"
+
+#include "common.h"
+#include "netlist.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+#include <QStandardPaths>
+#include <QTextStream>
+
+#include <atomic>
+
+namespace
+{
+    //! Statements per function of the generated code, as compilers slow down on huge functions.
+    const int partSize = 4096;
+    //! A circuit of a million gates builds in about a minute.
+    const int buildTimeout = 10 * 60 * 1000;
+
+#if defined(Q_OS_MACOS)
+    const char librarySuffix[] = ".dylib";
+#else
+    const char librarySuffix[] = ".so";
+#endif
+
+    //! Same bit layout and flip-flop behavior as Netlist::evaluate(). States use the bits of Netlist::StateBit.
+    const char prelude[] = R"(// Generated by WiRedPanda from the netlist of a circuit.
+
+typedef unsigned long long u64;
+typedef unsigned char u8;
+
+#define B(s) ((v[(s) >> 6] >> ((s) & 63)) & 1ULL)
+#define W(s, m) ((v[(s) >> 6] >> ((s) & 63)) & (m))
+
+static inline unsigned put(u64 *v, const int s, const u64 m, const u64 x)
+{
+    const u64 d = (((v[s >> 6] >> (s & 63)) ^ x) & m) << (s & 63);
+    v[s >> 6] ^= d;
+    return d != 0;
+}
+
+static inline u64 latch(const u64 q, const u64 d, const u64 enable)
+{
+    return enable ? (d | ((d ^ 1) << 1)) : q;
+}
+
+static inline u64 dff(const u64 q, u8 &st, const u64 d, const u64 clk, const u64 prst, const u64 clr)
+{
+    u64 q0 = q & 1, q1 = (q >> 1) & 1;
+    if (clk && !(st & 1)) { q0 = (st >> 1) & 1; q1 = q0 ^ 1; }
+    if (!prst || !clr) { q0 = prst ^ 1; q1 = clr ^ 1; }
+    st = (clk ? 1 : 0) | (d ? 2 : 0);
+    return q0 | (q1 << 1);
+}
+
+static inline u64 jkff(const u64 q, u8 &st, const u64 j, const u64 clk, const u64 k, const u64 prst, const u64 clr)
+{
+    u64 q0 = q & 1, q1 = (q >> 1) & 1;
+    if (clk && !(st & 1)) {
+        if ((st & 2) && (st & 4)) { const u64 t = q0; q0 = q1; q1 = t; }
+        else if (st & 2) { q0 = 1; q1 = 0; }
+        else if (st & 4) { q0 = 0; q1 = 1; }
+    }
+    if (!prst || !clr) { q0 = prst ^ 1; q1 = clr ^ 1; }
+    st = (clk ? 1 : 0) | (j ? 2 : 0) | (k ? 4 : 0);
+    return q0 | (q1 << 1);
+}
+
+static inline u64 srff(const u64 q, u8 &st, const u64 s, const u64 clk, const u64 r, const u64 prst, const u64 clr)
+{
+    u64 q0 = q & 1, q1 = (q >> 1) & 1;
+    if (clk && !(st & 1)) {
+        if (s && r) { q0 = 1; q1 = 1; }
+        else if (s != r) { q0 = s; q1 = r; }
+    }
+    if (!prst || !clr) { q0 = prst ^ 1; q1 = clr ^ 1; }
+    st = (clk ? 1 : 0);
+    return q0 | (q1 << 1);
+}
+
+static inline u64 tff(const u64 q, u8 &st, const u64 t, const u64 clk, const u64 prst, const u64 clr)
+{
+    u64 q0 = q & 1, q1 = (q >> 1) & 1;
+    if (clk && !(st & 1) && (st & 2)) { q0 ^= 1; q1 = q0 ^ 1; }
+    if (!prst || !clr) { q0 = prst ^ 1; q1 = clr ^ 1; }
+    st = (clk ? 1 : 0) | (t ? 2 : 0);
+    return q0 | (q1 << 1);
+}
+)";
+}
+
+NativeCode::NativeCode(const QString &fileName)
+    : m_library(fileName)
+{
+    if (m_library.load()) {
+        m_step = reinterpret_cast<Step>(m_library.resolve("wpanda_step"));
+    }
+}
+
+NativeCode::~NativeCode()
+{
+    m_library.unload();
+}
+
+NativeCode::Step NativeCode::step() const
+{
+    return m_step;
+}
+
+QString NativeCode::expression(const Netlist &netlist, const int element)
+{
+    const int *fanin = netlist.m_fanin.data() + netlist.m_faninBegin[element];
+    const int faninCount = netlist.m_faninBegin[element + 1] - netlist.m_faninBegin[element];
+    const int output = netlist.m_outputBegin[element];
+    const int width = netlist.m_outputEnd[element] - output;
+    const QString mask = "0x" + QString::number(Netlist::widthMask(qMin(width, 64)), 16) + "ULL";
+
+    const auto bit = [fanin](const int index) {
+        return QString("B(%1)").arg(fanin[index]);
+    };
+
+    const auto word = [fanin, &mask](const int index) {
+        return QString("W(%1, %2)").arg(fanin[index]).arg(mask);
+    };
+
+    // Bits of every input, the first one in the lowest bit.
+    const auto concatenate = [&bit, faninCount] {
+        QStringList bits{"0"};
+
+        for (int index = 0; index < faninCount; ++index) {
+            bits << QString("(%1 << %2)").arg(bit(index)).arg(index);
+        }
+
+        return bits.join(" | ");
+    };
+
+    const auto reduce = [faninCount](const auto &operand, const QString &operation, const QString &identity) {
+        QStringList operands{identity};
+
+        for (int index = 0; index < faninCount; ++index) {
+            operands << operand(index);
+        }
+
+        return "(" + operands.join(operation) + ")";
+    };
+
+    const auto put = [output, &mask](const QString &value) {
+        return QString("put(v, %1, %2, %3)").arg(output).arg(mask, value);
+    };
+
+    const auto flipFlop = [&](const QString &function) {
+        QStringList arguments{QString("W(%1, 3)").arg(output), QString("st[%1]").arg(element)};
+
+        for (int index = 0; index < faninCount; ++index) {
+            arguments << bit(index);
+        }
+
+        return put(function + "(" + arguments.join(", ") + ")");
+    };
+
+    switch (netlist.m_types[element]) {
+    case LogicType::And:  return put(reduce(bit, " & ", "1"));
+    case LogicType::Nand: return put(reduce(bit, " & ", "1") + " ^ 1");
+    case LogicType::Or:   return put(reduce(bit, " | ", "0"));
+    case LogicType::Nor:  return put(reduce(bit, " | ", "0") + " ^ 1");
+    case LogicType::Xor:  return put(reduce(bit, " ^ ", "0"));
+    case LogicType::Xnor: return put(reduce(bit, " ^ ", "0") + " ^ 1");
+    case LogicType::Node: return put(bit(0));
+    case LogicType::Not:  return put(bit(0) + " ^ 1");
+    case LogicType::Mux:  return put(QString("%1 ? %2 : %3").arg(bit(2), bit(1), bit(0)));
+
+    case LogicType::BusAnd:   return put(reduce(word, " & ", "~0ULL"));
+    case LogicType::BusOr:    return put(reduce(word, " | ", "0"));
+    case LogicType::BusXor:   return put(reduce(word, " ^ ", "0"));
+    case LogicType::BusNot:   return put("~" + word(0));
+    case LogicType::BusMux:   return put(QString("%1 ? %2 : %3").arg(bit(2), word(1), word(0)));
+    case LogicType::Splitter: return put(word(0));
+    case LogicType::Joiner:   return put(concatenate());
+
+    case LogicType::Demux:  return put(QString("(%1 & (%2 ^ 1)) | ((%1 & %2) << 1)").arg(bit(0), bit(1)));
+    case LogicType::DLatch: return put(QString("latch(W(%1, 3), %2, %3)").arg(output).arg(bit(0), bit(1)));
+
+    case LogicType::DFlipFlop:  return flipFlop("dff");
+    case LogicType::JKFlipFlop: return flipFlop("jkff");
+    case LogicType::SRFlipFlop: return flipFlop("srff");
+    case LogicType::TFlipFlop:  return flipFlop("tff");
+
+    case LogicType::Output: {
+        if (width <= 64) {
+            return put(concatenate());
+        }
+
+        QStringList puts;
+
+        for (int index = 0; index < faninCount; ++index) {
+            puts << QString("put(v, %1, 1, %2)").arg(output + index).arg(bit(index));
+        }
+
+        return puts.join(" | ");
+    }
+
+    case LogicType::Custom:
+    case LogicType::Input:
+    case LogicType::None:
+        return {};
+    }
+
+    return {};
+}
+
+QString NativeCode::generate(const Netlist &netlist)
+{
+    if (netlist.m_hasCustom) {
+        return {};
+    }
+
+    QString source;
+    QTextStream stream(&source);
+    stream << prelude;
+
+    int partCount = 0;
+    int statements = partSize;
+
+    for (int element = 0; element < netlist.elementCount();) {
+        // A part is only closed between feedback loops, so each loop is swept by a single function.
+        if (statements >= partSize) {
+            if (partCount > 0) {
+                stream << "}\n";
+            }
+
+            stream << "\n__attribute__((noinline)) static void part" << partCount++ << "(u64 *v, u8 *st, u8 *ch)\n{\n";
+            statements = 0;
+        }
+
+        const int component = netlist.m_component[element];
+
+        if (component == -1) {
+            if (const QString statement = expression(netlist, element); !statement.isEmpty()) {
+                stream << "    ch[" << element << "] |= " << statement << ";\n";
+                ++statements;
+            }
+
+            ++element;
+            continue;
+        }
+
+        stream << "    for (int pass = 0; pass < " << Netlist::maxFeedbackPasses << "; ++pass) {\n";
+        stream << "        unsigned changed = 0;\n";
+
+        for (; element < netlist.m_componentEnd[component]; ++element) {
+            if (const QString statement = expression(netlist, element); !statement.isEmpty()) {
+                stream << "        { const unsigned x = " << statement << "; ch[" << element << "] |= x; changed |= x; }\n";
+                ++statements;
+            }
+        }
+
+        stream << "        if (!changed) break;\n";
+        stream << "    }\n";
+    }
+
+    if (partCount > 0) {
+        stream << "}\n";
+    }
+
+    stream << "\nextern \"C\"\n";
+    stream << "void wpanda_step(u64 *v, u8 *st, u8 *ch)\n{\n";
+
+    for (int part = 0; part < partCount; ++part) {
+        stream << "    part" << part << "(v, st, ch);\n";
+    }
+
+    stream << "}\n";
+    stream.flush();
+
+    return source;
+}
+
+QString NativeCode::findCompiler()
+{
+#ifdef Q_OS_WIN
+    // The generated code and the build command are those of GCC and Clang, so Windows stays on the interpreter.
+    return {};
+#else
+    QStringList candidates{"c++", "g++", "clang++"};
+
+    if (const QString compiler = qEnvironmentVariable("CXX"); !compiler.isEmpty()) {
+        candidates.prepend(compiler);
+    }
+
+    for (const auto &candidate : qAsConst(candidates)) {
+        if (const QString path = QStandardPaths::findExecutable(candidate); !path.isEmpty()) {
+            return path;
+        }
+    }
+
+    return {};
+#endif
+}
+
+bool NativeCode::build(const QString &compiler, const QString &source, const QString &baseName, const QString &libraryName)
+{
+    qCDebug(zero) << tr("Building native code: ") << libraryName;
+
+    // Written and built under names of their own, the library being renamed once complete, as other instances, or
+    // other threads grading identical circuits, may build the same netlist at the same time.
+    static std::atomic<int> buildCount{0};
+    const QString temporaryBase = baseName + "-" + QString::number(QCoreApplication::applicationPid()) + "-" + QString::number(buildCount++);
+    const QString temporaryName = temporaryBase + librarySuffix;
+
+    QFile sourceFile(temporaryBase + ".cpp");
+
+    if (!sourceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCDebug(zero) << tr("Could not write native code: ") << sourceFile.fileName();
+        return false;
+    }
+
+    sourceFile.write(source.toUtf8());
+    sourceFile.close();
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(compiler, {"-O2", "-shared", "-fPIC", "-o", temporaryName, sourceFile.fileName()});
+
+    const bool built = process.waitForFinished(buildTimeout) && (process.exitStatus() == QProcess::NormalExit) && (process.exitCode() == 0);
+
+    sourceFile.remove();
+
+    if (!built) {
+        qCDebug(zero) << tr("Native code build failed: ") << process.readAll();
+        QFile::remove(temporaryName);
+        return false;
+    }
+
+    if (!QFile::rename(temporaryName, libraryName)) {
+        QFile::remove(temporaryName);
+    }
+
+    return QFile::exists(libraryName);
+}
+
+std::shared_ptr<NativeCode> NativeCode::load(const QString &source)
+{
+    if (source.isEmpty()) {
+        return nullptr;
+    }
+
+    const QString compiler = findCompiler();
+
+    if (compiler.isEmpty()) {
+        qCDebug(zero) << tr("No C++ compiler found, simulating with the interpreter.");
+        return nullptr;
+    }
+
+    // The compiler is part of the key, so switching compilers builds again.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(compiler.toUtf8());
+    hash.addData(source.toUtf8());
+
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+    if (cachePath.isEmpty()) {
+        cachePath = QDir::tempPath();
+    }
+
+    const QDir cacheDir(cachePath + "/native");
+
+    if (!cacheDir.mkpath(".")) {
+        qCDebug(zero) << tr("Could not create the native code cache: ") << cacheDir.path();
+        return nullptr;
+    }
+
+    const QString baseName = cacheDir.filePath("wpanda-" + QString::fromLatin1(hash.result().toHex()));
+    const QString libraryName = baseName + librarySuffix;
+
+    if (!QFile::exists(libraryName) && !build(compiler, source, baseName, libraryName)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<NativeCode> code(new NativeCode(libraryName));
+
+    if (!code->m_step) {
+        qCDebug(zero) << tr("Could not load native code: ") << code->m_library.errorString();
+        return nullptr;
+    }
+
+    qCDebug(zero) << tr("Simulating with native code: ") << libraryName;
+    return code;
+}
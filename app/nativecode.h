@@ -0,0 +1,51 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QLibrary>
+
+#include <memory>
+
+class Netlist;
+
+/**
+ * @brief Native code of a Netlist, built with the system compiler and loaded as a shared library.
+ *
+ * The netlist becomes a C++ translation unit with one statement per element, in levelized order, working on the
+ * same bit-packed values and flip-flop states as the interpreter. Feedback loops are swept until they settle,
+ * within the same limit of passes. Builds are cached by a hash of their source, so a circuit is only compiled
+ * the first time it is simulated. The code is built with GCC or Clang, so there is no native code on Windows.
+ */
+class NativeCode
+{
+    Q_DECLARE_TR_FUNCTIONS(NativeCode)
+
+public:
+    //! Evaluates every element once. Sets the flag of each element whose outputs changed.
+    using Step = void (*)(quint64 *values, quint8 *state, quint8 *changed);
+
+    //! C++ source of the native code of @p netlist, or an empty string if it has custom elements.
+    static QString generate(const Netlist &netlist);
+
+    //! Loads the build of @p source from the cache, building it first if needed. Returns nullptr if @p source is
+    //! empty, if no compiler is found or if the build fails.
+    static std::shared_ptr<NativeCode> load(const QString &source);
+
+    ~NativeCode();
+
+    Step step() const;
+
+private:
+    Q_DISABLE_COPY(NativeCode)
+
+    explicit NativeCode(const QString &fileName);
+
+    static QString expression(const Netlist &netlist, const int element);
+    static QString findCompiler();
+    static bool build(const QString &compiler, const QString &source, const QString &baseName, const QString &libraryName);
+
+    QLibrary m_library;
+    Step m_step = nullptr;
+};
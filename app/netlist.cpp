@@ -0,0 +1,1587 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "netlist.h"
+
+#include "levelizer.h"
+#include "nativecode.h"
+#include "threadpool.h"
+#include "vcdwriter.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+namespace
+{
+    //! Netlists with fewer elements are evaluated serially, as waking the workers costs more than it saves.
+    const int parallelThreshold = 16384;
+    //! Minimum number of elements evaluated by a task of the thread pool.
+    const int parallelChunkSize = 512;
+
+    //! Output of a single-bit gate whose inputs have the values in @p inputs, -1 for those that are not constant.
+    //! Returns -1 when the output still depends on them.
+    int constantOutput(const LogicType type, const std::vector<int> &inputs)
+    {
+        const bool variable = std::find(inputs.cbegin(), inputs.cend(), -1) != inputs.cend();
+
+        const auto has = [&inputs](const int value) {
+            return std::find(inputs.cbegin(), inputs.cend(), value) != inputs.cend();
+        };
+
+        const auto parity = [&inputs] {
+            return std::accumulate(inputs.cbegin(), inputs.cend(), 0) & 1;
+        };
+
+        switch (type) {
+        case LogicType::And:  return has(0) ? 0 : (variable ? -1 : 1);
+        case LogicType::Nand: return has(0) ? 1 : (variable ? -1 : 0);
+        case LogicType::Or:   return has(1) ? 1 : (variable ? -1 : 0);
+        case LogicType::Nor:  return has(1) ? 0 : (variable ? -1 : 1);
+        case LogicType::Xor:  return variable ? -1 : parity();
+        case LogicType::Xnor: return variable ? -1 : (parity() ^ 1);
+        case LogicType::Node: return inputs.at(0);
+        case LogicType::Not:  return (inputs.at(0) < 0) ? -1 : (inputs.at(0) ^ 1);
+
+        case LogicType::Mux:
+            if (inputs.at(2) >= 0) {
+                return inputs.at(inputs.at(2));
+            }
+
+            return (inputs.at(0) == inputs.at(1)) ? inputs.at(0) : -1;
+
+        default:
+            return -1;
+        }
+    }
+}
+
+Netlist::Netlist(const QVector<std::shared_ptr<LogicElement>> &logicElms, const int optimizations)
+{
+    const int count = logicElms.size();
+
+    m_logic.reserve(count);
+    m_types.reserve(count);
+
+    for (const auto &logic : logicElms) {
+        m_logic.push_back(logic.get());
+        m_types.push_back(logic->isValid() ? logic->type() : LogicType::None);
+    }
+
+    const auto isCompiled = [&](const LogicElement *logic) {
+        const int index = logic->sortIndex();
+        return (index >= 0) && (index < count) && (m_logic.at(index) == logic);
+    };
+
+    // Elements are sorted by priority, so elements of the same level are contiguous. Priorities are recomputed
+    // from the sorted fan-out, ignoring feedback edges, to find where each level starts.
+    std::vector<int> priorities(count, 1);
+
+    for (int element = count - 1; element >= 0; --element) {
+        for (auto *successor : m_logic.at(element)->successors()) {
+            if (isCompiled(successor) && (successor->sortIndex() > element)) {
+                priorities[element] = qMax(priorities[element], priorities[successor->sortIndex()] + 1);
+            } else if (isCompiled(successor)) {
+                m_hasFeedback = true;
+            }
+        }
+
+        if (m_types.at(element) == LogicType::Custom) {
+            m_hasCustom = true;
+        }
+    }
+
+    // Each level starts on a new word and no element straddles two words, so chunks of a level made of whole
+    // words can be evaluated by different threads without ever writing to the same word.
+    m_outputBegin.reserve(count);
+    m_outputEnd.reserve(count);
+
+    for (int element = 0; element < count; ++element) {
+        const int outputCount = static_cast<int>(m_logic.at(element)->getOutputAmount());
+        const bool levelStart = (element == 0) || (priorities.at(element) != priorities.at(element - 1));
+
+        if (levelStart || (((m_slotCount & 63) + outputCount > 64) && (outputCount <= 64))) {
+            m_slotCount = (m_slotCount + 63) & ~63;
+        }
+
+        if (levelStart) {
+            m_levelBegin.push_back(element);
+        }
+
+        m_outputBegin.push_back(m_slotCount);
+        m_slotCount += outputCount;
+        m_outputEnd.push_back(m_slotCount);
+    }
+
+    m_levelBegin.push_back(count);
+
+    // The constant slots get words of their own as well.
+    m_slotCount = (m_slotCount + 63) & ~63;
+
+    // Predecessors outside of the mapping (the global VCC and GND of each mapping) never change,
+    // so they become constant slots after the element outputs.
+    QHash<QPair<LogicElement *, int>, int> externalSlots;
+    QVector<bool> externalValues;
+
+    m_faninBegin.reserve(count + 1);
+
+    for (int element = 0; element < count; ++element) {
+        m_faninBegin.push_back(static_cast<int>(m_fanin.size()));
+
+        if (m_types.at(element) == LogicType::None) {
+            continue;
+        }
+
+        const auto &inputPairs = m_logic.at(element)->inputPairs();
+
+        for (int index = 0; index < inputPairs.size(); ++index) {
+            const auto &inputPair = inputPairs.at(index);
+
+            if (isCompiled(inputPair.logic)) {
+                m_fanin.push_back(m_outputBegin.at(inputPair.logic->sortIndex()) + inputPair.port);
+                m_faninElement.push_back(inputPair.logic->sortIndex());
+                continue;
+            }
+
+            const auto key = qMakePair(inputPair.logic, inputPair.port);
+
+            if (!externalSlots.contains(key)) {
+                const int width = m_logic.at(element)->inputWidth(index);
+
+                // A constant bus must not straddle two words either.
+                if ((externalValues.size() & 63) + width > 64) {
+                    externalValues.resize((externalValues.size() + 63) & ~63);
+                }
+
+                externalSlots.insert(key, m_slotCount + externalValues.size());
+
+                for (int offset = 0; offset < width; ++offset) {
+                    externalValues.append(inputPair.logic->outputValue(inputPair.port + offset));
+                }
+            }
+
+            m_fanin.push_back(externalSlots.value(key));
+            m_faninElement.push_back(-1);
+        }
+    }
+
+    m_faninBegin.push_back(static_cast<int>(m_fanin.size()));
+
+    // Elements of the same feedback loop are contiguous, as sorted by levelize().
+    m_component.reserve(count);
+
+    for (int element = 0; element < count; ++element) {
+        const auto *component = m_logic.at(element)->component();
+
+        if (!component) {
+            m_component.push_back(-1);
+            continue;
+        }
+
+        if ((element == 0) || (m_logic.at(element - 1)->component() != component)) {
+            m_componentBegin.push_back(element);
+            m_componentEnd.push_back(element);
+        }
+
+        m_componentEnd.back() = element + 1;
+        m_component.push_back(static_cast<int>(m_componentBegin.size()) - 1);
+    }
+
+    m_aliasBegin.assign(count + 1, 0);
+    const auto aliased = optimize(optimizations, externalValues);
+
+    // Each evaluated element is in the fan-out of the elements writing the slots it reads, which aliasing may have
+    // moved away from its predecessors. Elements are visited in order, so every fan-out comes out sorted.
+    m_fanoutBegin.assign(count + 1, 0);
+
+    for (int element = 0; element < count; ++element) {
+        if (m_types.at(element) == LogicType::None) {
+            continue;
+        }
+
+        for (int index = m_faninBegin.at(element); index < m_faninBegin.at(element + 1); ++index) {
+            if (const int producer = m_faninElement.at(index); producer >= 0) {
+                ++m_fanoutBegin[producer + 1];
+            }
+        }
+    }
+
+    std::partial_sum(m_fanoutBegin.cbegin(), m_fanoutBegin.cend(), m_fanoutBegin.begin());
+    m_fanout.resize(m_fanoutBegin.back());
+    std::vector<int> fanoutEnd(m_fanoutBegin.cbegin(), m_fanoutBegin.cend() - 1);
+
+    for (int element = 0; element < count; ++element) {
+        if (m_types.at(element) == LogicType::None) {
+            continue;
+        }
+
+        for (int index = m_faninBegin.at(element); index < m_faninBegin.at(element + 1); ++index) {
+            if (const int producer = m_faninElement.at(index); producer >= 0) {
+                m_fanout[fanoutEnd[producer]++] = element;
+            }
+        }
+    }
+
+    // An element reading several slots of the same producer is only kept once in its fan-out.
+    int fanoutSize = 0;
+
+    for (int element = 0; element < count; ++element) {
+        const int begin = m_fanoutBegin.at(element);
+        const int end = m_fanoutBegin.at(element + 1);
+        m_fanoutBegin[element] = fanoutSize;
+
+        for (int index = begin; index < end; ++index) {
+            if ((fanoutSize == m_fanoutBegin.at(element)) || (m_fanout.at(fanoutSize - 1) != m_fanout.at(index))) {
+                m_fanout[fanoutSize++] = m_fanout.at(index);
+            }
+        }
+
+        // A successor that comes earlier in levelized order closes a feedback loop.
+        if ((fanoutSize > m_fanoutBegin.at(element)) && (m_fanout.at(m_fanoutBegin.at(element)) <= element)) {
+            m_combinational = false;
+        }
+    }
+
+    m_fanoutBegin[count] = fanoutSize;
+    m_fanout.resize(fanoutSize);
+
+    m_values.assign((m_slotCount + externalValues.size() + 63) / 64, 0);
+
+    for (int element = 0; element < count; ++element) {
+        if (aliased.at(element)) {
+            continue;
+        }
+
+        for (int slot = m_outputBegin.at(element); slot < m_outputEnd.at(element); ++slot) {
+            setValue(slot, m_logic.at(element)->outputValue(slot - m_outputBegin.at(element)));
+        }
+    }
+
+    for (int index = 0; index < externalValues.size(); ++index) {
+        setValue(m_slotCount + index, externalValues.at(index));
+    }
+
+    // Aliased elements show the value of their slot from the start, as the element owning it may not change.
+    for (int element = 0; element < count; ++element) {
+        if (aliased.at(element)) {
+            writeBack(element);
+        }
+    }
+
+    m_state.assign(count, 0);
+
+    for (int element = 0; element < count; ++element) {
+        switch (m_types.at(element)) {
+        case LogicType::DFlipFlop:
+        case LogicType::TFlipFlop:  m_state[element] = LastValue;      break;
+        case LogicType::JKFlipFlop: m_state[element] = LastJ | LastK;  break;
+        default:                                                       break;
+        }
+
+        switch (m_types.at(element)) {
+        case LogicType::Custom:
+        case LogicType::DFlipFlop:
+        case LogicType::DLatch:
+        case LogicType::JKFlipFlop:
+        case LogicType::SRFlipFlop:
+        case LogicType::TFlipFlop:
+            m_combinational = false;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    m_delay.reserve(count);
+
+    for (int element = 0; element < count; ++element) {
+        const int delay = m_logic.at(element)->delay();
+        m_delay.push_back((delay >= 0) ? delay : defaultDelay(m_types.at(element)));
+
+        // A loop of elements without delay would never let the simulated time move on.
+        if ((m_delay.back() == 0) && (m_component.at(element) != -1)) {
+            m_delay.back() = 1;
+        }
+
+        // Changes are scheduled as a single word, so wider elements switch at once.
+        if (m_outputEnd.at(element) - m_outputBegin.at(element) > 64) {
+            m_delay.back() = 0;
+        }
+    }
+
+    m_changed.assign(count, 0);
+    m_deferred.assign(count, 0);
+    m_scheduled.assign(count, 0);
+
+    // Placeholders and the elements left out by the optimizations are never evaluated.
+    for (int element = 0; element < count; ++element) {
+        if (m_types.at(element) != LogicType::None) {
+            schedule(element);
+        }
+    }
+
+    // Splits each level into chunks of whole words for the thread pool.
+    m_levelChunkBegin.reserve(m_levelBegin.size());
+
+    for (size_t level = 0; level + 1 < m_levelBegin.size(); ++level) {
+        m_levelChunkBegin.push_back(static_cast<int>(m_chunkBegin.size()));
+        m_chunkBegin.push_back(m_levelBegin.at(level));
+
+        for (int element = m_levelBegin.at(level) + 1; element < m_levelBegin.at(level + 1); ++element) {
+            // Aliased elements point to slots elsewhere, so they do not tell where a word starts.
+            if ((element - m_chunkBegin.back() >= parallelChunkSize) && (m_types.at(element) != LogicType::None) && ((m_outputBegin.at(element) & 63) == 0)) {
+                m_chunkBegin.push_back(element);
+            }
+        }
+    }
+
+    m_levelChunkBegin.push_back(static_cast<int>(m_chunkBegin.size()));
+    m_chunkBegin.push_back(count);
+    m_chunkEvaluations.assign(m_chunkBegin.size() - 1, 0);
+
+    setParallel(count >= parallelThreshold);
+}
+
+std::vector<bool> Netlist::optimize(const int optimizations, QVector<bool> &externalValues)
+{
+    const int count = elementCount();
+    std::vector<bool> aliased(count, false);
+
+    if (optimizations == 0) {
+        return aliased;
+    }
+
+    // Element writing each slot, and the slot each one is read from once the element writing it is aliased.
+    std::vector<int> owner(m_slotCount, -1);
+    std::vector<int> redirect(m_slotCount);
+    std::iota(redirect.begin(), redirect.end(), 0);
+
+    for (int element = 0; element < count; ++element) {
+        std::fill(owner.begin() + m_outputBegin.at(element), owner.begin() + m_outputEnd.at(element), element);
+    }
+
+    // Slots after the element outputs are constants.
+    const auto constantValue = [&](const int slot) {
+        return (slot >= m_slotCount) ? static_cast<int>(externalValues.at(slot - m_slotCount)) : -1;
+    };
+
+    const auto constantSlot = [&](const bool value) {
+        int index = externalValues.indexOf(value);
+
+        if (index < 0) {
+            index = externalValues.size();
+            externalValues.append(value);
+        }
+
+        return m_slotCount + index;
+    };
+
+    const auto alias = [&](const int element, const int slot) {
+        redirect[m_outputBegin.at(element)] = slot;
+        m_outputBegin[element] = slot;
+        m_outputEnd[element] = slot + 1;
+        m_types[element] = LogicType::None;
+        aliased[element] = true;
+    };
+
+    std::vector<int> inputs;
+
+    // Predecessors come first in levelized order, so the slots an element reads are already final. Feedback loops,
+    // whose elements read later ones, are left as they are.
+    for (int element = 0; element < count; ++element) {
+        const int begin = m_faninBegin.at(element);
+        const int end = m_faninBegin.at(element + 1);
+
+        for (int index = begin; index < end; ++index) {
+            if (const int slot = m_fanin.at(index); slot < m_slotCount) {
+                m_fanin[index] = redirect.at(slot);
+                m_faninElement[index] = (redirect.at(slot) < m_slotCount) ? owner.at(redirect.at(slot)) : -1;
+            }
+        }
+
+        const LogicType type = m_types.at(element);
+
+        if ((m_component.at(element) != -1) || (type == LogicType::None) || (m_outputEnd.at(element) - m_outputBegin.at(element) != 1)) {
+            continue;
+        }
+
+        if (optimizations & FoldConstants) {
+            inputs.clear();
+
+            for (int index = begin; index < end; ++index) {
+                inputs.push_back(constantValue(m_fanin.at(index)));
+            }
+
+            if (const int value = constantOutput(type, inputs); value >= 0) {
+                alias(element, constantSlot(value));
+                continue;
+            }
+        }
+
+        if ((optimizations & AliasNodes) && (type == LogicType::Node) && (m_logic.at(element)->delay() <= 0)) {
+            alias(element, m_fanin.at(begin));
+            continue;
+        }
+
+        if ((optimizations & RemoveInverterPairs) && (type == LogicType::Not) && (m_fanin.at(begin) < m_slotCount)) {
+            const int first = owner.at(m_fanin.at(begin));
+
+            if (m_types.at(first) == LogicType::Not) {
+                alias(element, m_fanin.at(m_faninBegin.at(first)));
+            }
+        }
+    }
+
+    if (optimizations & RemoveDeadLogic) {
+        // Outputs and custom elements are what a circuit is observed by; inputs are kept so they can still be set.
+        std::vector<bool> live(count, false);
+        std::vector<int> pending;
+
+        for (int element = 0; element < count; ++element) {
+            switch (m_types.at(element)) {
+            case LogicType::Custom:
+            case LogicType::Output:
+                pending.push_back(element);
+                [[fallthrough]];
+
+            case LogicType::Input:
+                live[element] = true;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        while (!pending.empty()) {
+            const int element = pending.back();
+            pending.pop_back();
+
+            for (int index = m_faninBegin.at(element); index < m_faninBegin.at(element + 1); ++index) {
+                if (const int producer = m_faninElement.at(index); (producer >= 0) && !live.at(producer)) {
+                    live[producer] = true;
+                    pending.push_back(producer);
+                }
+            }
+        }
+
+        for (int element = 0; element < count; ++element) {
+            if (!live.at(element)) {
+                m_types[element] = LogicType::None;
+            }
+        }
+    }
+
+    // Aliases of element slots are written back with the element owning them, aliases of constants only once.
+    for (int element = 0; element < count; ++element) {
+        if (aliased.at(element) && (m_outputBegin.at(element) < m_slotCount)) {
+            ++m_aliasBegin[owner.at(m_outputBegin.at(element)) + 1];
+        }
+    }
+
+    std::partial_sum(m_aliasBegin.cbegin(), m_aliasBegin.cend(), m_aliasBegin.begin());
+    m_aliases.resize(m_aliasBegin.back());
+    std::vector<int> aliasEnd(m_aliasBegin.cbegin(), m_aliasBegin.cend() - 1);
+
+    for (int element = 0; element < count; ++element) {
+        if (aliased.at(element) && (m_outputBegin.at(element) < m_slotCount)) {
+            m_aliases[aliasEnd[owner.at(m_outputBegin.at(element))]++] = element;
+        }
+    }
+
+    return aliased;
+}
+
+void Netlist::levelize(QVector<std::shared_ptr<LogicElement>> &logicElms)
+{
+    QVector<LogicElement *> pending;
+
+    for (const auto &logic : qAsConst(logicElms)) {
+        if (logic->priority() == -1) {
+            pending.append(logic.get());
+        }
+    }
+
+    const Levelizer<LogicElement *> levelizer(
+        pending,
+        [](const LogicElement *logic) -> const QVarLengthArray<LogicElement *, 4> & { return logic->successors(); },
+        [](const LogicElement *logic) { return logic->priority(); });
+
+    for (auto *logic : qAsConst(pending)) {
+        logic->setPriority(levelizer.priority(logic), levelizer.component(logic));
+    }
+
+    // A stable sort keeps the elements of a feedback loop in the same order on every run.
+    std::stable_sort(logicElms.begin(), logicElms.end(), [](const auto &logic1, const auto &logic2) {
+        return *logic1 > *logic2;
+    });
+
+    for (int index = 0; index < logicElms.size(); ++index) {
+        logicElms.at(index)->setSortIndex(index);
+    }
+
+    for (const auto &logic : qAsConst(logicElms)) {
+        logic->validate();
+    }
+}
+
+int Netlist::elementCount() const
+{
+    return static_cast<int>(m_logic.size());
+}
+
+bool Netlist::isCombinational() const
+{
+    return m_combinational;
+}
+
+bool Netlist::isParallel() const
+{
+    return m_parallel;
+}
+
+void Netlist::setParallel(const bool parallel)
+{
+    m_parallel = parallel && !m_hasFeedback && !m_hasCustom && (ThreadPool::instance().threadCount() > 1);
+}
+
+bool Netlist::isNative() const
+{
+    return (m_native != nullptr);
+}
+
+void Netlist::setNative(const bool native)
+{
+    m_native.reset();
+    m_unsettled = false;
+
+    if (native && !m_hasCustom) {
+        m_native = NativeCode::load(NativeCode::generate(*this));
+    }
+}
+
+int Netlist::inputSlot(const LogicElement *logic, const int port) const
+{
+    return m_fanin.at(m_faninBegin.at(logic->sortIndex()) + port);
+}
+
+const std::vector<quint64> &Netlist::values() const
+{
+    return m_values;
+}
+
+int Netlist::slotCount() const
+{
+    return m_slotCount;
+}
+
+int Netlist::outputSlot(const LogicElement *logic, const int port) const
+{
+    return m_outputBegin.at(logic->sortIndex()) + port;
+}
+
+void Netlist::takeState(const Netlist &previous)
+{
+    // Kept elements carry their new index as sort index, removed ones are not found at theirs.
+    for (int element = 0; element < previous.elementCount(); ++element) {
+        const auto *logic = previous.m_logic.at(element);
+        const int index = logic->sortIndex();
+
+        if ((index >= 0) && (index < elementCount()) && (m_logic.at(index) == logic)) {
+            m_state[index] = previous.m_state.at(element);
+        }
+    }
+}
+
+void Netlist::loadOutputs(const LogicElement *logic)
+{
+    const int element = logic->sortIndex();
+    bool changed = false;
+
+    for (int slot = m_outputBegin.at(element); slot < m_outputEnd.at(element); ++slot) {
+        changed |= setValue(slot, logic->outputValue(slot - m_outputBegin.at(element)));
+    }
+
+    if (changed) {
+        writeBackAliases(element);
+        scheduleSuccessors(element);
+
+        if (m_history) {
+            m_history->logInput(m_cycle, element, outputWord(element));
+        }
+    }
+
+    if (m_timed) {
+        m_pending[element] = outputWord(element);
+    }
+}
+
+void Netlist::loadWord(const int element, const quint64 value)
+{
+    if (setWord(m_outputBegin[element], m_outputEnd[element] - m_outputBegin[element], value)) {
+        scheduleSuccessors(element);
+    }
+}
+
+quint64 Netlist::cycle() const
+{
+    return m_cycle;
+}
+
+quint64 Netlist::updateCount() const
+{
+    return m_updateCount;
+}
+
+quint64 Netlist::evaluationCount() const
+{
+    return m_evaluationCount;
+}
+
+void Netlist::setHistory(const qsizetype memoryLimit, const int interval)
+{
+    m_history.reset();
+
+    if ((memoryLimit <= 0) || m_hasCustom) {
+        return;
+    }
+
+    m_history = std::make_unique<StateHistory>(memoryLimit);
+    m_checkpointInterval = qMax(interval, 1);
+    m_nextCheckpoint = m_cycle;
+
+    if (!m_timed && isStable()) {
+        checkpoint();
+    }
+}
+
+void Netlist::setTrace(const std::shared_ptr<VcdWriter> &trace)
+{
+    m_trace = trace;
+}
+
+quint64 Netlist::firstCycle() const
+{
+    return (m_history && !m_history->isEmpty()) ? m_history->firstCycle() : m_cycle;
+}
+
+void Netlist::checkpoint()
+{
+    m_history->checkpoint(m_cycle, saveState());
+    m_nextCheckpoint = m_cycle + static_cast<quint64>(m_checkpointInterval);
+}
+
+std::vector<quint64> Netlist::saveState() const
+{
+    std::vector<quint64> state(m_values);
+    state.resize(m_values.size() + (m_state.size() + 7) / 8, 0);
+
+    for (size_t element = 0; element < m_state.size(); ++element) {
+        state[m_values.size() + element / 8] |= static_cast<quint64>(m_state[element]) << (8 * (element % 8));
+    }
+
+    return state;
+}
+
+void Netlist::loadState(const std::vector<quint64> &state)
+{
+    std::copy(state.cbegin(), state.cbegin() + static_cast<std::ptrdiff_t>(m_values.size()), m_values.begin());
+
+    for (size_t element = 0; element < m_state.size(); ++element) {
+        m_state[element] = static_cast<quint8>(state[m_values.size() + element / 8] >> (8 * (element % 8)));
+    }
+
+    // Checkpoints are only taken when nothing is left to evaluate.
+    while (!m_worklist.empty()) {
+        m_worklist.pop();
+    }
+
+    for (const int element : m_nextTick) {
+        m_deferred[element] = false;
+    }
+
+    m_nextTick.clear();
+    std::fill(m_scheduled.begin(), m_scheduled.end(), 0);
+    m_unsettled = false;
+}
+
+void Netlist::restoreState(const std::vector<quint64> &state)
+{
+    loadState(state);
+
+    for (int element = 0; element < elementCount(); ++element) {
+        writeBack(element);
+        schedule(element);
+    }
+}
+
+bool Netlist::rewind(const quint64 cycle)
+{
+    if (!m_history || m_history->isEmpty() || m_timed || (cycle < m_history->firstCycle()) || (cycle > m_cycle)) {
+        return false;
+    }
+
+    std::vector<quint64> state;
+    m_cycle = m_history->restore(cycle, state);
+    loadState(state);
+
+    // The logged inputs are replayed without being logged nor traced again.
+    auto history = std::move(m_history);
+    auto trace = std::move(m_trace);
+    const auto &inputs = history->inputs();
+
+    auto input = std::lower_bound(inputs.cbegin(), inputs.cend(), m_cycle, [](const StateHistory::Input &input_, const quint64 cycle_) {
+        return input_.cycle < cycle_;
+    });
+
+    while (m_cycle < cycle) {
+        for (; (input != inputs.cend()) && (input->cycle == m_cycle); ++input) {
+            loadWord(input->element, input->value);
+        }
+
+        update();
+    }
+
+    history->truncate(cycle);
+    m_history = std::move(history);
+    m_trace = std::move(trace);
+    m_nextCheckpoint = m_history->lastCycle() + static_cast<quint64>(m_checkpointInterval);
+
+    for (int element = 0; element < elementCount(); ++element) {
+        writeBack(element);
+    }
+
+    return true;
+}
+
+void Netlist::schedule(const LogicElement *logic)
+{
+    schedule(logic->sortIndex());
+}
+
+void Netlist::schedule(const int element)
+{
+    if (!m_scheduled[element]) {
+        m_scheduled[element] = true;
+        m_worklist.push(element);
+    }
+}
+
+void Netlist::scheduleFanout(const int element)
+{
+    for (int index = m_fanoutBegin[element]; index < m_fanoutBegin[element + 1]; ++index) {
+        const int successor = m_fanout[index];
+
+        if ((successor > element) || ((m_component[element] != -1) && (m_component[successor] == m_component[element]))) {
+            schedule(successor);
+        } else {
+            defer(successor);
+        }
+    }
+}
+
+void Netlist::scheduleSuccessors(const int element)
+{
+    for (int index = m_fanoutBegin[element]; index < m_fanoutBegin[element + 1]; ++index) {
+        schedule(m_fanout[index]);
+    }
+}
+
+void Netlist::defer(const int element)
+{
+    if (!m_deferred[element]) {
+        m_deferred[element] = true;
+        m_nextTick.push_back(element);
+    }
+}
+
+void Netlist::settle(const int component)
+{
+    const int begin = m_componentBegin[component];
+    const int end = m_componentEnd[component];
+
+    // Sweeps the loop in levelized order until no element of it is scheduled anymore.
+    for (int pass = 0; pass < maxFeedbackPasses; ++pass) {
+        for (int element = begin; element < end; ++element) {
+            if (!m_scheduled[element]) {
+                continue;
+            }
+
+            m_scheduled[element] = false;
+            ++m_evaluationCount;
+
+            if (evaluate(element)) {
+                writeBack(element);
+                scheduleFanout(element);
+            }
+        }
+
+        if (std::none_of(m_scheduled.cbegin() + begin, m_scheduled.cbegin() + end, [](const quint8 scheduled) { return scheduled; })) {
+            return;
+        }
+    }
+
+    for (int element = begin; element < end; ++element) {
+        if (m_scheduled[element]) {
+            m_scheduled[element] = false;
+            defer(element);
+        }
+    }
+}
+
+void Netlist::update()
+{
+    if (m_timed) {
+        advance(m_time + 1);
+    } else if (m_native) {
+        updateNative();
+    } else if (m_parallel) {
+        updateParallel();
+    } else {
+        updateSerial();
+    }
+
+    ++m_cycle;
+    ++m_updateCount;
+
+    if (m_history && (m_cycle >= m_nextCheckpoint) && !m_timed && isStable()) {
+        checkpoint();
+    }
+
+    if (m_trace) {
+        m_trace->sample(m_timed ? m_time : m_cycle, m_values);
+    }
+}
+
+void Netlist::updateSerial()
+{
+    // Elements are popped in levelized order, so the elements outside of feedback loops are evaluated once.
+    // A feedback loop is swept as a whole until it settles; the changes of a loop that does not settle in
+    // time are deferred to the next update.
+
+    for (const int element : m_nextTick) {
+        m_deferred[element] = false;
+        schedule(element);
+    }
+
+    m_nextTick.clear();
+
+    while (!m_worklist.empty()) {
+        const int element = m_worklist.top();
+        m_worklist.pop();
+
+        // Already evaluated as part of its feedback loop.
+        if (!m_scheduled[element]) {
+            continue;
+        }
+
+        if (m_component[element] != -1) {
+            settle(m_component[element]);
+            continue;
+        }
+
+        m_scheduled[element] = false;
+        ++m_evaluationCount;
+
+        if (evaluate(element)) {
+            writeBack(element);
+            scheduleFanout(element);
+        }
+    }
+}
+
+bool Netlist::isStable() const
+{
+    return m_worklist.empty() && m_nextTick.empty() && !m_unsettled && (!m_timed || m_wheel.isEmpty());
+}
+
+int Netlist::evaluateUntilStable(const int maxIterations)
+{
+    for (int iteration = 1; iteration <= maxIterations; ++iteration) {
+        update();
+
+        if (isStable()) {
+            return iteration;
+        }
+    }
+
+    return -1;
+}
+
+int Netlist::defaultDelay(const LogicType type)
+{
+    // Roughly the delays of the CMOS gates, in which inverting gates are the fastest ones. Elements that only
+    // route wires switch instantly.
+    switch (type) {
+    case LogicType::Input:
+    case LogicType::Joiner:
+    case LogicType::Node:
+    case LogicType::None:
+    case LogicType::Output:
+    case LogicType::Splitter:
+        return 0;
+
+    case LogicType::BusNot:
+    case LogicType::Custom:
+    case LogicType::Nand:
+    case LogicType::Nor:
+    case LogicType::Not:
+        return 1;
+
+    case LogicType::And:
+    case LogicType::BusAnd:
+    case LogicType::BusMux:
+    case LogicType::BusOr:
+    case LogicType::DLatch:
+    case LogicType::Demux:
+    case LogicType::Mux:
+    case LogicType::Or:
+        return 2;
+
+    case LogicType::BusXor:
+    case LogicType::DFlipFlop:
+    case LogicType::JKFlipFlop:
+    case LogicType::SRFlipFlop:
+    case LogicType::TFlipFlop:
+    case LogicType::Xnor:
+    case LogicType::Xor:
+        return 3;
+    }
+
+    return 1;
+}
+
+bool Netlist::isTimed() const
+{
+    return m_timed;
+}
+
+quint64 Netlist::time() const
+{
+    return m_time;
+}
+
+void Netlist::setTimed(const bool timed)
+{
+    if (m_timed == timed) {
+        return;
+    }
+
+    m_timed = timed;
+    m_wheel.clear();
+
+    const int count = elementCount();
+
+    if (timed) {
+        m_pending.resize(count);
+
+        for (int element = 0; element < count; ++element) {
+            m_pending[element] = outputWord(element);
+        }
+
+        // Every element is evaluated as soon as its inputs change, so nothing waits for the next tick.
+        for (const int element : m_nextTick) {
+            m_deferred[element] = false;
+            schedule(element);
+        }
+
+        m_nextTick.clear();
+        return;
+    }
+
+    // Elements with changes still on their way are evaluated again.
+    for (int element = 0; element < count; ++element) {
+        if (m_pending[element] != outputWord(element)) {
+            schedule(element);
+        }
+    }
+
+    m_pending.clear();
+}
+
+void Netlist::advance(const quint64 time)
+{
+    std::vector<OutputEvent> due;
+
+    evaluateTimed();
+
+    while (m_wheel.takeNext(time, due)) {
+        m_time = m_wheel.time();
+
+        for (const auto &event : due) {
+            const int output = m_outputBegin[event.element];
+
+            if (setWord(output, m_outputEnd[event.element] - output, event.value)) {
+                writeBack(event.element);
+                scheduleSuccessors(event.element);
+            }
+        }
+
+        due.clear();
+        evaluateTimed();
+    }
+
+    m_time = qMax(m_time, time);
+}
+
+void Netlist::evaluateTimed()
+{
+    // Every element reads the values of the current time, and its new outputs are scheduled after its delay
+    // instead of being written. Elements without delay drive their fan-out right away, in levelized order.
+    while (!m_worklist.empty()) {
+        const int element = m_worklist.top();
+        m_worklist.pop();
+
+        if (!m_scheduled[element]) {
+            continue;
+        }
+
+        m_scheduled[element] = false;
+        ++m_evaluationCount;
+
+        if (m_delay[element] == 0) {
+            if (evaluate(element)) {
+                writeBack(element);
+                scheduleSuccessors(element);
+            }
+
+            continue;
+        }
+
+        const int output = m_outputBegin[element];
+        const int width = m_outputEnd[element] - output;
+        const quint64 current = outputWord(element);
+
+        // Memory elements go on from the outputs already on their way, as their state has seen the edge that led
+        // to them. Evaluating from the current outputs would recompute the old ones and revert the pending change.
+        setWord(output, width, m_pending[element]);
+        evaluate(element);
+
+        const quint64 next = outputWord(element);
+        setWord(output, width, current);
+
+        // Transport delay: every change is kept, so pulses shorter than the delay go through as well.
+        if (next != m_pending[element]) {
+            m_pending[element] = next;
+            m_wheel.schedule({m_time + static_cast<quint64>(m_delay[element]), element, next});
+        }
+    }
+}
+
+void Netlist::updateNative()
+{
+    // The native code sweeps every element in levelized order, so nothing stays scheduled.
+    while (!m_worklist.empty()) {
+        m_worklist.pop();
+    }
+
+    for (const int element : m_nextTick) {
+        m_deferred[element] = false;
+    }
+
+    m_nextTick.clear();
+    std::fill(m_scheduled.begin(), m_scheduled.end(), 0);
+
+    m_native->step()(m_values.data(), m_state.data(), m_changed.data());
+    m_evaluationCount += static_cast<quint64>(elementCount());
+    m_unsettled = false;
+
+    for (int element = 0; element < elementCount(); ++element) {
+        if (m_changed[element]) {
+            m_changed[element] = false;
+            m_unsettled = m_hasFeedback;
+            writeBack(element);
+        }
+    }
+}
+
+void Netlist::updateParallel()
+{
+    // The scheduled flags seed the sweep; the queue itself is not needed, as every level is visited in order.
+    while (!m_worklist.empty()) {
+        m_worklist.pop();
+    }
+
+    for (size_t level = 0; level + 1 < m_levelChunkBegin.size(); ++level) {
+        const int firstChunk = m_levelChunkBegin[level];
+        const int chunkCount = m_levelChunkBegin[level + 1] - firstChunk;
+
+        if (chunkCount == 1) {
+            evaluateChunk(firstChunk);
+        } else {
+            ThreadPool::instance().run(chunkCount, [this, firstChunk](const int chunk) {
+                evaluateChunk(firstChunk + chunk);
+            });
+        }
+
+        for (int chunk = firstChunk; chunk < firstChunk + chunkCount; ++chunk) {
+            m_evaluationCount += m_chunkEvaluations[chunk];
+        }
+    }
+}
+
+void Netlist::evaluateChunk(const int chunk)
+{
+    int evaluations = 0;
+
+    // Instead of scheduling its fan-out, which belongs to other chunks, a changed element is found by its
+    // successors, which only read the flags of previous levels.
+    for (int element = m_chunkBegin[chunk]; element < m_chunkBegin[chunk + 1]; ++element) {
+        bool dirty = m_scheduled[element];
+
+        for (int index = m_faninBegin[element]; !dirty && (index < m_faninBegin[element + 1]); ++index) {
+            const int producer = m_faninElement[index];
+            dirty = (producer >= 0) && m_changed[producer];
+        }
+
+        m_scheduled[element] = false;
+        evaluations += dirty;
+        m_changed[element] = dirty && evaluate(element);
+
+        if (m_changed[element]) {
+            writeBack(element);
+        }
+    }
+
+    m_chunkEvaluations[chunk] = evaluations;
+}
+
+void Netlist::writeBack(const int element)
+{
+    auto *logic = m_logic[element];
+
+    for (int slot = m_outputBegin[element]; slot < m_outputEnd[element]; ++slot) {
+        logic->setOutputValue(slot - m_outputBegin[element], value(slot));
+    }
+
+    writeBackAliases(element);
+}
+
+void Netlist::writeBackAliases(const int element)
+{
+    for (int index = m_aliasBegin[element]; index < m_aliasBegin[element + 1]; ++index) {
+        const int alias = m_aliases[index];
+        m_logic[alias]->setOutputValue(0, value(m_outputBegin[alias]));
+    }
+}
+
+template<typename Operation>
+bool Netlist::reduce(const int *fanin, const int faninCount, bool result) const
+{
+    for (int index = 0; index < faninCount; ++index) {
+        result = Operation()(result, value(fanin[index]));
+    }
+
+    return result;
+}
+
+template<typename Operation>
+quint64 Netlist::reduceWords(const int *fanin, const int faninCount, const int width, quint64 result) const
+{
+    for (int index = 0; index < faninCount; ++index) {
+        result = Operation()(result, word(fanin[index], width));
+    }
+
+    return result;
+}
+
+bool Netlist::evaluate(const int element)
+{
+    const int *fanin = m_fanin.data() + m_faninBegin[element];
+    const int faninCount = m_faninBegin[element + 1] - m_faninBegin[element];
+    const int output = m_outputBegin[element];
+    const int width = m_outputEnd[element] - output;
+    quint8 &state = m_state[element];
+
+    switch (m_types[element]) {
+    case LogicType::And:  return setValue(output, reduce<std::bit_and<>>(fanin, faninCount, true));
+    case LogicType::Nand: return setValue(output, !reduce<std::bit_and<>>(fanin, faninCount, true));
+    case LogicType::Or:   return setValue(output, reduce<std::bit_or<>>(fanin, faninCount, false));
+    case LogicType::Nor:  return setValue(output, !reduce<std::bit_or<>>(fanin, faninCount, false));
+    case LogicType::Xor:  return setValue(output, reduce<std::bit_xor<>>(fanin, faninCount, false));
+    case LogicType::Xnor: return setValue(output, !reduce<std::bit_xor<>>(fanin, faninCount, false));
+    case LogicType::Node: return setValue(output, value(fanin[0]));
+    case LogicType::Not:  return setValue(output, !value(fanin[0]));
+    case LogicType::Mux:  return setValue(output, value(fanin[2]) ? value(fanin[1]) : value(fanin[0]));
+
+    // Every bus of an element is as wide as its output, except the select bit of a mux and the inputs of a joiner.
+    case LogicType::BusAnd:   return setWord(output, width, reduceWords<std::bit_and<>>(fanin, faninCount, width, ~quint64(0)));
+    case LogicType::BusOr:    return setWord(output, width, reduceWords<std::bit_or<>>(fanin, faninCount, width, 0));
+    case LogicType::BusXor:   return setWord(output, width, reduceWords<std::bit_xor<>>(fanin, faninCount, width, 0));
+    case LogicType::BusNot:   return setWord(output, width, ~word(fanin[0], width));
+    case LogicType::BusMux:   return setWord(output, width, word(fanin[value(fanin[2]) ? 1 : 0], width));
+    case LogicType::Splitter: return setWord(output, width, word(fanin[0], width));
+
+    case LogicType::Joiner: {
+        quint64 bits = 0;
+
+        for (int index = 0; index < faninCount; ++index) {
+            bits |= static_cast<quint64>(value(fanin[index])) << index;
+        }
+
+        return setWord(output, width, bits);
+    }
+
+    case LogicType::Demux: {
+        const bool data = value(fanin[0]);
+        const bool choice = value(fanin[1]);
+
+        bool changed = setValue(output, data && !choice);
+        changed |= setValue(output + 1, data && choice);
+        return changed;
+    }
+
+    case LogicType::Output: {
+        // Read every input before writing, as an output may be wired back into the same element.
+        quint64 inputs = 0;
+
+        for (int index = 0; index < faninCount; ++index) {
+            inputs |= static_cast<quint64>(value(fanin[index])) << index;
+        }
+
+        bool changed = false;
+
+        for (int index = 0; index < faninCount; ++index) {
+            changed |= setValue(output + index, (inputs >> index) & 1);
+        }
+
+        return changed;
+    }
+
+    case LogicType::DLatch: {
+        if (!value(fanin[1])) {
+            return false;
+        }
+
+        const bool D = value(fanin[0]);
+
+        bool changed = setValue(output, D);
+        changed |= setValue(output + 1, !D);
+        return changed;
+    }
+
+    case LogicType::DFlipFlop: {
+        bool q0 = value(output);
+        bool q1 = value(output + 1);
+        const bool D = value(fanin[0]);
+        const bool clk = value(fanin[1]);
+        const bool prst = value(fanin[2]);
+        const bool clr = value(fanin[3]);
+
+        if (clk && !(state & LastClk)) {
+            q0 = state & LastValue;
+            q1 = !q0;
+        }
+
+        if (!prst || !clr) {
+            q0 = !prst;
+            q1 = !clr;
+        }
+
+        state = (clk ? LastClk : 0) | (D ? LastValue : 0);
+
+        bool changed = setValue(output, q0);
+        changed |= setValue(output + 1, q1);
+        return changed;
+    }
+
+    case LogicType::JKFlipFlop: {
+        bool q0 = value(output);
+        bool q1 = value(output + 1);
+        const bool j = value(fanin[0]);
+        const bool clk = value(fanin[1]);
+        const bool k = value(fanin[2]);
+        const bool prst = value(fanin[3]);
+        const bool clr = value(fanin[4]);
+
+        if (clk && !(state & LastClk)) {
+            if ((state & LastJ) && (state & LastK)) {
+                std::swap(q0, q1);
+            } else if (state & LastJ) {
+                q0 = true;
+                q1 = false;
+            } else if (state & LastK) {
+                q0 = false;
+                q1 = true;
+            }
+        }
+
+        if (!prst || !clr) {
+            q0 = !prst;
+            q1 = !clr;
+        }
+
+        state = (clk ? LastClk : 0) | (j ? LastJ : 0) | (k ? LastK : 0);
+
+        bool changed = setValue(output, q0);
+        changed |= setValue(output + 1, q1);
+        return changed;
+    }
+
+    case LogicType::SRFlipFlop: {
+        bool q0 = value(output);
+        bool q1 = value(output + 1);
+        const bool s = value(fanin[0]);
+        const bool clk = value(fanin[1]);
+        const bool r = value(fanin[2]);
+        const bool prst = value(fanin[3]);
+        const bool clr = value(fanin[4]);
+
+        if (clk && !(state & LastClk)) {
+            if (s && r) {
+                q0 = true;
+                q1 = true;
+            } else if (s != r) {
+                q0 = s;
+                q1 = r;
+            }
+        }
+
+        if (!prst || !clr) {
+            q0 = !prst;
+            q1 = !clr;
+        }
+
+        state = (clk ? LastClk : 0);
+
+        bool changed = setValue(output, q0);
+        changed |= setValue(output + 1, q1);
+        return changed;
+    }
+
+    case LogicType::TFlipFlop: {
+        bool q0 = value(output);
+        bool q1 = value(output + 1);
+        const bool T = value(fanin[0]);
+        const bool clk = value(fanin[1]);
+        const bool prst = value(fanin[2]);
+        const bool clr = value(fanin[3]);
+
+        if (clk && !(state & LastClk) && (state & LastValue)) {
+            q0 = !q0;
+            q1 = !q0;
+        }
+
+        if (!prst || !clr) {
+            q0 = !prst;
+            q1 = !clr;
+        }
+
+        state = (clk ? LastClk : 0) | (T ? LastValue : 0);
+
+        bool changed = setValue(output, q0);
+        changed |= setValue(output + 1, q1);
+        return changed;
+    }
+
+    case LogicType::Custom: {
+        auto *logic = m_logic[element];
+
+        // The outputs are copied even if the element saw no change, as in timed mode they lag behind it.
+        logic->evaluate();
+
+        bool changed = false;
+
+        for (int slot = output; slot < m_outputEnd[element]; ++slot) {
+            changed |= setValue(slot, logic->outputValue(slot - output));
+        }
+
+        return changed;
+    }
+
+    case LogicType::Input:
+    case LogicType::None:
+        return false;
+    }
+
+    return false;
+}
+
+std::vector<quint64> Netlist::lanes() const
+{
+    std::vector<quint64> lanes(m_values.size() * 64);
+
+    for (size_t slot = 0; slot < lanes.size(); ++slot) {
+        lanes[slot] = value(static_cast<int>(slot)) ? ~quint64(0) : 0;
+    }
+
+    return lanes;
+}
+
+template<typename Operation>
+quint64 Netlist::reduceLanes(const std::vector<quint64> &lanes, const int *fanin, const int faninCount, quint64 result, const int bit)
+{
+    for (int index = 0; index < faninCount; ++index) {
+        result = Operation()(result, lanes[fanin[index] + bit]);
+    }
+
+    return result;
+}
+
+void Netlist::updateLanes(std::vector<quint64> &lanes) const
+{
+    // Combinational netlists have no memory elements, so there is no state to keep.
+    std::vector<quint64> state;
+    const int count = elementCount();
+
+    for (int element = 0; element < count; ++element) {
+        evaluateLanes(element, lanes, state);
+    }
+}
+
+void Netlist::evaluateLanes(const int element, std::vector<quint64> &lanes, std::vector<quint64> &state) const
+{
+    const int *fanin = m_fanin.data() + m_faninBegin[element];
+    const int faninCount = m_faninBegin[element + 1] - m_faninBegin[element];
+    const int width = m_outputEnd[element] - m_outputBegin[element];
+    quint64 *output = lanes.data() + m_outputBegin[element];
+
+    switch (m_types[element]) {
+    case LogicType::And:  *output = reduceLanes<std::bit_and<>>(lanes, fanin, faninCount, ~quint64(0));  break;
+    case LogicType::Nand: *output = ~reduceLanes<std::bit_and<>>(lanes, fanin, faninCount, ~quint64(0)); break;
+    case LogicType::Or:   *output = reduceLanes<std::bit_or<>>(lanes, fanin, faninCount, 0);              break;
+    case LogicType::Nor:  *output = ~reduceLanes<std::bit_or<>>(lanes, fanin, faninCount, 0);             break;
+    case LogicType::Xor:  *output = reduceLanes<std::bit_xor<>>(lanes, fanin, faninCount, 0);             break;
+    case LogicType::Xnor: *output = ~reduceLanes<std::bit_xor<>>(lanes, fanin, faninCount, 0);            break;
+    case LogicType::Node: *output = lanes[fanin[0]];                                                        break;
+    case LogicType::Not:  *output = ~lanes[fanin[0]];                                                       break;
+
+    case LogicType::Mux: {
+        const quint64 choice = lanes[fanin[2]];
+        *output = (lanes[fanin[1]] & choice) | (lanes[fanin[0]] & ~choice);
+        break;
+    }
+
+    case LogicType::Demux: {
+        const quint64 data = lanes[fanin[0]];
+        const quint64 choice = lanes[fanin[1]];
+        output[0] = data & ~choice;
+        output[1] = data & choice;
+        break;
+    }
+
+    case LogicType::Joiner:
+    case LogicType::Output:
+        for (int index = 0; index < faninCount; ++index) {
+            output[index] = lanes[fanin[index]];
+        }
+        break;
+
+    case LogicType::BusAnd:
+        for (int bit = 0; bit < width; ++bit) {
+            output[bit] = reduceLanes<std::bit_and<>>(lanes, fanin, faninCount, ~quint64(0), bit);
+        }
+        break;
+
+    case LogicType::BusOr:
+        for (int bit = 0; bit < width; ++bit) {
+            output[bit] = reduceLanes<std::bit_or<>>(lanes, fanin, faninCount, 0, bit);
+        }
+        break;
+
+    case LogicType::BusXor:
+        for (int bit = 0; bit < width; ++bit) {
+            output[bit] = reduceLanes<std::bit_xor<>>(lanes, fanin, faninCount, 0, bit);
+        }
+        break;
+
+    case LogicType::BusNot:
+        for (int bit = 0; bit < width; ++bit) {
+            output[bit] = ~lanes[fanin[0] + bit];
+        }
+        break;
+
+    case LogicType::BusMux: {
+        const quint64 choice = lanes[fanin[2]];
+
+        for (int bit = 0; bit < width; ++bit) {
+            output[bit] = (lanes[fanin[1] + bit] & choice) | (lanes[fanin[0] + bit] & ~choice);
+        }
+        break;
+    }
+
+    case LogicType::Splitter:
+        for (int bit = 0; bit < width; ++bit) {
+            output[bit] = lanes[fanin[0] + bit];
+        }
+        break;
+
+    case LogicType::DLatch: {
+        const quint64 D = lanes[fanin[0]];
+        const quint64 enable = lanes[fanin[1]];
+        output[0] = (D & enable) | (output[0] & ~enable);
+        output[1] = (~D & enable) | (output[1] & ~enable);
+        break;
+    }
+
+    // The lanes of a memory element keep their last clock in its first word of state and their last inputs in the
+    // next two, as the bits of m_state do for a single machine.
+    case LogicType::DFlipFlop: {
+        quint64 *last = state.data() + 3 * element;
+        const quint64 edge = lanes[fanin[1]] & ~last[0];
+        const quint64 async = ~lanes[fanin[2]] | ~lanes[fanin[3]];
+        const quint64 q0 = (edge & last[1]) | (~edge & output[0]);
+        const quint64 q1 = (edge & ~last[1]) | (~edge & output[1]);
+
+        output[0] = (async & ~lanes[fanin[2]]) | (~async & q0);
+        output[1] = (async & ~lanes[fanin[3]]) | (~async & q1);
+        last[0] = lanes[fanin[1]];
+        last[1] = lanes[fanin[0]];
+        break;
+    }
+
+    case LogicType::JKFlipFlop: {
+        quint64 *last = state.data() + 3 * element;
+        const quint64 edge = lanes[fanin[1]] & ~last[0];
+        const quint64 toggle = edge & last[1] & last[2];
+        const quint64 set = edge & last[1] & ~last[2];
+        const quint64 reset = edge & ~last[1] & last[2];
+        const quint64 async = ~lanes[fanin[3]] | ~lanes[fanin[4]];
+        const quint64 q0 = (toggle & output[1]) | set | (~(toggle | set | reset) & output[0]);
+        const quint64 q1 = (toggle & output[0]) | reset | (~(toggle | set | reset) & output[1]);
+
+        output[0] = (async & ~lanes[fanin[3]]) | (~async & q0);
+        output[1] = (async & ~lanes[fanin[4]]) | (~async & q1);
+        last[0] = lanes[fanin[1]];
+        last[1] = lanes[fanin[0]];
+        last[2] = lanes[fanin[2]];
+        break;
+    }
+
+    case LogicType::SRFlipFlop: {
+        quint64 *last = state.data() + 3 * element;
+        const quint64 s = lanes[fanin[0]];
+        const quint64 r = lanes[fanin[2]];
+        const quint64 edge = lanes[fanin[1]] & ~last[0];
+        const quint64 load = edge & (s | r);
+        const quint64 async = ~lanes[fanin[3]] | ~lanes[fanin[4]];
+        const quint64 q0 = (load & s) | (~load & output[0]);
+        const quint64 q1 = (load & r) | (~load & output[1]);
+
+        output[0] = (async & ~lanes[fanin[3]]) | (~async & q0);
+        output[1] = (async & ~lanes[fanin[4]]) | (~async & q1);
+        last[0] = lanes[fanin[1]];
+        break;
+    }
+
+    case LogicType::TFlipFlop: {
+        quint64 *last = state.data() + 3 * element;
+        const quint64 toggle = lanes[fanin[1]] & ~last[0] & last[1];
+        const quint64 async = ~lanes[fanin[2]] | ~lanes[fanin[3]];
+        const quint64 q0 = (toggle & ~output[0]) | (~toggle & output[0]);
+        const quint64 q1 = (toggle & output[0]) | (~toggle & output[1]);
+
+        output[0] = (async & ~lanes[fanin[2]]) | (~async & q0);
+        output[1] = (async & ~lanes[fanin[3]]) | (~async & q1);
+        last[0] = lanes[fanin[1]];
+        last[1] = lanes[fanin[0]];
+        break;
+    }
+
+    default:
+        break;
+    }
+}
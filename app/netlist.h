@@ -0,0 +1,325 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "logicelement.h"
+#include "statehistory.h"
+#include "timingwheel.h"
+
+#include <QVector>
+
+#include <memory>
+#include <queue>
+#include <vector>
+
+class AndInverterGraph;
+class FaultSimulator;
+class NativeCode;
+class VcdWriter;
+
+/**
+ * @brief Compiled form of the sorted logic elements of an ElementMapping.
+ *
+ * Each element is stored as an opcode, a range of a shared fan-in array and a range of output slots, all in
+ * levelized order. Output values are bit-packed into 64-bit words and evaluated by a single switch, without
+ * virtual calls or allocations. Element indices are the sort indices of the LogicElement objects, and values
+ * are written back to those objects only when they change, so the graphic layer can keep reading them.
+ *
+ * Bus elements have a single fan-in entry per bus, pointing to its first slot. As no element straddles two
+ * words, a bus is read and written with a single shift and mask.
+ *
+ * In timed mode, each element takes its propagation delay to drive a new value: the value it computes is
+ * scheduled on a TimingWheel and only reaches its outputs, and its fan-out, once the simulated time gets there.
+ *
+ * Optimizations may leave elements out of the evaluation. An aliased element shares the output slot of the element
+ * it forwards, or a constant slot, and its logic element is written back along with that element, so the ports of
+ * every element keep showing their value.
+ */
+class Netlist
+{
+public:
+    //! Passes applied by the constructor, as flags.
+    enum Optimization : int {
+        //! Nodes without delay are aliased to the slot they read.
+        AliasNodes = 1,
+        //! Gates whose output only depends on constants, like an AND with a constant 0 input, are aliased to a constant.
+        FoldConstants = 2,
+        //! A NOT reading another NOT is aliased to the slot the first one reads, which drops both delays in timed mode.
+        RemoveInverterPairs = 4,
+        //! Elements with no path to an output nor a custom element are never evaluated, so their values go stale.
+        RemoveDeadLogic = 8,
+        //! Passes that keep every value shown by the scene and every delay of timed mode.
+        SafeOptimizations = AliasNodes | FoldConstants,
+        AllOptimizations = AliasNodes | FoldConstants | RemoveInverterPairs | RemoveDeadLogic,
+    };
+
+    explicit Netlist(const QVector<std::shared_ptr<LogicElement>> &logicElms, const int optimizations = 0);
+
+    //! Sorts the logic elements in levelized order, sets their sort indices and validates them, as required by the constructor.
+    static void levelize(QVector<std::shared_ptr<LogicElement>> &logicElms);
+
+    //! Current value of an output slot.
+    bool value(const int slot) const;
+
+    //! Current value of the bus of @p width slots starting at @p slot, the first slot in the lowest bit.
+    quint64 word(const int slot, const int width) const;
+
+    //! Mask of the lowest @p width bits of a word.
+    static quint64 widthMask(const int width);
+
+    //! Current value of every slot, 64 per word.
+    const std::vector<quint64> &values() const;
+
+    //! Whether the netlist has no memory nor feedback loops, so a single sweep in levelized order settles it.
+    bool isCombinational() const;
+
+    //! Whether update() evaluates the elements of each level on the ThreadPool.
+    bool isParallel() const;
+
+    //! Requests parallel evaluation, which is only enabled for netlists without feedback loops or custom elements
+    //! and when there is more than one hardware thread. Large netlists request it by default.
+    void setParallel(const bool parallel);
+
+    //! Whether update() runs native code compiled from the netlist, as set by setNative().
+    bool isNative() const;
+
+    //! Requests evaluation by native code, built with the system compiler or taken from the cache of previous
+    //! builds. Stays on the interpreter for netlists with custom elements, or if there is no working compiler.
+    void setNative(const bool native);
+
+    int elementCount() const;
+    int inputSlot(const LogicElement *logic, const int port) const;
+    int outputSlot(const LogicElement *logic, const int port = 0) const;
+    int slotCount() const;
+
+    //! Current value of every slot replicated to all 64 lanes of a word, to be used with updateLanes().
+    std::vector<quint64> lanes() const;
+
+    /**
+     * @brief Evaluates 64 independent input vectors at once, one per bit of each word.
+     *
+     * @p lanes holds one word per slot, as returned by lanes(), with the words of the input elements' slots
+     * already set. Only valid for combinational netlists; the netlist state itself is not changed.
+     */
+    void updateLanes(std::vector<quint64> &lanes) const;
+
+    //! Takes over the internal state of the elements kept from @p previous, the netlist this one replaces after an
+    //! edit, so their flip-flops neither lose their last inputs nor see a clock edge that did not happen.
+    void takeState(const Netlist &previous);
+
+    //! Copies the outputs of an input element to the netlist and schedules its successors if any of them changed.
+    void loadOutputs(const LogicElement *logic);
+
+    void schedule(const LogicElement *logic);
+
+    //! Evaluates every scheduled element, following changes through the fan-out of each element. Feedback loops
+    //! are evaluated until they settle, within a limit of passes. In timed mode, advances one unit of time instead.
+    void update();
+
+    //! Whether update() has nothing left to do: no element is scheduled, no feedback loop was left unsettled by
+    //! the last update and, in timed mode, no change is on its way.
+    bool isStable() const;
+
+    //! Updates until the netlist is stable, at most @p maxIterations times. Returns the number of updates, or -1
+    //! if the netlist is still not stable, as happens when it oscillates.
+    int evaluateUntilStable(const int maxIterations);
+
+    //! Propagation delay of the elements of @p type, in units of simulated time.
+    static int defaultDelay(const LogicType type);
+
+    //! Whether output changes take the propagation delay of their element, as set by setTimed().
+    bool isTimed() const;
+
+    //! Enables timed mode. Leaving it drops the changes still on their way, and the next update() settles the
+    //! netlist at once.
+    void setTimed(const bool timed);
+
+    //! Current simulated time of the timed mode.
+    quint64 time() const;
+
+    //! Applies, in order, every change due until @p time, and moves the simulated time there.
+    void advance(const quint64 time);
+
+    //! Number of updates so far.
+    quint64 cycle() const;
+
+    //! Number of updates since the netlist was built, which unlike cycle() does not go back on rewind().
+    quint64 updateCount() const;
+
+    //! Number of element evaluations since the netlist was built. A native step counts every element.
+    quint64 evaluationCount() const;
+
+    /**
+     * @brief Keeps a checkpoint of the state every @p interval cycles, and every input change in between, so the
+     * netlist can be rewound. Checkpoints are taken on cycles that leave nothing to evaluate and, when they take
+     * more than @p memoryLimit bytes, the oldest ones are dropped. A limit of zero stops keeping them.
+     *
+     * Netlists with custom elements, whose state lives in their logic elements, are not kept.
+     */
+    void setHistory(const qsizetype memoryLimit, const int interval = 1024);
+
+    //! Earliest cycle rewind() can go back to, or the current cycle if none is kept.
+    quint64 firstCycle() const;
+
+    //! Samples @p trace after every update, at the current cycle, or at the simulated time in timed mode. The
+    //! slots of its signals must already be set. Stops tracing with nullptr.
+    void setTrace(const std::shared_ptr<VcdWriter> &trace);
+
+    //! Values of every slot followed by the flip-flop states, 8 per word.
+    std::vector<quint64> saveState() const;
+
+    //! Brings the netlist back to @p state, as returned by saveState(), and writes it back to the logic elements.
+    //! Every element is scheduled, so the next update() evaluates the whole netlist as if it was just built. The
+    //! state of custom elements lives in their logic elements and is not restored.
+    void restoreState(const std::vector<quint64> &state);
+
+    //! Restores the state of the netlist at the end of @p cycle, from the latest checkpoint before it and the
+    //! inputs logged since then. Returns false if @p cycle is not kept or the netlist is in timed mode.
+    bool rewind(const quint64 cycle);
+
+private:
+    Q_DISABLE_COPY(Netlist)
+
+    friend class AndInverterGraph;
+    friend class FaultSimulator;
+    friend class NativeCode;
+
+    //! Passes over a feedback loop in a single update before the rest of its changes wait for the next one. An odd
+    //! number, so a loop that flips on every pass, like a ring of inverters, still toggles once per update.
+    static constexpr int maxFeedbackPasses = 15;
+
+    enum StateBit : quint8 { LastClk = 1, LastValue = 2, LastJ = 2, LastK = 4 };
+
+    //! New outputs of an element, due at a point of simulated time.
+    struct OutputEvent {
+        quint64 time;
+        int element;
+        quint64 value;
+    };
+
+    //! Applies @p optimizations once the fan-in is built, and returns which elements were aliased. Constant slots
+    //! the folded gates need are added to @p externalValues.
+    std::vector<bool> optimize(const int optimizations, QVector<bool> &externalValues);
+    bool evaluate(const int element);
+    //! Evaluates @p element on every lane of @p lanes, as updateLanes() does. Memory elements keep their last clock
+    //! and inputs in three words of @p state per element, which is left untouched by combinational netlists.
+    void evaluateLanes(const int element, std::vector<quint64> &lanes, std::vector<quint64> &state) const;
+    //! Outputs of an element as a single word, up to the first 64 of them.
+    quint64 outputWord(const int element) const;
+    bool setValue(const int slot, const bool value);
+    bool setWord(const int slot, const int width, const quint64 value);
+    template<typename Operation> bool reduce(const int *fanin, const int faninCount, bool result) const;
+    template<typename Operation> quint64 reduceWords(const int *fanin, const int faninCount, const int width, quint64 result) const;
+    template<typename Operation> static quint64 reduceLanes(const std::vector<quint64> &lanes, const int *fanin, const int faninCount, quint64 result, const int bit = 0);
+    void checkpoint();
+    void defer(const int element);
+    void schedule(const int element);
+    void evaluateChunk(const int chunk);
+    void evaluateTimed();
+    //! Sets the outputs of an input element to @p value, like loadOutputs().
+    void loadWord(const int element, const quint64 value);
+    void loadState(const std::vector<quint64> &state);
+    void scheduleFanout(const int element);
+    void scheduleSuccessors(const int element);
+    void settle(const int component);
+    void updateNative();
+    void updateParallel();
+    void updateSerial();
+    void writeBack(const int element);
+    //! Writes back the aliases of @p element, which an input element needs as it is loaded instead of evaluated.
+    void writeBackAliases(const int element);
+
+    std::shared_ptr<NativeCode> m_native;
+    std::unique_ptr<StateHistory> m_history;
+    std::shared_ptr<VcdWriter> m_trace;
+    TimingWheel<OutputEvent> m_wheel;
+    std::priority_queue<int, std::vector<int>, std::greater<>> m_worklist;
+    std::vector<LogicElement *> m_logic;
+    std::vector<LogicType> m_types;
+    //! Aliased elements written back with each element, as ranges of m_aliases.
+    std::vector<int> m_aliasBegin;
+    std::vector<int> m_aliases;
+    std::vector<int> m_chunkBegin;
+    //! Elements evaluated by each chunk in its last sweep, added up once its level is done.
+    std::vector<int> m_chunkEvaluations;
+    //! Feedback loop of each element, or -1, and the range of elements of each loop.
+    std::vector<int> m_component;
+    std::vector<int> m_componentBegin;
+    std::vector<int> m_componentEnd;
+    std::vector<int> m_delay;
+    std::vector<int> m_fanin;
+    std::vector<int> m_faninBegin;
+    std::vector<int> m_faninElement;
+    std::vector<int> m_fanout;
+    std::vector<int> m_fanoutBegin;
+    std::vector<int> m_levelBegin;
+    std::vector<int> m_levelChunkBegin;
+    std::vector<int> m_nextTick;
+    std::vector<int> m_outputBegin;
+    std::vector<int> m_outputEnd;
+    //! Last outputs scheduled for each element in timed mode.
+    std::vector<quint64> m_pending;
+    std::vector<quint64> m_values;
+    std::vector<quint8> m_changed;
+    std::vector<quint8> m_deferred;
+    std::vector<quint8> m_scheduled;
+    std::vector<quint8> m_state;
+    bool m_combinational = true;
+    bool m_hasCustom = false;
+    bool m_hasFeedback = false;
+    bool m_parallel = false;
+    bool m_timed = false;
+    //! Whether the last native step changed an element while the netlist has feedback loops, which the step may
+    //! have left unsettled.
+    bool m_unsettled = false;
+    int m_checkpointInterval = 1024;
+    int m_slotCount = 0;
+    quint64 m_cycle = 0;
+    quint64 m_evaluationCount = 0;
+    quint64 m_nextCheckpoint = 0;
+    quint64 m_time = 0;
+    quint64 m_updateCount = 0;
+};
+
+inline bool Netlist::value(const int slot) const
+{
+    return (m_values[slot >> 6] >> (slot & 63)) & 1;
+}
+
+inline bool Netlist::setValue(const int slot, const bool value)
+{
+    quint64 &word = m_values[slot >> 6];
+    const quint64 mask = quint64(1) << (slot & 63);
+
+    if (static_cast<bool>(word & mask) == value) {
+        return false;
+    }
+
+    word ^= mask;
+    return true;
+}
+
+inline quint64 Netlist::widthMask(const int width)
+{
+    return (width >= 64) ? ~quint64(0) : ((quint64(1) << width) - 1);
+}
+
+inline quint64 Netlist::word(const int slot, const int width) const
+{
+    return (m_values[slot >> 6] >> (slot & 63)) & widthMask(width);
+}
+
+inline quint64 Netlist::outputWord(const int element) const
+{
+    return word(m_outputBegin[element], qMin(m_outputEnd[element] - m_outputBegin[element], 64));
+}
+
+inline bool Netlist::setWord(const int slot, const int width, const quint64 value)
+{
+    quint64 &word = m_values[slot >> 6];
+    const quint64 changed = (((word >> (slot & 63)) ^ value) & widthMask(width)) << (slot & 63);
+
+    word ^= changed;
+    return (changed != 0);
+}
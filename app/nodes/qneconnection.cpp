@@ -276,7 +276,14 @@ void QNEConnection::paint(QPainter *painter, const QStyleOptionGraphicsItem *opt
         painter->restore();
     }
 
-    painter->setPen(isSelected() ? QPen(m_selectedColor, 5) : pen());
+    QPen pen_ = isSelected() ? QPen(m_selectedColor, 5) : pen();
+
+    // Buses are drawn twice as thick as single wires.
+    if (m_startPort && (m_startPort->width() > 1)) {
+        pen_.setWidthF(pen_.widthF() * 2);
+    }
+
+    painter->setPen(pen_);
     painter->drawPath(path());
 }
 
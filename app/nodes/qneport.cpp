@@ -180,7 +180,12 @@ void QNEPort::setCurrentBrush(const QBrush &currentBrush)
 
 bool QNEPort::isRequired() const
 {
-    return m_required;
+    return m_required || (width() > 1);
+}
+
+int QNEPort::width() const
+{
+    return m_graphicElement ? m_graphicElement->portWidth(this) : 1;
 }
 
 void QNEPort::setRequired(const bool required)
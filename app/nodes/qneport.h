@@ -54,6 +54,8 @@ public:
     const QList<QNEConnection *> &connections() const;
     int index() const;
     int portFlags() const;
+    //! Number of bits carried by the port, given by its element. Bus ports are always required.
+    int width() const;
     virtual bool isInput() const = 0;
     virtual bool isOutput() const = 0;
     virtual bool isValid() const = 0;
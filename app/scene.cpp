@@ -89,7 +89,7 @@ void Scene::setAutosaveRequired()
     m_autosaveRequired = true;
 }
 
-void Scene::setCircuitUpdateRequired()
+void Scene::setCircuitUpdateRequired(const NetlistDelta &delta)
 {
     // set these again to avoid having new ports showing when elements are invisible
     showWires(m_showWires);
@@ -97,7 +97,7 @@ void Scene::setCircuitUpdateRequired()
 
     update();
 
-    m_simulation.initialize();
+    m_simulation.applyDelta(delta);
 
     m_autosaveRequired = true;
 }
@@ -289,8 +289,8 @@ void Scene::makeConnection(QNEConnection *connection)
         return;
     }
 
-    /* Verifying if the connection is valid. */
-    if ((startPort->graphicElement() != endPort->graphicElement()) && !startPort->isConnected(endPort)) {
+    /* Verifying if the connection is valid. A bus only connects to a port of the same width. */
+    if ((startPort->graphicElement() != endPort->graphicElement()) && !startPort->isConnected(endPort) && (startPort->width() == endPort->width())) {
         /* Making connection. */
         connection->setStartPort(startPort);
         connection->setEndPort(endPort);
@@ -684,9 +684,9 @@ void Scene::deleteAction()
     const auto selectedItems_ = selectedItems();
     clearSelection();
 
+    // The command patches the simulation layer through its delta, whether the simulation is running or not.
     if (!selectedItems_.isEmpty()) {
         receiveCommand(new DeleteItemsCommand(selectedItems_, this));
-        m_simulation.restart();
     }
 }
 
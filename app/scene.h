@@ -51,7 +51,8 @@ public:
     void rotateRight();
     void selectAll();
     void setAutosaveRequired();
-    void setCircuitUpdateRequired();
+    //! Refreshes the scene after an edit and patches the simulation with the elements touched by @p delta.
+    void setCircuitUpdateRequired(const NetlistDelta &delta);
     void setView(GraphicsView *view);
     void showGates(const bool checked);
     void showWires(const bool checked);
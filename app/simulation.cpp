@@ -5,13 +5,22 @@
 
 #include "clock.h"
 #include "common.h"
+#include "elementfactory.h"
 #include "elementmapping.h"
 #include "graphicelement.h"
 #include "ic.h"
+#include "logicarena.h"
+#include "netlist.h"
 #include "qneconnection.h"
 #include "scene.h"
+#include "settings.h"
+#include "vcdwriter.h"
 
 #include <QGraphicsView>
+#include <QHash>
+#include <QSet>
+
+#include <algorithm>
 
 using namespace std::chrono_literals;
 
@@ -21,6 +30,9 @@ Simulation::Simulation(Scene *scene)
 {
     m_timer.setInterval(1ms);
     connect(&m_timer, &QTimer::timeout, this, &Simulation::update);
+
+    m_refreshTimer.setInterval(16ms);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &Simulation::refresh);
 }
 
 void Simulation::update()
@@ -30,61 +42,252 @@ void Simulation::update()
     }
 
     if (m_timer.isActive()) {
-        for (auto *clock : qAsConst(m_clocks)) {
-            clock->updateClock();
+        // Remote devices talk to their graphic element, so they keep running on this thread.
+        if (!m_thread && m_remoteDevices.isEmpty()) {
+            startThread();
         }
     }
 
+    if (m_thread) {
+        sendInputs();
+        return;
+    }
+
+    auto *netlist = m_elmMapping->netlist();
+    const auto start = std::chrono::steady_clock::now();
+    const quint64 updates = netlist->updateCount();
+    const quint64 evaluations = netlist->evaluationCount();
+
+    loadInputs(netlist);
+    netlist->update();
+
+    if (m_timer.isActive()) {
+        m_clockQueue.run(netlist, std::chrono::duration_cast<std::chrono::microseconds>(m_timer.intervalAsDuration()));
+    }
+
+    m_counters.addEvaluation(netlist->updateCount() - updates, netlist->evaluationCount() - evaluations, std::chrono::steady_clock::now() - start);
+
+    // While running, the ports are repainted by refresh() once per frame.
+    if (!m_timer.isActive()) {
+        updatePorts(netlist->values());
+    }
+}
+
+bool Simulation::evaluateUntilStable(const int maxIterations)
+{
+    if (!m_initialized && !initialize()) {
+        return true;
+    }
+
+    // Runs on this thread, so the netlist must not be running on the simulation thread.
+    stopThread();
+
+    auto *netlist = m_elmMapping->netlist();
+    const auto start = std::chrono::steady_clock::now();
+    const quint64 updates = netlist->updateCount();
+    const quint64 evaluations = netlist->evaluationCount();
+
+    loadInputs(netlist);
+    const int iterations = netlist->evaluateUntilStable(maxIterations);
+    m_counters.addEvaluation(netlist->updateCount() - updates, netlist->evaluationCount() - evaluations, std::chrono::steady_clock::now() - start);
+    updatePorts(netlist->values());
+
+    if (iterations < 0) {
+        qCDebug(zero) << tr("Circuit did not settle after ") << maxIterations << tr(" updates, it may oscillate.");
+        return false;
+    }
+
+    qCDebug(four) << tr("Circuit settled after ") << iterations << tr(" updates.");
+    return true;
+}
+
+void Simulation::loadInputs(Netlist *netlist)
+{
     for (auto *inputElm : qAsConst(m_inputs)) {
-        inputElm->updateOutputs();
+        if (inputElm->updateOutputs()) {
+            netlist->loadOutputs(inputElm->logic());
+        }
     }
 
-    for (auto logic : m_elmMapping->logicElms()) {
-        logic->updateLogic();
+    // While stopped, the clocks are set by hand, as the waveform editor does.
+    if (!m_timer.isActive()) {
+        for (auto *clock : qAsConst(m_clocks)) {
+            if (clock->updateOutputs()) {
+                netlist->loadOutputs(clock->logic());
+            }
+        }
+    }
+
+    for (auto *remoteDevice : qAsConst(m_remoteDevices)) {
+        netlist->schedule(remoteDevice->logic());
+    }
+}
+
+void Simulation::mapPorts()
+{
+    auto *netlist = m_elmMapping->netlist();
+
+    m_clockSlots.clear();
+    m_portSlots.clear();
+    m_shownValues.clear();
+
+    for (auto *clock : qAsConst(m_clocks)) {
+        m_clockSlots.append(netlist->outputSlot(clock->logic()));
     }
 
     for (auto *connection : qAsConst(m_connections)) {
-        updatePort(connection->startPort());
+        auto *port = connection->startPort();
+
+        if (!port) {
+            continue;
+        }
+
+        auto *elm = port->graphicElement();
+        auto *logic = elm->logic();
+        int logicPort = port->index();
+
+        // IC ports are driven by the node of their inner output.
+        if (elm->elementType() == ElementType::IC) {
+            logic = qobject_cast<IC *>(elm)->outputLogic(port->index());
+            logicPort = 0;
+        }
+
+        m_portSlots.append({logic->isValid() ? netlist->outputSlot(logic, logicPort) : -1, port, nullptr, port->width()});
     }
 
     for (auto *outputElm : qAsConst(m_outputs)) {
+        auto *logic = outputElm->logic();
+
         for (auto *inputPort : outputElm->inputs()) {
-            updatePort(inputPort);
+            m_portSlots.append({logic->isValid() ? netlist->inputSlot(logic, inputPort->index()) : -1, inputPort, outputElm});
         }
     }
+
+    std::stable_sort(m_portSlots.begin(), m_portSlots.end(), [](const auto &portSlot1, const auto &portSlot2) {
+        return portSlot1.slot < portSlot2.slot;
+    });
 }
 
-void Simulation::updatePort(QNEOutputPort *port)
+void Simulation::updatePorts(const std::vector<quint64> &values)
 {
-    if (!port) {
+    // Only the ports of the slots that changed since the last repaint are touched, and each output element is
+    // refreshed once. Right after mapping the ports, every port is painted.
+    const auto start = std::chrono::steady_clock::now();
+    QSet<GraphicElement *> outputElms;
+    quint64 portUpdates = 0;
+
+    const auto setStatus = [&outputElms, &portUpdates](const PortSlot &portSlot, const Status status) {
+        portSlot.port->setStatus(status);
+        ++portUpdates;
+
+        if (portSlot.outputElm) {
+            outputElms.insert(portSlot.outputElm);
+        }
+    };
+
+    const bool paintAll = (m_shownValues.size() != values.size());
+
+    if (paintAll) {
+        for (const auto &portSlot : qAsConst(m_portSlots)) {
+            if (portSlot.slot >= 0) {
+                break;
+            }
+
+            setStatus(portSlot, Status::Invalid);
+        }
+    }
+
+    auto portSlot = std::lower_bound(m_portSlots.cbegin(), m_portSlots.cend(), 0, [](const auto &portSlot_, const int slot) {
+        return portSlot_.slot < slot;
+    });
+
+    for (; portSlot != m_portSlots.cend(); ++portSlot) {
+        const int word = portSlot->slot >> 6;
+        const int shift = portSlot->slot & 63;
+        const quint64 mask = Netlist::widthMask(portSlot->width);
+        const quint64 changed = paintAll ? ~quint64(0) : (values[word] ^ m_shownValues[word]);
+
+        if ((changed >> shift) & mask) {
+            setStatus(*portSlot, static_cast<Status>(((values[word] >> shift) & mask) != 0));
+        }
+    }
+
+    m_shownValues = values;
+
+    for (int index = 0; index < m_clocks.size(); ++index) {
+        const bool value = SimulationThread::value(values, m_clockSlots.at(index));
+
+        if (m_clocks.at(index)->isOn() != value) {
+            m_clocks.at(index)->setOn(value);
+        }
+    }
+
+    for (auto *outputElm : qAsConst(outputElms)) {
+        outputElm->refresh();
+    }
+
+    m_counters.addPropagation(portUpdates, std::chrono::steady_clock::now() - start);
+}
+
+void Simulation::refresh()
+{
+    if (!m_initialized) {
         return;
     }
 
-    auto *elm = port->graphicElement();
+    const auto start = std::chrono::steady_clock::now();
 
-    if (elm->elementType() == ElementType::IC) {
-        auto *logic = qobject_cast<IC *>(elm)->outputLogic(port->index());
-        port->setStatus(logic->isValid() ? static_cast<Status>(logic->outputValue(0)) : Status::Invalid);
-    } else {
-        auto *logic = elm->logic();
-        port->setStatus(logic->isValid() ? static_cast<Status>(logic->outputValue(port->index())) : Status::Invalid);
+    if (!m_thread) {
+        updatePorts(m_elmMapping->netlist()->values());
+    } else if (const auto *snapshot = m_thread->snapshot()) {
+        updatePorts(*snapshot);
     }
+
+    m_counters.addRefresh(std::chrono::steady_clock::now() - start);
 }
 
-void Simulation::updatePort(QNEInputPort *port)
+void Simulation::sendInputs()
 {
-    auto *elm = port->graphicElement();
-    auto *logic = elm->logic();
+    int index = 0;
 
-    port->setStatus(logic->isValid() ? static_cast<Status>(logic->inputValue(port->index())) : Status::Invalid);
+    for (auto *inputElm : qAsConst(m_inputs)) {
+        for (int port = 0; port < inputElm->outputSize(); ++port, ++index) {
+            auto &input = m_sentInputs[index];
+            const bool value = inputElm->isOn(port);
 
-    if (elm->elementGroup() == ElementGroup::Output) {
-        elm->refresh();
+            // A change that does not fit in the queue is sent again on the next tick.
+            if ((input.value != value) && m_thread->pushInput({input.logic, port, value})) {
+                input.value = value;
+            }
+        }
+    }
+}
+
+void Simulation::startThread()
+{
+    qCDebug(two) << tr("Starting simulation thread.");
+    m_sentInputs.clear();
+
+    for (auto *inputElm : qAsConst(m_inputs)) {
+        for (int port = 0; port < inputElm->outputSize(); ++port) {
+            m_sentInputs.append({inputElm->logic(), port, inputElm->logic()->outputValue(port)});
+        }
+    }
+
+    m_thread = std::make_unique<SimulationThread>(m_elmMapping->netlist(), &m_clockQueue, &m_counters, std::chrono::duration_cast<std::chrono::microseconds>(m_timer.intervalAsDuration()));
+}
+
+void Simulation::stopThread()
+{
+    if (m_thread) {
+        qCDebug(two) << tr("Stopping simulation thread.");
+        m_thread.reset();
     }
 }
 
 void Simulation::restart()
 {
+    stopThread();
     m_initialized = false;
 }
 
@@ -93,9 +296,43 @@ bool Simulation::isRunning()
     return m_timer.isActive();
 }
 
+SimulationCounters &Simulation::counters()
+{
+    return m_counters;
+}
+
+double Simulation::realTimeFactor() const
+{
+    return m_clockQueue.realTimeFactor();
+}
+
+void Simulation::setRealTimeFactor(const double factor)
+{
+    // The queue belongs to the simulation thread while it runs, which is started again on the next tick.
+    stopThread();
+    m_clockQueue.setRealTimeFactor(factor);
+}
+
+Netlist *Simulation::netlist()
+{
+    if (!m_initialized && !initialize()) {
+        return nullptr;
+    }
+
+    return m_elmMapping->netlist();
+}
+
 void Simulation::stop()
 {
     m_timer.stop();
+    m_refreshTimer.stop();
+    stopThread();
+
+    // The clocks are set by hand from now on, so they must show their last value.
+    if (m_initialized) {
+        updatePorts(m_elmMapping->netlist()->values());
+    }
+
     m_scene->mute(true);
 }
 
@@ -107,15 +344,227 @@ void Simulation::start()
         initialize();
     }
 
+    m_clockQueue.rebase();
     m_timer.start();
+    m_refreshTimer.start();
     m_scene->mute(false);
     qCDebug(zero) << tr("Simulation started.");
 }
 
 bool Simulation::initialize()
+{
+    stopThread();
+
+    const auto elements = collectElements();
+
+    if (elements.empty()) {
+        // Nothing is left to simulate, and the ports of the previous layer may be gone.
+        m_portSlots.clear();
+        m_initialized = false;
+        return false;
+    }
+
+    for (auto *clock : qAsConst(m_clocks)) {
+        clock->resetClock();
+    }
+
+    qCDebug(two) << tr("Recreating mapping for simulation.");
+    const auto start = std::chrono::steady_clock::now();
+    m_elmMapping = std::make_unique<ElementMapping>(elements, LogicArena::create());
+    const auto mapped = std::chrono::steady_clock::now();
+
+    qCDebug(two) << tr("Sorting.");
+    m_elmMapping->sort();
+    m_counters.addInitialization(mapped - start, std::chrono::steady_clock::now() - mapped);
+    mapPorts();
+    loadClocks();
+    keepHistory();
+
+    m_initialized = true;
+    attachTrace();
+
+    qCDebug(zero) << tr("Finished simulation layer.");
+    return true;
+}
+
+void Simulation::applyDelta(const NetlistDelta &delta)
+{
+    if (!m_initialized) {
+        initialize();
+        return;
+    }
+
+    stopThread();
+
+    const auto elements = collectElements();
+
+    if (elements.empty() || !m_elmMapping->update(delta, elements)) {
+        qCDebug(two) << tr("Edit cannot patch the simulation layer, generating it again.");
+        initialize();
+        return;
+    }
+
+    mapPorts();
+    loadClocks();
+    keepHistory();
+    attachTrace();
+    qCDebug(zero) << tr("Updated simulation layer.");
+}
+
+void Simulation::keepHistory()
+{
+    const qsizetype megabytes = Settings::contains("rewindMemory") ? Settings::value("rewindMemory").toLongLong() : 64;
+    m_elmMapping->netlist()->setHistory(megabytes * 1024 * 1024);
+}
+
+bool Simulation::isTracing() const
+{
+    return (m_trace != nullptr);
+}
+
+void Simulation::startTrace(const QString &fileName, const QVector<GraphicElement *> &elements)
+{
+    stopTrace();
+
+    QVector<VcdWriter::Signal> signalList;
+    QVector<TracePort> tracePorts;
+    QHash<QString, int> nameCount;
+
+    for (auto *elm : elements) {
+        // Output elements, like LEDs, are traced by their inputs.
+        const bool isInput = (elm->outputSize() == 0);
+        const int portCount = isInput ? elm->inputSize() : elm->outputSize();
+        QString name = elm->label().isEmpty() ? ElementFactory::translatedName(elm->elementType()) : elm->label();
+
+        if (const int count = nameCount[name]++; count > 0) {
+            name += "_" + QString::number(count);
+        }
+
+        for (int port = 0; port < portCount; ++port) {
+            const auto *qnePort = isInput ? static_cast<QNEPort *>(elm->inputPort(port)) : static_cast<QNEPort *>(elm->outputPort(port));
+            signalList.append({(portCount > 1) ? name + "_" + QString::number(port) : name, qnePort->width()});
+            tracePorts.append({elm, port, isInput});
+        }
+    }
+
+    m_trace = std::make_shared<VcdWriter>(fileName, signalList);
+    m_tracePorts = tracePorts;
+    qCDebug(zero) << tr("Tracing ") << signalList.size() << tr(" signals to ") << fileName;
+
+    if (m_initialized) {
+        // The simulation thread is the one sampling the trace.
+        stopThread();
+        attachTrace();
+    }
+}
+
+void Simulation::stopTrace()
+{
+    if (!m_trace) {
+        return;
+    }
+
+    stopThread();
+
+    if (m_initialized) {
+        m_elmMapping->netlist()->setTrace(nullptr);
+    }
+
+    m_trace.reset();
+    m_tracePorts.clear();
+    qCDebug(zero) << tr("Trace stopped.");
+}
+
+void Simulation::attachTrace()
+{
+    if (!m_trace) {
+        return;
+    }
+
+    auto *netlist = m_elmMapping->netlist();
+    QVector<int> firstSlots;
+
+    for (const auto &tracePort : qAsConst(m_tracePorts)) {
+        auto *elm = tracePort.elm.data();
+
+        if (!elm || (elm->scene() != m_scene)) {
+            firstSlots.append(-1);
+            continue;
+        }
+
+        auto *logic = elm->logic();
+        int logicPort = tracePort.port;
+
+        if (!tracePort.isInput && (elm->elementType() == ElementType::IC)) {
+            logic = qobject_cast<IC *>(elm)->outputLogic(tracePort.port);
+            logicPort = 0;
+        }
+
+        if (!logic->isValid()) {
+            firstSlots.append(-1);
+        } else {
+            firstSlots.append(tracePort.isInput ? netlist->inputSlot(logic, logicPort) : netlist->outputSlot(logic, logicPort));
+        }
+    }
+
+    m_trace->setSlots(firstSlots);
+    netlist->setTrace(m_trace);
+}
+
+bool Simulation::rewind(const quint64 cycle)
+{
+    if (!m_initialized) {
+        return false;
+    }
+
+    // Runs on this thread, so the netlist must not be running on the simulation thread.
+    stopThread();
+
+    auto *netlist = m_elmMapping->netlist();
+
+    if (!netlist->rewind(cycle)) {
+        return false;
+    }
+
+    qCDebug(zero) << tr("Rewound to cycle ") << cycle << tr(".");
+
+    // The input elements follow their logic, so the next update does not load their old values again.
+    for (auto *inputElm : qAsConst(m_inputs)) {
+        for (int port = 0; port < inputElm->outputSize(); ++port) {
+            const bool value = inputElm->logic()->outputValue(port);
+
+            if ((inputElm->isOn(port) != value) && (value || (inputElm->outputSize() == 1))) {
+                inputElm->setOn(value, port);
+            }
+        }
+    }
+
+    updatePorts(netlist->values());
+    return true;
+}
+
+void Simulation::loadClocks()
+{
+    auto *netlist = m_elmMapping->netlist();
+
+    m_clockQueue.clear();
+
+    for (auto *clock : qAsConst(m_clocks)) {
+        if (clock->updateOutputs()) {
+            netlist->loadOutputs(clock->logic());
+        }
+
+        if (!clock->isLocked()) {
+            m_clockQueue.addClock(clock->logic(), clock->frequency());
+        }
+    }
+}
+
+QVector<GraphicElement *> Simulation::collectElements()
 {
     m_clocks.clear();
     m_outputs.clear();
+    m_remoteDevices.clear();
     m_inputs.clear();
     m_connections.clear();
 
@@ -123,7 +572,7 @@ bool Simulation::initialize()
     const auto items = m_scene->items();
 
     if (items.size() == 1) {
-        return false;
+        return {};
     }
 
     qCDebug(two) << tr("GENERATING SIMULATION LAYER.");
@@ -139,16 +588,17 @@ bool Simulation::initialize()
 
             if (element->elementType() == ElementType::Clock) {
                 m_clocks.append(qobject_cast<Clock *>(element));
-                m_clocks.constLast()->resetClock();
-            }
-
-            if (element->elementGroup() == ElementGroup::Input) {
+            } else if (element->elementGroup() == ElementGroup::Input) {
                 m_inputs.append(qobject_cast<GraphicElementInput *>(element));
             }
 
             if (element->elementGroup() == ElementGroup::Output) {
                 m_outputs.append(element);
             }
+
+            if (element->elementType() == ElementType::RemoteDevice) {
+                m_remoteDevices.append(element);
+            }
         }
     }
 
@@ -158,18 +608,5 @@ bool Simulation::initialize()
 
     qCDebug(zero) << tr("Elements read: ") << elements.size();
 
-    if (elements.empty()) {
-        return false;
-    }
-
-    qCDebug(two) << tr("Recreating mapping for simulation.");
-    m_elmMapping = std::make_unique<ElementMapping>(elements);
-
-    qCDebug(two) << tr("Sorting.");
-    m_elmMapping->sort();
-
-    m_initialized = true;
-
-    qCDebug(zero) << tr("Finished simulation layer.");
-    return true;
+    return elements;
 }
@@ -3,17 +3,22 @@
 
 #pragma once
 
+#include "clockqueue.h"
 #include "elementmapping.h"
+#include "simulationcounters.h"
+#include "simulationthread.h"
 
 #include <QGraphicsItem>
 #include <QObject>
+#include <QPointer>
 #include <QTimer>
 #include <memory>
 
+class Netlist;
 class QNEConnection;
-class QNEInputPort;
-class QNEOutputPort;
+class QNEPort;
 class Scene;
+class VcdWriter;
 
 class Simulation : public QObject
 {
@@ -23,25 +28,102 @@ public:
     explicit Simulation(Scene *scene);
     ~Simulation() override = default;
 
+    //! Patches the simulation layer after an edit of the scene, generating it again only if the patch fails.
+    void applyDelta(const NetlistDelta &delta);
+    //! Running totals of the work of the simulation, for profiling.
+    SimulationCounters &counters();
+    //! Loads the inputs like update() and updates until no output changes anymore, at most @p maxIterations
+    //! times. Returns false if the circuit still changes by then, as it does when it oscillates.
+    bool evaluateUntilStable(const int maxIterations = 64);
     bool initialize();
     bool isRunning();
+    bool isTracing() const;
+    //! Compiled netlist of the scene, initializing the simulation if needed. Returns nullptr for an empty scene.
+    //! The simulation must be stopped while the netlist is used directly, as it may be running on another thread.
+    Netlist *netlist();
+    //! Seconds of simulated time per second of wall-clock time for the clocks, or zero to run them as fast as possible.
+    double realTimeFactor() const;
     void restart();
+    //! Rewinds the netlist to @p cycle, setting the input elements back to their values then. Returns false if
+    //! that cycle is not kept anymore. See Netlist::rewind().
+    bool rewind(const quint64 cycle);
+    void setRealTimeFactor(const double factor);
     void start();
+
+    /**
+     * @brief Writes the changes of the outputs of @p elements to the VCD file @p fileName, or of the inputs of the
+     * ones without outputs, until stopTrace(). Throws a Pandaception if the file cannot be written.
+     *
+     * The trace goes on across edits of the circuit, without the signals of the elements removed meanwhile.
+     */
+    void startTrace(const QString &fileName, const QVector<GraphicElement *> &elements);
+
     void stop();
+    void stopTrace();
     void update();
 
 private:
     Q_DISABLE_COPY(Simulation)
 
-    static void updatePort(QNEInputPort *port);
-    static void updatePort(QNEOutputPort *port);
+    //! Port painted from a slot of the netlist, or from a range of slots for a bus, which is active if any of its
+    //! bits is set. Output elements are refreshed when one of their ports changes.
+    struct PortSlot {
+        int slot = -1;
+        QNEPort *port = nullptr;
+        GraphicElement *outputElm = nullptr;
+        int width = 1;
+    };
+
+    //! Port of an element whose signal is traced.
+    struct TracePort {
+        QPointer<GraphicElement> elm;
+        int port = 0;
+        bool isInput = false;
+    };
+
+    //! Repaints the ports from the latest values, at most once per frame while running.
+    void refresh();
+    //! Maps the traced signals to the slots of a new netlist.
+    void attachTrace();
+    //! Scans the scene for the elements to simulate, along with their connections, clocks, inputs and outputs.
+    QVector<GraphicElement *> collectElements();
+    //! Copies the state of the clocks to their logic elements and queues their edges from now on.
+    void loadClocks();
+    //! Copies the input elements that changed to the netlist, the clocks too while stopped.
+    void loadInputs(Netlist *netlist);
+    //! Keeps the checkpoints of a new netlist, within the memory set in the "rewindMemory" setting, in MiB.
+    void keepHistory();
+    //! Queues the changes of the input elements to the simulation thread.
+    void sendInputs();
+    void mapPorts();
+    void startThread();
+    void stopThread();
+    void updatePorts(const std::vector<quint64> &values);
 
+    QTimer m_refreshTimer;
     QTimer m_timer;
+    ClockQueue m_clockQueue;
+    //! Declared before the thread, which adds to them.
+    SimulationCounters m_counters;
     QVector<Clock *> m_clocks;
     QVector<GraphicElement *> m_outputs;
+    QVector<GraphicElement *> m_remoteDevices;
+    //! Input elements other than the clocks, which only follow the ClockQueue while running.
     QVector<GraphicElementInput *> m_inputs;
     QVector<QNEConnection *> m_connections;
+    //! Output slot of each clock, to repaint it once per frame however fast it ticks.
+    QVector<int> m_clockSlots;
+    //! Ports sorted by slot, the invalid ones first.
+    QVector<PortSlot> m_portSlots;
+    QVector<TracePort> m_tracePorts;
+    //! Last value sent to the simulation thread for each port of each input element.
+    QVector<SimulationThread::Input> m_sentInputs;
     Scene *m_scene;
     bool m_initialized = false;
     std::unique_ptr<ElementMapping> m_elmMapping;
+    //! Declared before the thread, which samples it, so it is destroyed after the thread is stopped.
+    std::shared_ptr<VcdWriter> m_trace;
+    std::unique_ptr<SimulationThread> m_thread;
+    //! Values the ports were last painted with.
+    std::vector<quint64> m_shownValues;
 };
@@ -0,0 +1,149 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "simulationcounters.h"
+
+namespace
+{
+    double milliseconds(const std::chrono::nanoseconds time)
+    {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+
+    double ratio(const quint64 count, const quint64 total)
+    {
+        return (total > 0) ? static_cast<double>(count) / static_cast<double>(total) : 0.0;
+    }
+}
+
+SimulationCounters::SimulationCounters()
+{
+    reset();
+}
+
+void SimulationCounters::addEvaluation(const quint64 ticks, const quint64 evaluations, const std::chrono::nanoseconds time)
+{
+    m_ticks.fetch_add(ticks, std::memory_order_relaxed);
+    m_evaluations.fetch_add(evaluations, std::memory_order_relaxed);
+    m_evaluationTime.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void SimulationCounters::addPropagation(const quint64 portUpdates, const std::chrono::nanoseconds time)
+{
+    m_portUpdates.fetch_add(portUpdates, std::memory_order_relaxed);
+    m_propagationTime.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void SimulationCounters::addRefresh(const std::chrono::nanoseconds time)
+{
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    m_refreshTime.fetch_add(time.count(), std::memory_order_relaxed);
+}
+
+void SimulationCounters::addInitialization(const std::chrono::nanoseconds mappingTime, const std::chrono::nanoseconds sortingTime)
+{
+    m_initializations.fetch_add(1, std::memory_order_relaxed);
+    m_mappingTime.fetch_add(mappingTime.count(), std::memory_order_relaxed);
+    m_sortingTime.fetch_add(sortingTime.count(), std::memory_order_relaxed);
+}
+
+void SimulationCounters::reset()
+{
+    m_start.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+
+    for (auto *counter : {&m_ticks, &m_evaluations, &m_portUpdates, &m_frames, &m_initializations}) {
+        counter->store(0, std::memory_order_relaxed);
+    }
+
+    for (auto *time : {&m_evaluationTime, &m_propagationTime, &m_refreshTime, &m_mappingTime, &m_sortingTime}) {
+        time->store(0, std::memory_order_relaxed);
+    }
+}
+
+SimulationCounters::Sample SimulationCounters::sample() const
+{
+    const std::chrono::steady_clock::duration start(m_start.load(std::memory_order_relaxed));
+
+    Sample sample;
+    sample.elapsed = std::chrono::steady_clock::now().time_since_epoch() - start;
+    sample.ticks = m_ticks.load(std::memory_order_relaxed);
+    sample.evaluations = m_evaluations.load(std::memory_order_relaxed);
+    sample.portUpdates = m_portUpdates.load(std::memory_order_relaxed);
+    sample.frames = m_frames.load(std::memory_order_relaxed);
+    sample.initializations = m_initializations.load(std::memory_order_relaxed);
+    sample.evaluationTime = std::chrono::nanoseconds(m_evaluationTime.load(std::memory_order_relaxed));
+    sample.propagationTime = std::chrono::nanoseconds(m_propagationTime.load(std::memory_order_relaxed));
+    sample.refreshTime = std::chrono::nanoseconds(m_refreshTime.load(std::memory_order_relaxed));
+    sample.mappingTime = std::chrono::nanoseconds(m_mappingTime.load(std::memory_order_relaxed));
+    sample.sortingTime = std::chrono::nanoseconds(m_sortingTime.load(std::memory_order_relaxed));
+    return sample;
+}
+
+SimulationCounters::Sample SimulationCounters::Sample::since(const Sample &previous) const
+{
+    // Counters that were reset in between count from zero.
+    const auto delta = [](const auto current, const auto earlier) {
+        return (current >= earlier) ? current - earlier : current;
+    };
+
+    Sample sample;
+    sample.elapsed = delta(elapsed, previous.elapsed);
+    sample.ticks = delta(ticks, previous.ticks);
+    sample.evaluations = delta(evaluations, previous.evaluations);
+    sample.portUpdates = delta(portUpdates, previous.portUpdates);
+    sample.frames = delta(frames, previous.frames);
+    sample.initializations = delta(initializations, previous.initializations);
+    sample.evaluationTime = delta(evaluationTime, previous.evaluationTime);
+    sample.propagationTime = delta(propagationTime, previous.propagationTime);
+    sample.refreshTime = delta(refreshTime, previous.refreshTime);
+    sample.mappingTime = delta(mappingTime, previous.mappingTime);
+    sample.sortingTime = delta(sortingTime, previous.sortingTime);
+    return sample;
+}
+
+double SimulationCounters::Sample::ticksPerSecond() const
+{
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return (seconds > 0) ? static_cast<double>(ticks) / seconds : 0.0;
+}
+
+double SimulationCounters::Sample::evaluationsPerTick() const
+{
+    return ratio(evaluations, ticks);
+}
+
+double SimulationCounters::Sample::portUpdatesPerTick() const
+{
+    return ratio(portUpdates, ticks);
+}
+
+QString SimulationCounters::Sample::summary() const
+{
+    return tr("%1 ticks/s, %2 evaluations/tick, %3 port updates/tick | evaluation %4 ms, propagation %5 ms, refresh %6 ms")
+        .arg(ticksPerSecond(), 0, 'f', 0)
+        .arg(evaluationsPerTick(), 0, 'f', 1)
+        .arg(portUpdatesPerTick(), 0, 'f', 2)
+        .arg(milliseconds(evaluationTime), 0, 'f', 1)
+        .arg(milliseconds(propagationTime), 0, 'f', 1)
+        .arg(milliseconds(refreshTime), 0, 'f', 1);
+}
+
+QJsonObject SimulationCounters::Sample::toJson() const
+{
+    return {
+        {"elapsedMs", milliseconds(elapsed)},
+        {"ticks", static_cast<double>(ticks)},
+        {"ticksPerSecond", ticksPerSecond()},
+        {"evaluations", static_cast<double>(evaluations)},
+        {"evaluationsPerTick", evaluationsPerTick()},
+        {"portUpdates", static_cast<double>(portUpdates)},
+        {"portUpdatesPerTick", portUpdatesPerTick()},
+        {"frames", static_cast<double>(frames)},
+        {"evaluationMs", milliseconds(evaluationTime)},
+        {"propagationMs", milliseconds(propagationTime)},
+        {"refreshMs", milliseconds(refreshTime)},
+        {"initializations", static_cast<double>(initializations)},
+        {"mappingMs", milliseconds(mappingTime)},
+        {"sortingMs", milliseconds(sortingTime)},
+    };
+}
@@ -0,0 +1,84 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QJsonObject>
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief Running totals of where the time of a Simulation goes.
+ *
+ * The engine adds to them once per tick, not once per element, and the GUI thread adds the time it spends
+ * painting the ports. Every total is a relaxed atomic, so the simulation thread never waits for a reader, and a
+ * Sample taken meanwhile may be a tick off between two totals.
+ */
+class SimulationCounters
+{
+    Q_DECLARE_TR_FUNCTIONS(SimulationCounters)
+
+public:
+    //! Totals at a point in time, or the difference of two of them.
+    struct Sample {
+        std::chrono::nanoseconds elapsed{0};
+        quint64 ticks = 0;
+        quint64 evaluations = 0;
+        quint64 portUpdates = 0;
+        quint64 frames = 0;
+        quint64 initializations = 0;
+        std::chrono::nanoseconds evaluationTime{0};
+        std::chrono::nanoseconds propagationTime{0};
+        std::chrono::nanoseconds refreshTime{0};
+        std::chrono::nanoseconds mappingTime{0};
+        std::chrono::nanoseconds sortingTime{0};
+
+        //! Counts and times of this sample since @p previous, an earlier sample of the same counters.
+        Sample since(const Sample &previous) const;
+
+        //! Netlist updates per second of wall-clock time, clock edges included.
+        double ticksPerSecond() const;
+        double evaluationsPerTick() const;
+        double portUpdatesPerTick() const;
+
+        //! One line summary, for the status bar.
+        QString summary() const;
+        QJsonObject toJson() const;
+    };
+
+    SimulationCounters();
+
+    //! Adds @p ticks netlist updates, which evaluated @p evaluations elements in @p time.
+    void addEvaluation(const quint64 ticks, const quint64 evaluations, const std::chrono::nanoseconds time);
+
+    //! Adds the repaint of @p portUpdates ports and their output elements, which took @p time.
+    void addPropagation(const quint64 portUpdates, const std::chrono::nanoseconds time);
+
+    //! Adds a frame painted by Simulation::refresh(), which took @p time, propagation included.
+    void addRefresh(const std::chrono::nanoseconds time);
+
+    //! Adds the generation of a simulation layer, split into the mapping of the elements and their sorting.
+    void addInitialization(const std::chrono::nanoseconds mappingTime, const std::chrono::nanoseconds sortingTime);
+
+    //! Sets every total back to zero and starts counting the elapsed time again.
+    void reset();
+
+    Sample sample() const;
+
+private:
+    Q_DISABLE_COPY(SimulationCounters)
+
+    std::atomic<std::chrono::steady_clock::rep> m_start{0};
+    std::atomic<quint64> m_ticks{0};
+    std::atomic<quint64> m_evaluations{0};
+    std::atomic<quint64> m_portUpdates{0};
+    std::atomic<quint64> m_frames{0};
+    std::atomic<quint64> m_initializations{0};
+    std::atomic<qint64> m_evaluationTime{0};
+    std::atomic<qint64> m_propagationTime{0};
+    std::atomic<qint64> m_refreshTime{0};
+    std::atomic<qint64> m_mappingTime{0};
+    std::atomic<qint64> m_sortingTime{0};
+};
@@ -0,0 +1,99 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "simulationthread.h"
+
+#include "clockqueue.h"
+#include "logicelement.h"
+#include "netlist.h"
+#include "simulationcounters.h"
+
+#include <algorithm>
+
+SimulationThread::SimulationThread(Netlist *netlist, ClockQueue *clocks, SimulationCounters *counters, const std::chrono::microseconds interval)
+    : m_clocks(clocks)
+    , m_netlist(netlist)
+    , m_counters(counters)
+    , m_interval(interval)
+{
+    for (auto &buffer : m_buffers) {
+        buffer = m_netlist->values();
+    }
+
+    m_thread = std::thread(&SimulationThread::run, this);
+}
+
+SimulationThread::~SimulationThread()
+{
+    m_stop = true;
+    m_thread.join();
+}
+
+bool SimulationThread::pushInput(const Input &input)
+{
+    const int tail = m_queueTail.load(std::memory_order_relaxed);
+    const int next = (tail + 1) % queueSize;
+
+    if (next == m_queueHead.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    m_queue[tail] = input;
+    m_queueTail.store(next, std::memory_order_release);
+    return true;
+}
+
+bool SimulationThread::popInput(Input &input)
+{
+    const int head = m_queueHead.load(std::memory_order_relaxed);
+
+    if (head == m_queueTail.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    input = m_queue[head];
+    m_queueHead.store((head + 1) % queueSize, std::memory_order_release);
+    return true;
+}
+
+const std::vector<quint64> *SimulationThread::snapshot()
+{
+    if (!(m_latest.load(std::memory_order_relaxed) & freshBit)) {
+        return nullptr;
+    }
+
+    m_front = m_latest.exchange(m_front, std::memory_order_acq_rel) & ~freshBit;
+    return &m_buffers[m_front];
+}
+
+void SimulationThread::publish()
+{
+    m_buffers[m_back] = m_netlist->values();
+    m_back = m_latest.exchange(m_back | freshBit, std::memory_order_acq_rel) & ~freshBit;
+}
+
+void SimulationThread::run()
+{
+    auto nextTick = std::chrono::steady_clock::now();
+
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        const auto start = std::chrono::steady_clock::now();
+        const quint64 updates = m_netlist->updateCount();
+        const quint64 evaluations = m_netlist->evaluationCount();
+        Input input;
+
+        while (popInput(input)) {
+            input.logic->setOutputValue(input.port, input.value);
+            m_netlist->loadOutputs(input.logic);
+        }
+
+        m_netlist->update();
+        m_clocks->run(m_netlist, m_interval);
+        m_counters->addEvaluation(m_netlist->updateCount() - updates, m_netlist->evaluationCount() - evaluations, std::chrono::steady_clock::now() - start);
+        publish();
+
+        // Keeps the same pace as the timer of the GUI thread did, without trying to catch up after a slow tick.
+        nextTick = std::max(nextTick + m_interval, std::chrono::steady_clock::now() - m_interval);
+        std::this_thread::sleep_until(nextTick);
+    }
+}
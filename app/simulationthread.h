@@ -0,0 +1,79 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+class ClockQueue;
+class LogicElement;
+class Netlist;
+class SimulationCounters;
+
+/**
+ * @brief Runs the ticks of a Netlist on a thread of its own.
+ *
+ * The GUI thread never touches the netlist nor its logic elements while the thread runs. Input changes reach the
+ * engine through a single-producer single-consumer queue, and after every tick the engine publishes a copy of the
+ * netlist values into one of three buffers: the one being written, the latest complete one and the one being read
+ * by the GUI. Swapping them is a single atomic exchange, so neither side ever waits for the other.
+ *
+ * The clocks are run by a ClockQueue of the thread, so they may tick many times between two snapshots.
+ */
+class SimulationThread
+{
+public:
+    //! Change of an output of an input element, as requested by the GUI.
+    struct Input {
+        LogicElement *logic = nullptr;
+        int port = 0;
+        bool value = false;
+    };
+
+    explicit SimulationThread(Netlist *netlist, ClockQueue *clocks, SimulationCounters *counters, const std::chrono::microseconds interval);
+    ~SimulationThread();
+
+    //! Value of a slot in a snapshot returned by snapshot().
+    static bool value(const std::vector<quint64> &snapshot, const int slot);
+
+    //! Latest values published by the engine, or nullptr if nothing was published since the last call.
+    const std::vector<quint64> *snapshot();
+
+    //! Queues an input change for the next tick. Returns false if the queue is full.
+    bool pushInput(const Input &input);
+
+private:
+    Q_DISABLE_COPY(SimulationThread)
+
+    static constexpr int queueSize = 1024;
+    static constexpr int freshBit = 4;
+
+    bool popInput(Input &input);
+    void publish();
+    void run();
+
+    ClockQueue *m_clocks;
+    Netlist *m_netlist;
+    SimulationCounters *m_counters;
+    const std::chrono::microseconds m_interval;
+    std::array<Input, queueSize> m_queue;
+    std::array<std::vector<quint64>, 3> m_buffers;
+    alignas(64) std::atomic<int> m_queueHead{0};
+    alignas(64) std::atomic<int> m_queueTail{0};
+    alignas(64) std::atomic<int> m_latest{1};
+    std::atomic<bool> m_stop{false};
+    int m_back = 0;
+    int m_front = 2;
+    std::thread m_thread;
+};
+
+inline bool SimulationThread::value(const std::vector<quint64> &snapshot, const int slot)
+{
+    return (snapshot[slot >> 6] >> (slot & 63)) & 1;
+}
@@ -0,0 +1,144 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "statehistory.h"
+
+#include <algorithm>
+
+StateHistory::StateHistory(const qsizetype memoryLimit)
+    : m_memoryLimit(memoryLimit)
+{
+}
+
+bool StateHistory::isEmpty() const
+{
+    return m_checkpoints.empty();
+}
+
+quint64 StateHistory::firstCycle() const
+{
+    return m_checkpoints.front().cycle;
+}
+
+quint64 StateHistory::lastCycle() const
+{
+    return m_checkpoints.back().cycle;
+}
+
+qsizetype StateHistory::memoryUsage() const
+{
+    return m_memoryUsage + static_cast<qsizetype>(m_inputs.size() * sizeof(Input) + m_last.size() * sizeof(quint64));
+}
+
+const std::deque<StateHistory::Input> &StateHistory::inputs() const
+{
+    return m_inputs;
+}
+
+qsizetype StateHistory::size(const Checkpoint &checkpoint)
+{
+    return static_cast<qsizetype>(sizeof(Checkpoint) + checkpoint.indices.size() * sizeof(quint32) + checkpoint.words.size() * sizeof(quint64));
+}
+
+void StateHistory::checkpoint(const quint64 cycle, const std::vector<quint64> &state)
+{
+    Q_ASSERT(m_checkpoints.empty() || (cycle > lastCycle()));
+
+    Checkpoint checkpoint{cycle, {}, {}};
+
+    if (m_checkpoints.empty()) {
+        checkpoint.words = state;
+    } else {
+        // Stored as the XOR with the previous state, so applying a checkpoint is the same in both directions.
+        for (size_t index = 0; index < state.size(); ++index) {
+            if (const quint64 delta = state[index] ^ m_last[index]) {
+                checkpoint.indices.push_back(static_cast<quint32>(index));
+                checkpoint.words.push_back(delta);
+            }
+        }
+    }
+
+    m_memoryUsage += size(checkpoint);
+    m_checkpoints.push_back(std::move(checkpoint));
+    m_last = state;
+
+    while ((m_checkpoints.size() > 1) && (memoryUsage() > m_memoryLimit)) {
+        dropOldest();
+    }
+}
+
+void StateHistory::logInput(const quint64 cycle, const int element, const quint64 value)
+{
+    m_inputs.push_back({cycle, element, value});
+}
+
+void StateHistory::applyDelta(const Checkpoint &checkpoint, std::vector<quint64> &state)
+{
+    for (size_t word = 0; word < checkpoint.indices.size(); ++word) {
+        state[checkpoint.indices[word]] ^= checkpoint.words[word];
+    }
+}
+
+void StateHistory::apply(const size_t last, std::vector<quint64> &state) const
+{
+    // Deltas undo themselves, so a checkpoint closer to the latest one is reached by going back from it.
+    if (m_checkpoints.size() - 1 - last < last) {
+        state = m_last;
+
+        for (size_t index = m_checkpoints.size() - 1; index > last; --index) {
+            applyDelta(m_checkpoints[index], state);
+        }
+
+        return;
+    }
+
+    state = m_checkpoints.front().words;
+
+    for (size_t index = 1; index <= last; ++index) {
+        applyDelta(m_checkpoints[index], state);
+    }
+}
+
+quint64 StateHistory::restore(const quint64 cycle, std::vector<quint64> &state) const
+{
+    Q_ASSERT(!m_checkpoints.empty() && (cycle >= firstCycle()));
+
+    const auto next = std::upper_bound(m_checkpoints.cbegin(), m_checkpoints.cend(), cycle, [](const quint64 cycle_, const Checkpoint &checkpoint) {
+        return cycle_ < checkpoint.cycle;
+    });
+
+    const size_t last = static_cast<size_t>(next - m_checkpoints.cbegin()) - 1;
+    apply(last, state);
+    return m_checkpoints[last].cycle;
+}
+
+void StateHistory::truncate(const quint64 cycle)
+{
+    while ((m_checkpoints.size() > 1) && (lastCycle() > cycle)) {
+        applyDelta(m_checkpoints.back(), m_last);
+        m_memoryUsage -= size(m_checkpoints.back());
+        m_checkpoints.pop_back();
+    }
+
+    while (!m_inputs.empty() && (m_inputs.back().cycle >= cycle)) {
+        m_inputs.pop_back();
+    }
+}
+
+void StateHistory::dropOldest()
+{
+    // The second checkpoint becomes the whole one.
+    std::vector<quint64> state;
+    apply(1, state);
+
+    m_memoryUsage -= size(m_checkpoints[0]) + size(m_checkpoints[1]);
+    m_checkpoints.pop_front();
+    m_checkpoints.front().indices.clear();
+    m_checkpoints.front().indices.shrink_to_fit();
+    m_checkpoints.front().words = std::move(state);
+    m_memoryUsage += size(m_checkpoints.front());
+
+    while (!m_inputs.empty() && (m_inputs.front().cycle < firstCycle())) {
+        m_inputs.pop_front();
+    }
+}
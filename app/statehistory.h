@@ -0,0 +1,86 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Bounded ring of checkpoints of the state of a Netlist, along with the input changes between them.
+ *
+ * A checkpoint is the bit-packed state of the netlist at the end of a cycle. Only the oldest checkpoint is kept
+ * whole; each of the others keeps the words that changed since the previous one, so a circuit whose counters
+ * move a few bits per cycle costs a few words per checkpoint. When the memory limit is reached, the oldest
+ * checkpoint and the inputs logged before the next one are dropped.
+ */
+class StateHistory
+{
+public:
+    //! Change of the outputs of an input element, loaded before the update that ends @p cycle + 1.
+    struct Input {
+        quint64 cycle;
+        int element;
+        quint64 value;
+    };
+
+    explicit StateHistory(const qsizetype memoryLimit);
+
+    bool isEmpty() const;
+
+    //! Cycle of the oldest checkpoint, the earliest one that can be restored.
+    quint64 firstCycle() const;
+
+    //! Cycle of the latest checkpoint.
+    quint64 lastCycle() const;
+
+    //! Approximate memory used by the checkpoints and the input log, in bytes.
+    qsizetype memoryUsage() const;
+
+    //! Input changes logged so far, in order.
+    const std::deque<Input> &inputs() const;
+
+    //! Adds the checkpoint of @p cycle, which must come after the latest one.
+    void checkpoint(const quint64 cycle, const std::vector<quint64> &state);
+
+    void logInput(const quint64 cycle, const int element, const quint64 value);
+
+    /**
+     * @brief Writes to @p state the latest checkpoint not after @p cycle and returns its cycle.
+     *
+     * @p cycle must not be before firstCycle().
+     */
+    quint64 restore(const quint64 cycle, std::vector<quint64> &state) const;
+
+    //! Drops the checkpoints after @p cycle and the inputs logged from @p cycle on, as they do not happen anymore
+    //! once the netlist is rewound there.
+    void truncate(const quint64 cycle);
+
+private:
+    Q_DISABLE_COPY(StateHistory)
+
+    //! Words of a checkpoint that differ from the previous one, or every word for the oldest checkpoint.
+    struct Checkpoint {
+        quint64 cycle;
+        std::vector<quint32> indices;
+        std::vector<quint64> words;
+    };
+
+    static qsizetype size(const Checkpoint &checkpoint);
+    //! XORs the words of @p checkpoint into @p state, which moves it from the previous checkpoint to this one or back.
+    static void applyDelta(const Checkpoint &checkpoint, std::vector<quint64> &state);
+
+    //! Writes to @p state the checkpoint @p last, going forward from the oldest checkpoint or back from the latest
+    //! one, whichever is closer.
+    void apply(const size_t last, std::vector<quint64> &state) const;
+    void dropOldest();
+
+    std::deque<Checkpoint> m_checkpoints;
+    std::deque<Input> m_inputs;
+    //! Whole state of the latest checkpoint, which the next one is compared to.
+    std::vector<quint64> m_last;
+    const qsizetype m_memoryLimit;
+    qsizetype m_memoryUsage = 0;
+};
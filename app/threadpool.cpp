@@ -0,0 +1,108 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(const int threadCount)
+    : m_queues(std::make_unique<Queue[]>(qMax(1, threadCount)))
+{
+    for (int worker = 1; worker < threadCount; ++worker) {
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+}
+
+int ThreadPool::threadCount() const
+{
+    return static_cast<int>(m_threads.size()) + 1;
+}
+
+void ThreadPool::run(const int chunkCount, const std::function<void(int)> &task)
+{
+    if (m_threads.empty() || (chunkCount <= 1)) {
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            task(chunk);
+        }
+
+        return;
+    }
+
+    // Simulations of different tabs run on threads of their own, but share the pool one loop at a time.
+    std::lock_guard runLock(m_runMutex);
+    const int workers = threadCount();
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (int worker = 0; worker < workers; ++worker) {
+            m_queues[worker].next = chunkCount * worker / workers;
+            m_queues[worker].end = chunkCount * (worker + 1) / workers;
+        }
+
+        m_task = &task;
+        m_busy = static_cast<int>(m_threads.size());
+        ++m_generation;
+    }
+
+    m_wake.notify_all();
+    work(0);
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_task = nullptr;
+}
+
+void ThreadPool::work(const int worker)
+{
+    const int workers = threadCount();
+
+    // Own range first, then steal from the others. A chunk belongs to whoever increments the counter onto it.
+    for (int offset = 0; offset < workers; ++offset) {
+        Queue &queue = m_queues[(worker + offset) % workers];
+
+        for (int chunk = queue.next++; chunk < queue.end; chunk = queue.next++) {
+            (*m_task)(chunk);
+        }
+    }
+}
+
+void ThreadPool::workerLoop(const int worker)
+{
+    quint64 generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || (m_generation != generation); });
+
+            if (m_stop) {
+                return;
+            }
+
+            generation = m_generation;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard lock(m_mutex);
+
+            if (--m_busy == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work-stealing pool that runs the chunks of a parallel loop.
+ *
+ * Each worker owns a contiguous range of chunks and takes them from the front of its own range; once it runs
+ * out, it steals from the ranges of the other workers. The calling thread works as well, and run() only returns
+ * when every chunk is done, so consecutive calls act as barriers.
+ */
+class ThreadPool
+{
+public:
+    //! Pool shared by the whole application, with one worker per hardware thread.
+    static ThreadPool &instance()
+    {
+        static ThreadPool instance(static_cast<int>(std::thread::hardware_concurrency()));
+        return instance;
+    }
+
+    explicit ThreadPool(const int threadCount);
+    ~ThreadPool();
+
+    //! Number of threads running chunks, including the calling thread.
+    int threadCount() const;
+
+    //! Runs @p task for every chunk in [0, @p chunkCount) and waits for all of them.
+    void run(const int chunkCount, const std::function<void(int)> &task);
+
+private:
+    Q_DISABLE_COPY(ThreadPool)
+
+    struct alignas(64) Queue {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    void work(const int worker);
+    void workerLoop(const int worker);
+
+    const std::function<void(int)> *m_task = nullptr;
+    std::condition_variable m_done;
+    std::condition_variable m_wake;
+    std::mutex m_mutex;
+    std::mutex m_runMutex;
+    std::unique_ptr<Queue[]> m_queues;
+    std::vector<std::thread> m_threads;
+    bool m_stop = false;
+    int m_busy = 0;
+    quint64 m_generation = 0;
+};
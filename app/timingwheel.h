@@ -0,0 +1,175 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+/**
+ * @brief Hierarchical timing wheel of events keyed by simulated time.
+ *
+ * Each level has 64 slots, and each slot of a level spans a whole turn of the level below it. An event goes to
+ * the lowest level whose slots tell its time apart from the current one, and is moved down a level when the
+ * wheel reaches its slot, so scheduling costs a constant time and finding the next event takes a few bit scans
+ * over the occupied slots of each level. Events too far in the future wait in an overflow list.
+ *
+ * @p Event must have a quint64 member called time.
+ */
+template<typename Event>
+class TimingWheel
+{
+public:
+    //! Time of the last events taken from the wheel. Events may not be scheduled before it.
+    quint64 time() const;
+
+    bool isEmpty() const;
+
+    void clear();
+    void schedule(const Event &event);
+
+    /**
+     * @brief Moves to the next events due up to @p limit and appends them to @p due.
+     *
+     * Returns false, without moving, if no event is due up to @p limit.
+     */
+    bool takeNext(const quint64 limit, std::vector<Event> &due);
+
+private:
+    static constexpr int slotBits = 6;
+    static constexpr int levelCount = 5;
+
+    static int slotIndex(const quint64 time, const int level);
+
+    std::array<std::array<std::vector<Event>, 64>, levelCount> m_slots;
+    std::array<quint64, levelCount> m_occupied{};
+    std::vector<Event> m_overflow;
+    quint64 m_time = 0;
+    int m_count = 0;
+};
+
+template<typename Event>
+quint64 TimingWheel<Event>::time() const
+{
+    return m_time;
+}
+
+template<typename Event>
+bool TimingWheel<Event>::isEmpty() const
+{
+    return (m_count == 0);
+}
+
+template<typename Event>
+void TimingWheel<Event>::clear()
+{
+    for (auto &level : m_slots) {
+        for (auto &slot : level) {
+            slot.clear();
+        }
+    }
+
+    m_occupied.fill(0);
+    m_overflow.clear();
+    m_time = 0;
+    m_count = 0;
+}
+
+template<typename Event>
+int TimingWheel<Event>::slotIndex(const quint64 time, const int level)
+{
+    return static_cast<int>((time >> (level * slotBits)) & 63);
+}
+
+template<typename Event>
+void TimingWheel<Event>::schedule(const Event &event)
+{
+    Q_ASSERT(event.time >= m_time);
+    ++m_count;
+
+    // The highest bit that differs from the current time picks the level.
+    const quint64 difference = event.time ^ m_time;
+    int level = 0;
+
+    while ((level < levelCount) && (difference >> ((level + 1) * slotBits))) {
+        ++level;
+    }
+
+    if (level == levelCount) {
+        m_overflow.push_back(event);
+        return;
+    }
+
+    const int slot = slotIndex(event.time, level);
+    m_slots[level][slot].push_back(event);
+    m_occupied[level] |= quint64(1) << slot;
+}
+
+template<typename Event>
+bool TimingWheel<Event>::takeNext(const quint64 limit, std::vector<Event> &due)
+{
+    while (m_count > 0) {
+        // Events of the lowest level are due at the time of their slot, which is never behind the current one.
+        if (const quint64 occupied = m_occupied[0] & (~quint64(0) << slotIndex(m_time, 0))) {
+            const int slot = qCountTrailingZeroBits(occupied);
+            const quint64 time = (m_time & ~quint64(63)) | static_cast<quint64>(slot);
+
+            if (time > limit) {
+                return false;
+            }
+
+            m_time = time;
+            m_count -= static_cast<int>(m_slots[0][slot].size());
+            due.insert(due.end(), m_slots[0][slot].cbegin(), m_slots[0][slot].cend());
+            m_slots[0][slot].clear();
+            m_occupied[0] &= ~(quint64(1) << slot);
+            return true;
+        }
+
+        // Otherwise, the wheel moves to the start of the first occupied slot above and spreads it over the levels
+        // below. Every level under it is empty, so no event is skipped.
+        int level = 1;
+
+        while ((level < levelCount) && !m_occupied[level]) {
+            ++level;
+        }
+
+        std::vector<Event> cascade;
+
+        if (level < levelCount) {
+            const int slot = qCountTrailingZeroBits(m_occupied[level]);
+            const int shift = level * slotBits;
+            const quint64 start = ((m_time >> (shift + slotBits)) << (shift + slotBits)) | (static_cast<quint64>(slot) << shift);
+
+            if (start > limit) {
+                return false;
+            }
+
+            m_time = start;
+            cascade.swap(m_slots[level][slot]);
+            m_occupied[level] &= ~(quint64(1) << slot);
+        } else {
+            const auto first = std::min_element(m_overflow.cbegin(), m_overflow.cend(), [](const Event &event1, const Event &event2) {
+                return event1.time < event2.time;
+            });
+
+            if (first->time > limit) {
+                return false;
+            }
+
+            m_time = first->time;
+            cascade.swap(m_overflow);
+        }
+
+        m_count -= static_cast<int>(cascade.size());
+
+        for (const auto &event : cascade) {
+            schedule(event);
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,237 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "vcdwriter.h"
+
+#include "common.h"
+#include "netlist.h"
+
+#include <QDateTime>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    //! Formatted records are written to disk in blocks of this size, or whenever the ring runs empty.
+    const int blockSize = 1 << 16;
+}
+
+VcdWriter::VcdWriter(const QString &fileName, const QVector<Signal> &signalList, const QString &timescale)
+    : m_file(fileName)
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw Pandaception(tr("Error opening file: ") + m_file.errorString());
+    }
+
+    QByteArray header;
+    header += "$date\n  " + QDateTime::currentDateTime().toString(Qt::ISODate).toUtf8() + "\n$end\n";
+    header += "$version\n  WiRedPanda " APP_VERSION "\n$end\n";
+    header += "$timescale " + timescale.toUtf8() + " $end\n";
+    header += "$scope module circuit $end\n";
+
+    for (int signal = 0; signal < signalList.size(); ++signal) {
+        const auto &signalInfo = signalList.at(signal);
+        QString name = signalInfo.name;
+        name.replace(QRegularExpression("\\s+"), "_");
+
+        if (signalInfo.width > 1) {
+            name += QString(" [%1:0]").arg(signalInfo.width - 1);
+        }
+
+        m_identifiers.append(identifier(signal));
+        m_widths.append(signalInfo.width);
+        header += "$var wire " + QByteArray::number(signalInfo.width) + " " + m_identifiers.constLast() + " " + name.toUtf8() + " $end\n";
+    }
+
+    header += "$upscope $end\n";
+    header += "$enddefinitions $end\n";
+
+    if (m_file.write(header) != header.size()) {
+        throw Pandaception(tr("Error saving file: ") + m_file.errorString());
+    }
+
+    m_buffer.reserve(blockSize * 2);
+    m_thread = std::thread(&VcdWriter::run, this);
+}
+
+VcdWriter::~VcdWriter()
+{
+    m_stop.store(true, std::memory_order_release);
+    m_thread.join();
+    m_file.close();
+}
+
+QByteArray VcdWriter::identifier(int signal)
+{
+    // Base 94, over the printable characters from '!' to '~'.
+    QByteArray id;
+
+    do {
+        id += static_cast<char>('!' + signal % 94);
+        signal /= 94;
+    } while (signal > 0);
+
+    return id;
+}
+
+void VcdWriter::setSlots(const QVector<int> &firstSlots)
+{
+    m_order.clear();
+    m_orderSlots.clear();
+
+    for (int signal = 0; signal < firstSlots.size(); ++signal) {
+        if (firstSlots.at(signal) >= 0) {
+            m_order.push_back(signal);
+        }
+    }
+
+    std::sort(m_order.begin(), m_order.end(), [&firstSlots](const int signal1, const int signal2) {
+        return firstSlots.at(signal1) < firstSlots.at(signal2);
+    });
+
+    for (const int signal : m_order) {
+        m_orderSlots.push_back(firstSlots.at(signal));
+    }
+
+    m_wordBegin.clear();
+    m_lastValues.clear();
+}
+
+void VcdWriter::sample(const quint64 time, const std::vector<quint64> &values)
+{
+    if (m_order.empty()) {
+        return;
+    }
+
+    quint64 shiftedTime = time + m_offset;
+
+    if (shiftedTime < m_lastTime) {
+        m_offset += m_lastTime - shiftedTime + 1;
+        shiftedTime = m_lastTime + 1;
+    }
+
+    m_lastTime = shiftedTime;
+
+    // Right after setSlots(), every signal is recorded.
+    if (m_lastValues.size() != values.size()) {
+        m_wordBegin.assign(values.size() + 1, 0);
+
+        for (size_t index = 0, word = 0; word <= values.size(); ++word) {
+            while ((index < m_orderSlots.size()) && (static_cast<size_t>(m_orderSlots[index] >> 6) < word)) {
+                ++index;
+            }
+
+            m_wordBegin[word] = static_cast<int>(index);
+        }
+
+        for (size_t index = 0; index < m_order.size(); ++index) {
+            const int slot = m_orderSlots[index];
+
+            if (static_cast<size_t>(slot >> 6) < values.size()) {
+                const quint64 value = (values[slot >> 6] >> (slot & 63)) & Netlist::widthMask(m_widths.at(m_order[index]));
+                push({shiftedTime, m_order[index], value});
+            }
+        }
+
+        m_lastValues = values;
+        return;
+    }
+
+    for (size_t word = 0; word < values.size(); ++word) {
+        const quint64 changed = values[word] ^ m_lastValues[word];
+
+        if (!changed) {
+            continue;
+        }
+
+        for (int index = m_wordBegin[word]; index < m_wordBegin[word + 1]; ++index) {
+            const int shift = m_orderSlots[index] & 63;
+            const quint64 mask = Netlist::widthMask(m_widths.at(m_order[index]));
+
+            if ((changed >> shift) & mask) {
+                push({shiftedTime, m_order[index], (values[word] >> shift) & mask});
+            }
+        }
+
+        m_lastValues[word] = values[word];
+    }
+}
+
+void VcdWriter::push(const Change &change)
+{
+    const int tail = m_tail.load(std::memory_order_relaxed);
+    const int next = (tail + 1) % ringSize;
+
+    // A full ring means the disk cannot keep up; nothing is dropped.
+    while (next == m_head.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    m_ring[tail] = change;
+    m_tail.store(next, std::memory_order_release);
+}
+
+void VcdWriter::write(const Change &change)
+{
+    if (!m_hasWrittenTime || (change.time != m_writtenTime)) {
+        m_buffer += '#';
+        m_buffer += QByteArray::number(change.time);
+        m_buffer += '\n';
+        m_writtenTime = change.time;
+        m_hasWrittenTime = true;
+    }
+
+    const int width = m_widths.at(change.signal);
+
+    if (width == 1) {
+        m_buffer += (change.value ? '1' : '0');
+    } else {
+        m_buffer += 'b';
+        m_buffer += QByteArray::number(change.value, 2);
+        m_buffer += ' ';
+    }
+
+    m_buffer += m_identifiers.at(change.signal);
+    m_buffer += '\n';
+}
+
+void VcdWriter::run()
+{
+    while (true) {
+        // Read before draining, so every record pushed before the writer was stopped gets written.
+        const bool stop = m_stop.load(std::memory_order_acquire);
+        int head = m_head.load(std::memory_order_relaxed);
+        const int tail = m_tail.load(std::memory_order_acquire);
+        const bool idle = (head == tail);
+
+        while (head != tail) {
+            write(m_ring[head]);
+            head = (head + 1) % ringSize;
+
+            if (m_buffer.size() >= blockSize) {
+                m_head.store(head, std::memory_order_release);
+                m_file.write(m_buffer);
+                m_buffer.clear();
+            }
+        }
+
+        m_head.store(head, std::memory_order_release);
+
+        if ((idle || stop) && !m_buffer.isEmpty()) {
+            m_file.write(m_buffer);
+            m_buffer.clear();
+        }
+
+        if (stop) {
+            break;
+        }
+
+        if (idle) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    m_file.flush();
+}
@@ -0,0 +1,86 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QVector>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Writes the changes of a set of netlist signals to a value change dump (VCD) file, as they happen.
+ *
+ * The simulation calls sample() after each update. It compares the words of the netlist values with the ones
+ * of the previous sample and, for the signals in the words that changed, appends a record to a single-producer
+ * single-consumer ring. A thread of the writer formats the records and writes them to disk in large blocks, so
+ * the simulation never waits for the disk and the memory used does not grow with the length of the trace.
+ *
+ * Time only goes forward in a VCD file. When the time of a sample goes back, as after the netlist is generated
+ * again or rewound, the following samples are shifted to come after the last one.
+ */
+class VcdWriter
+{
+    Q_DECLARE_TR_FUNCTIONS(VcdWriter)
+
+public:
+    struct Signal {
+        QString name;
+        int width = 1;
+    };
+
+    //! Opens @p fileName and writes the declarations of @p signalList. Throws a Pandaception if the file cannot be
+    //! written. Nothing is sampled before setSlots() is called.
+    VcdWriter(const QString &fileName, const QVector<Signal> &signalList, const QString &timescale = "1ns");
+
+    //! Writes the records still in the ring and closes the file.
+    ~VcdWriter();
+
+    //! Sets the first slot of each signal in the netlist sampled from now on, or -1 for a signal not in it. The
+    //! next sample records every signal again.
+    void setSlots(const QVector<int> &firstSlots);
+
+    //! Records the signals that changed since the last sample, at @p time. Waits only if the ring is full.
+    void sample(const quint64 time, const std::vector<quint64> &values);
+
+private:
+    Q_DISABLE_COPY(VcdWriter)
+
+    static constexpr int ringSize = 1 << 16;
+
+    struct Change {
+        quint64 time;
+        int signal;
+        quint64 value;
+    };
+
+    //! Short identifier of a signal, made of the printable characters allowed by the format.
+    static QByteArray identifier(int signal);
+
+    void push(const Change &change);
+    void run();
+    void write(const Change &change);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QVector<QByteArray> m_identifiers;
+    QVector<int> m_widths;
+    //! Signals sorted by first slot, along with the range of them in each word of the netlist values.
+    std::vector<int> m_order;
+    std::vector<int> m_orderSlots;
+    std::vector<int> m_wordBegin;
+    std::vector<quint64> m_lastValues;
+    std::array<Change, ringSize> m_ring;
+    alignas(64) std::atomic<int> m_head{0};
+    alignas(64) std::atomic<int> m_tail{0};
+    std::atomic<bool> m_stop{false};
+    quint64 m_lastTime = 0;
+    quint64 m_offset = 0;
+    quint64 m_writtenTime = 0;
+    bool m_hasWrittenTime = false;
+    std::thread m_thread;
+};
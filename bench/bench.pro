@@ -0,0 +1,12 @@
+include(../config.pri)
+
+TARGET = WPanda-bench
+
+SOURCES += \
+    benchmain.cpp \
+    benchmark.cpp \
+    circuitgenerator.cpp
+
+HEADERS += \
+    benchmark.h \
+    circuitgenerator.h
@@ -0,0 +1,165 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "benchmark.h"
+#include "circuitgenerator.h"
+#include "common.h"
+#include "globalproperties.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <functional>
+
+namespace
+{
+    struct BenchmarkCase
+    {
+        QString circuit;
+        int size;
+        //! Estimated gate count, compared against --max-gates.
+        int gates;
+        std::function<QString()> generate;
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    Comment::setVerbosity(-1);
+
+    // Nothing is shown, so the benchmark also runs on machines without a display.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    app.setOrganizationName("GIBIS-UNIFESP");
+    app.setApplicationName("WiRedPanda");
+    app.setApplicationVersion(APP_VERSION);
+
+    GlobalProperties::verbose = false;
+    QTextStream err(stderr);
+
+    try {
+        QCommandLineParser parser;
+        parser.setApplicationDescription(QCoreApplication::translate("main", "Generates synthetic circuits and times each stage they go through in WiRedPanda."));
+        parser.addHelpOption();
+        parser.addVersionOption();
+
+        QCommandLineOption outputOption(
+            {"o", "output"},
+            QCoreApplication::translate("main", "Save the results to <output> as JSON instead of printing them"),
+            QCoreApplication::translate("main", "output"));
+        parser.addOption(outputOption);
+
+        QCommandLineOption directoryOption(
+            {"d", "directory"},
+            QCoreApplication::translate("main", "Generate the circuits in <directory> and keep them, a temporary directory by default"),
+            QCoreApplication::translate("main", "directory"));
+        parser.addOption(directoryOption);
+
+        QCommandLineOption maxGatesOption(
+            {"g", "max-gates"},
+            QCoreApplication::translate("main", "Skip the circuits with more than <gates> gates, 100000 by default"),
+            QCoreApplication::translate("main", "gates"),
+            "100000");
+        parser.addOption(maxGatesOption);
+
+        QCommandLineOption tickTimeOption(
+            {"t", "tick-time"},
+            QCoreApplication::translate("main", "Count ticks for <ms> milliseconds per circuit, 1000 by default"),
+            QCoreApplication::translate("main", "ms"),
+            "1000");
+        parser.addOption(tickTimeOption);
+
+        parser.process(app);
+
+        const int maxGates = parser.value(maxGatesOption).toInt();
+        const int tickTime = parser.value(tickTimeOption).toInt();
+
+        if ((maxGates <= 0) || (tickTime <= 0)) {
+            throw Pandaception(QCoreApplication::translate("main", "--max-gates and --tick-time must be positive numbers."));
+        }
+
+        QTemporaryDir temporaryDir;
+        CircuitGenerator generator(parser.isSet(directoryOption) ? parser.value(directoryOption) : temporaryDir.path());
+        Benchmark benchmark{std::chrono::milliseconds(tickTime)};
+
+        QVector<BenchmarkCase> cases;
+
+        for (const int bits : {16, 256, 4096}) {
+            cases.append({"ripple-adder", bits, 5 * bits, [&generator, bits] { return generator.rippleAdder(bits); }});
+        }
+
+        for (const int bits : {8, 64, 1024}) {
+            cases.append({"counter", bits, bits, [&generator, bits] { return generator.counter(bits); }});
+        }
+
+        for (const int bits : {64, 1024, 16384}) {
+            cases.append({"shift-register", bits, bits, [&generator, bits] { return generator.shiftRegister(bits); }});
+        }
+
+        for (const int depth : {4, 8, 12}) {
+            cases.append({"nested-ic", depth, 1 << depth, [&generator, depth] { return generator.nestedIC(depth); }});
+        }
+
+        for (const int gates : {1000, 10000, 100000, 1000000}) {
+            cases.append({"random-dag", gates, gates, [&generator, gates] { return generator.randomDag(gates); }});
+        }
+
+        QJsonArray results;
+
+        for (const auto &benchmarkCase : cases) {
+            if (benchmarkCase.gates > maxGates) {
+                continue;
+            }
+
+            err << benchmarkCase.circuit << " " << benchmarkCase.size << "\n";
+            err.flush();
+
+            QElapsedTimer timer;
+            timer.start();
+            const QString fileName = benchmarkCase.generate();
+            const double generateMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+            QJsonObject result = benchmark.run(fileName);
+            result.insert("circuit", benchmarkCase.circuit);
+            result.insert("size", benchmarkCase.size);
+            result.insert("gates", benchmarkCase.gates);
+            result.insert("generateMs", generateMs);
+            results.append(result);
+        }
+
+        const QJsonObject report{
+            {"version", APP_VERSION},
+            {"qt", qVersion()},
+            {"tickTimeMs", tickTime},
+            {"results", results},
+        };
+
+        const QByteArray json = QJsonDocument(report).toJson();
+
+        if (const QString output = parser.value(outputOption); !output.isEmpty()) {
+            QFile file(output);
+
+            if (!file.open(QIODevice::WriteOnly)) {
+                throw Pandaception(QCoreApplication::translate("main", "Error opening file: ") + file.errorString());
+            }
+
+            file.write(json);
+        } else {
+            QTextStream(stdout) << json;
+        }
+    } catch (const std::exception &e) {
+        err << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "benchmark.h"
+
+#include "bewaveddolphin.h"
+#include "common.h"
+#include "globalproperties.h"
+#include "graphicelementinput.h"
+#include "netlist.h"
+#include "serialization.h"
+#include "simulation.h"
+#include "workspace.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+
+namespace
+{
+    //! Ticks run between two reads of the timer.
+    const int tickBatch = 16;
+
+    double milliseconds(const std::chrono::nanoseconds time)
+    {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+
+    double milliseconds(const QElapsedTimer &timer)
+    {
+        return milliseconds(std::chrono::nanoseconds(timer.nsecsElapsed()));
+    }
+}
+
+Benchmark::Benchmark(const std::chrono::milliseconds tickTime)
+    : m_tickTime(tickTime)
+{
+}
+
+QJsonObject Benchmark::run(const QString &fileName)
+{
+    QJsonObject result;
+    const QFileInfo fileInfo(fileName);
+
+    // ICs are looked for next to the circuit.
+    GlobalProperties::currentDir = fileInfo.absolutePath();
+
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw Pandaception(tr("Could not open file: ") + file.errorString());
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    const QVersionNumber version = Serialization::loadVersion(stream);
+    Serialization::loadDolphinFileName(stream, version);
+    Serialization::loadRect(stream, version);
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto items = Serialization::deserialize(stream, {}, version);
+    result.insert("loadMs", milliseconds(timer));
+
+    WorkSpace workspace;
+    auto *scene = workspace.scene();
+    timer.start();
+
+    for (auto *item : items) {
+        scene->addItem(item);
+    }
+
+    result.insert("sceneMs", milliseconds(timer));
+
+    const auto elements = scene->elements();
+    QVector<GraphicElementInput *> inputs;
+
+    for (auto *elm : elements) {
+        if (elm->elementGroup() == ElementGroup::Input) {
+            inputs.append(qobject_cast<GraphicElementInput *>(elm));
+        }
+    }
+
+    result.insert("elements", elements.size());
+    result.insert("inputs", inputs.size());
+
+    auto *simulation = workspace.simulation();
+    simulation->counters().reset();
+
+    if (!simulation->initialize()) {
+        throw Pandaception(tr("Nothing to simulate in ") + fileName);
+    }
+
+    const auto counters = simulation->counters().sample();
+    auto *netlist = simulation->netlist();
+    result.insert("logicElements", netlist->elementCount());
+    result.insert("mappingMs", milliseconds(counters.mappingTime));
+    result.insert("sortingMs", milliseconds(counters.sortingTime));
+
+    // One input is toggled before each tick, in turn, so every tick has something to evaluate.
+    const auto tickTime = std::chrono::duration_cast<std::chrono::nanoseconds>(m_tickTime).count();
+    const quint64 evaluations = netlist->evaluationCount();
+    quint64 ticks = 0;
+    timer.start();
+
+    while (timer.nsecsElapsed() < tickTime) {
+        for (int batch = 0; batch < tickBatch; ++batch, ++ticks) {
+            if (!inputs.isEmpty()) {
+                auto *logic = inputs.at(static_cast<int>(ticks % static_cast<quint64>(inputs.size())))->logic();
+                logic->setOutputValue(!logic->outputValue());
+                netlist->loadOutputs(logic);
+            }
+
+            netlist->update();
+        }
+    }
+
+    result.insert("ticksPerSecond", static_cast<double>(ticks) * 1e9 / static_cast<double>(timer.nsecsElapsed()));
+    result.insert("evaluationsPerTick", static_cast<double>(netlist->evaluationCount() - evaluations) / static_cast<double>(ticks));
+
+    // The ticks above toggled the logic behind the inputs' backs, so they are brought in line with it first, or
+    // about half of the toggles below would only write again the value the logic already holds.
+    for (auto *input : qAsConst(inputs)) {
+        input->setOn(input->logic()->outputValue());
+    }
+
+    // Through the simulation, the ports are repainted after every tick, as they are while the circuit is edited.
+    ticks = 0;
+    timer.start();
+
+    while (timer.nsecsElapsed() < tickTime) {
+        for (int batch = 0; batch < tickBatch; ++batch, ++ticks) {
+            if (!inputs.isEmpty()) {
+                auto *input = inputs.at(static_cast<int>(ticks % static_cast<quint64>(inputs.size())));
+                input->setOn(!input->isOn());
+            }
+
+            simulation->update();
+        }
+    }
+
+    result.insert("simulationTicksPerSecond", static_cast<double>(ticks) * 1e9 / static_cast<double>(timer.nsecsElapsed()));
+
+    const QString savedFileName = QDir(fileInfo.absolutePath()).absoluteFilePath(fileInfo.completeBaseName() + "-saved.panda");
+    timer.start();
+    workspace.save(savedFileName);
+    result.insert("saveMs", milliseconds(timer));
+    QFile::remove(savedFileName);
+
+    BewavedDolphin bewavedDolphin(scene, false);
+    timer.start();
+    bewavedDolphin.createWaveform("");
+    result.insert("waveformMs", milliseconds(timer));
+
+    return result;
+}
@@ -0,0 +1,31 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QJsonObject>
+
+#include <chrono>
+
+/**
+ * @brief Times the stages a circuit goes through in the application, from loading its file to its waveform.
+ *
+ * Each stage runs once, in order, on the same workspace: deserializing the file, adding its items to the
+ * scene, mapping and sorting the simulation layer, ticking the netlist alone and along with the repaint of the
+ * ports, saving the file again and generating the waveform of its inputs.
+ */
+class Benchmark
+{
+    Q_DECLARE_TR_FUNCTIONS(Benchmark)
+
+public:
+    //! Ticks are counted for @p tickTime each, first on the netlist alone, then through the simulation.
+    explicit Benchmark(const std::chrono::milliseconds tickTime);
+
+    //! Results of the circuit in @p fileName, as a JSON object with a field per stage and the times in milliseconds.
+    QJsonObject run(const QString &fileName);
+
+private:
+    const std::chrono::milliseconds m_tickTime;
+};
@@ -0,0 +1,230 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "circuitgenerator.h"
+
+#include "common.h"
+#include "elementfactory.h"
+#include "globalproperties.h"
+#include "graphicelement.h"
+#include "ic.h"
+#include "qneconnection.h"
+#include "serialization.h"
+
+#include <QDir>
+#include <QSaveFile>
+
+#include <random>
+
+namespace
+{
+    //! Elements are laid out in columns of this many, so the scene of a large circuit stays reasonably square.
+    const int columnSize = 256;
+}
+
+CircuitGenerator::CircuitGenerator(const QString &directory)
+    : m_directory(directory)
+{
+    if (!QDir().mkpath(m_directory)) {
+        throw Pandaception(tr("Could not create directory: ") + m_directory);
+    }
+}
+
+GraphicElement *CircuitGenerator::add(const ElementType type)
+{
+    auto *elm = ElementFactory::buildElement(type);
+    const int index = m_elements.size();
+    elm->setPos((index / columnSize) * 128, (index % columnSize) * 80);
+    m_elements.append(elm);
+    return elm;
+}
+
+void CircuitGenerator::connect(GraphicElement *from, const int outputPort, GraphicElement *to, const int inputPort)
+{
+    auto *connection = new QNEConnection();
+    connection->setStartPort(from->outputPort(outputPort));
+    connection->setEndPort(to->inputPort(inputPort));
+    m_connections.append(connection);
+}
+
+QString CircuitGenerator::save(const QString &name)
+{
+    const QString fileName = QDir(m_directory).absoluteFilePath(name + ".panda");
+    QSaveFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw Pandaception(tr("Error opening file: ") + file.errorString());
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    Serialization::saveHeader(stream, {}, {});
+    Serialization::serialize(m_elements + m_connections, stream);
+
+    if (!file.commit()) {
+        throw Pandaception(tr("Could not save file: ") + file.errorString());
+    }
+
+    // Connections first, as they detach themselves from the ports of the elements.
+    qDeleteAll(m_connections);
+    qDeleteAll(m_elements);
+    m_connections.clear();
+    m_elements.clear();
+
+    return fileName;
+}
+
+QString CircuitGenerator::rippleAdder(const int bits)
+{
+    GraphicElement *carry = add(ElementType::InputGnd);
+
+    for (int bit = 0; bit < bits; ++bit) {
+        auto *a = add(ElementType::InputSwitch);
+        auto *b = add(ElementType::InputSwitch);
+        auto *halfSum = add(ElementType::Xor);
+        auto *sum = add(ElementType::Xor);
+        auto *halfCarry = add(ElementType::And);
+        auto *carryPropagate = add(ElementType::And);
+        auto *carryOut = add(ElementType::Or);
+        auto *led = add(ElementType::Led);
+
+        a->setLabel(QString("a%1").arg(bit));
+        b->setLabel(QString("b%1").arg(bit));
+        led->setLabel(QString("s%1").arg(bit));
+
+        connect(a, 0, halfSum, 0);
+        connect(b, 0, halfSum, 1);
+        connect(halfSum, 0, sum, 0);
+        connect(carry, 0, sum, 1);
+        connect(a, 0, halfCarry, 0);
+        connect(b, 0, halfCarry, 1);
+        connect(halfSum, 0, carryPropagate, 0);
+        connect(carry, 0, carryPropagate, 1);
+        connect(halfCarry, 0, carryOut, 0);
+        connect(carryPropagate, 0, carryOut, 1);
+        connect(sum, 0, led, 0);
+        carry = carryOut;
+    }
+
+    auto *led = add(ElementType::Led);
+    led->setLabel("carry");
+    connect(carry, 0, led, 0);
+
+    return save(QString("ripple-adder-%1").arg(bits));
+}
+
+QString CircuitGenerator::counter(const int bits)
+{
+    auto *clock = add(ElementType::Clock);
+    auto *vcc = add(ElementType::InputVcc);
+    GraphicElement *previous = clock;
+    int previousPort = 0;
+
+    for (int bit = 0; bit < bits; ++bit) {
+        auto *flipFlop = add(ElementType::TFlipFlop);
+        auto *led = add(ElementType::Led);
+
+        connect(vcc, 0, flipFlop, 0);
+        connect(previous, previousPort, flipFlop, 1);
+        connect(flipFlop, 0, led, 0);
+
+        // Each bit toggles when the previous one goes from 1 to 0, that is, on the rising edge of its ~Q.
+        previous = flipFlop;
+        previousPort = 1;
+    }
+
+    return save(QString("counter-%1").arg(bits));
+}
+
+QString CircuitGenerator::shiftRegister(const int bits)
+{
+    auto *clock = add(ElementType::Clock);
+    GraphicElement *previous = add(ElementType::InputSwitch);
+
+    for (int bit = 0; bit < bits; ++bit) {
+        auto *flipFlop = add(ElementType::DFlipFlop);
+        auto *led = add(ElementType::Led);
+
+        connect(previous, 0, flipFlop, 0);
+        connect(clock, 0, flipFlop, 1);
+        connect(flipFlop, 0, led, 0);
+        previous = flipFlop;
+    }
+
+    return save(QString("shift-register-%1").arg(bits));
+}
+
+QString CircuitGenerator::nestedIC(const int depth)
+{
+    // The ICs of each level are loaded from the files of the level below, looked for in the current directory.
+    const QString previousDir = GlobalProperties::currentDir;
+    GlobalProperties::currentDir = m_directory;
+    QString fileName;
+
+    for (int level = 0; level <= depth; ++level) {
+        auto *a = add(ElementType::InputSwitch);
+        auto *b = add(ElementType::InputSwitch);
+        auto *led = add(ElementType::Led);
+
+        a->setLabel("a");
+        b->setLabel("b");
+        led->setLabel("out");
+
+        if (level == 0) {
+            auto *gate = add(ElementType::Xor);
+            connect(a, 0, gate, 0);
+            connect(b, 0, gate, 1);
+            connect(gate, 0, led, 0);
+        } else {
+            auto *first = qobject_cast<IC *>(add(ElementType::IC));
+            auto *second = qobject_cast<IC *>(add(ElementType::IC));
+            first->loadFile(fileName);
+            second->loadFile(fileName);
+
+            connect(a, 0, first, 0);
+            connect(b, 0, first, 1);
+            connect(first, 0, second, 0);
+            connect(b, 0, second, 1);
+            connect(second, 0, led, 0);
+        }
+
+        fileName = save(QString("nested-ic-%1").arg(level));
+    }
+
+    GlobalProperties::currentDir = previousDir;
+    return fileName;
+}
+
+QString CircuitGenerator::randomDag(const int gates, const quint32 seed)
+{
+    const int inputCount = 32;
+    const ElementType types[] = {ElementType::And, ElementType::Or, ElementType::Nand, ElementType::Nor, ElementType::Xor, ElementType::Xnor};
+
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> typeDistribution(0, static_cast<int>(std::size(types)) - 1);
+    QVector<GraphicElement *> sources;
+    sources.reserve(inputCount + gates);
+
+    for (int input = 0; input < inputCount; ++input) {
+        auto *inputSwitch = add(ElementType::InputSwitch);
+        inputSwitch->setLabel(QString("in%1").arg(input));
+        sources.append(inputSwitch);
+    }
+
+    for (int gate = 0; gate < gates; ++gate) {
+        auto *elm = add(types[typeDistribution(random)]);
+        std::uniform_int_distribution<int> sourceDistribution(0, sources.size() - 1);
+
+        connect(sources.at(sourceDistribution(random)), 0, elm, 0);
+        connect(sources.at(sourceDistribution(random)), 0, elm, 1);
+        sources.append(elm);
+    }
+
+    for (int output = 0; output < qMin(inputCount, gates); ++output) {
+        auto *led = add(ElementType::Led);
+        led->setLabel(QString("out%1").arg(output));
+        connect(sources.at(sources.size() - 1 - output), 0, led, 0);
+    }
+
+    return save(QString("random-dag-%1").arg(gates));
+}
@@ -0,0 +1,54 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "enums.h"
+
+#include <QCoreApplication>
+#include <QList>
+
+class GraphicElement;
+class QGraphicsItem;
+
+/**
+ * @brief Writes parameterized synthetic circuits as panda files, for benchmarking.
+ *
+ * The elements of a circuit are built and serialized straight to the file, without a scene, so generating a
+ * large circuit costs little more than loading it afterwards. Every function returns the path of the file.
+ */
+class CircuitGenerator
+{
+    Q_DECLARE_TR_FUNCTIONS(CircuitGenerator)
+
+public:
+    //! Files are written to @p directory, which is also where the ICs of nestedIC() are looked for.
+    explicit CircuitGenerator(const QString &directory);
+
+    //! @p bits switches per operand, chained full adders and a LED per sum bit and for the carry.
+    QString rippleAdder(const int bits);
+
+    //! Asynchronous counter of @p bits T flip-flops, driven by a clock.
+    QString counter(const int bits);
+
+    //! Shift register of @p bits D flip-flops, fed by a switch and driven by a clock.
+    QString shiftRegister(const int bits);
+
+    //! An IC holding two ICs of the level below, @p depth levels deep, down to a single XOR gate.
+    QString nestedIC(const int depth);
+
+    //! @p gates random gates, each fed by two earlier gates or by one of 32 switches, the last 32 of them on LEDs.
+    QString randomDag(const int gates, const quint32 seed = 1);
+
+private:
+    Q_DISABLE_COPY(CircuitGenerator)
+
+    GraphicElement *add(const ElementType type);
+    void connect(GraphicElement *from, const int outputPort, GraphicElement *to, const int inputPort);
+    //! Serializes and deletes the elements and connections built since the last save.
+    QString save(const QString &name);
+
+    QList<QGraphicsItem *> m_connections;
+    QList<QGraphicsItem *> m_elements;
+    QString m_directory;
+};
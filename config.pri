@@ -105,7 +105,17 @@ OBJECTS_DIR    = build_files/obj
 RCC_DIR        = build_files/rcc
 
 include(app/element/element.pri)
-include(app/logicelement/logicelement.pri)
+
+# The simulation core is compiled once, into the wpanda-sim library, and linked from there.
+SIM_OUT_PWD = $$shadowed($$PWD)/sim
+
+win32:CONFIG(release, debug|release): SIM_OUT_PWD = $$SIM_OUT_PWD/release
+else:win32:CONFIG(debug, debug|release): SIM_OUT_PWD = $$SIM_OUT_PWD/debug
+
+LIBS += -L$$SIM_OUT_PWD -lwpanda-sim
+
+msvc: PRE_TARGETDEPS += $$SIM_OUT_PWD/wpanda-sim.lib
+else: PRE_TARGETDEPS += $$SIM_OUT_PWD/libwpanda-sim.a
 
 SOURCES += \
     $$PWD/app/application.cpp \
@@ -113,18 +123,17 @@ SOURCES += \
     $$PWD/app/bewaveddolphin.cpp \
     $$PWD/app/clockdialog.cpp \
     $$PWD/app/commands.cpp \
-    $$PWD/app/common.cpp \
+    $$PWD/app/commongraphics.cpp \
     $$PWD/app/elementeditor.cpp \
     $$PWD/app/elementfactory.cpp \
     $$PWD/app/elementlabel.cpp \
     $$PWD/app/elementmapping.cpp \
-    $$PWD/app/enums.cpp \
     $$PWD/app/graphicelement.cpp \
     $$PWD/app/graphicsview.cpp \
     $$PWD/app/ic.cpp \
     $$PWD/app/itemwithid.cpp \
     $$PWD/app/lengthdialog.cpp \
-    $$PWD/app/logicelement.cpp \
+    $$PWD/app/logicelement/logicremotedevice.cpp \
     $$PWD/app/mainwindow.cpp \
     $$PWD/app/protocol.cpp \
     $$PWD/app/nodes/qneconnection.cpp \
@@ -136,6 +145,8 @@ SOURCES += \
     $$PWD/app/settings.cpp \
     $$PWD/app/simulation.cpp \
     $$PWD/app/simulationblocker.cpp \
+    $$PWD/app/simulationcounters.cpp \
+    $$PWD/app/simulationthread.cpp \
     $$PWD/app/thememanager.cpp \
     $$PWD/app/trashbutton.cpp \
     $$PWD/app/workspace.cpp
@@ -146,20 +157,17 @@ HEADERS += \
     $$PWD/app/bewaveddolphin.h \
     $$PWD/app/clockdialog.h \
     $$PWD/app/commands.h \
-    $$PWD/app/common.h \
     $$PWD/app/elementeditor.h \
     $$PWD/app/elementfactory.h \
     $$PWD/app/elementlabel.h \
     $$PWD/app/elementmapping.h \
-    $$PWD/app/enums.h \
-    $$PWD/app/globalproperties.h \
     $$PWD/app/graphicelement.h \
     $$PWD/app/graphicelementinput.h \
     $$PWD/app/graphicsview.h \
     $$PWD/app/ic.h \
     $$PWD/app/itemwithid.h \
     $$PWD/app/lengthdialog.h \
-    $$PWD/app/logicelement.h \
+    $$PWD/app/logicelement/logicremotedevice.h \
     $$PWD/app/mainwindow.h \
     $$PWD/app/network.h \
     $$PWD/app/protocol.h \
@@ -172,6 +180,8 @@ HEADERS += \
     $$PWD/app/settings.h \
     $$PWD/app/simulation.h \
     $$PWD/app/simulationblocker.h \
+    $$PWD/app/simulationcounters.h \
+    $$PWD/app/simulationthread.h \
     $$PWD/app/thememanager.h \
     $$PWD/app/trashbutton.h \
     $$PWD/app/workspace.h
@@ -181,7 +191,8 @@ INCLUDEPATH += \
     $$PWD/app/arduino \
     $$PWD/app/element \
     $$PWD/app/logicelement \
-    $$PWD/app/nodes
+    $$PWD/app/nodes \
+    $$PWD/sim
 
 FORMS += \
     $$PWD/app/bewaveddolphin.ui \
@@ -0,0 +1,183 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "andinvertergraph.h"
+
+#include "common.h"
+#include "netlist.h"
+
+#include <algorithm>
+
+AndInverterGraph::AndInverterGraph()
+    : m_nodes(1)
+{
+}
+
+int AndInverterGraph::nodeCount() const
+{
+    return static_cast<int>(m_nodes.size());
+}
+
+bool AndInverterGraph::isInput(const int node) const
+{
+    return (node > 0) && (m_nodes.at(node).fanin0 < 0);
+}
+
+int AndInverterGraph::fanin0(const int node) const
+{
+    return m_nodes.at(node).fanin0;
+}
+
+int AndInverterGraph::fanin1(const int node) const
+{
+    return m_nodes.at(node).fanin1;
+}
+
+int AndInverterGraph::createInput()
+{
+    m_nodes.emplace_back();
+    return 2 * (nodeCount() - 1);
+}
+
+int AndInverterGraph::createAnd(int literal0, int literal1)
+{
+    if (literal0 > literal1) {
+        std::swap(literal0, literal1);
+    }
+
+    if ((literal0 == falseLiteral) || (literal0 == (literal1 ^ 1))) {
+        return falseLiteral;
+    }
+
+    if ((literal0 == trueLiteral) || (literal0 == literal1)) {
+        return literal1;
+    }
+
+    const quint64 key = (static_cast<quint64>(literal0) << 32) | static_cast<quint32>(literal1);
+
+    if (const int literal = m_hash.value(key, -1); literal >= 0) {
+        return literal;
+    }
+
+    m_nodes.push_back({literal0, literal1});
+    const int literal = 2 * (nodeCount() - 1);
+    m_hash.insert(key, literal);
+
+    return literal;
+}
+
+int AndInverterGraph::createOr(const int literal0, const int literal1)
+{
+    return createAnd(literal0 ^ 1, literal1 ^ 1) ^ 1;
+}
+
+int AndInverterGraph::createXor(const int literal0, const int literal1)
+{
+    return createOr(createAnd(literal0, literal1 ^ 1), createAnd(literal0 ^ 1, literal1));
+}
+
+int AndInverterGraph::createMux(const int choice, const int whenTrue, const int whenFalse)
+{
+    return createOr(createAnd(choice, whenTrue), createAnd(choice ^ 1, whenFalse));
+}
+
+std::vector<int> AndInverterGraph::addNetlist(const Netlist &netlist, const QHash<int, int> &inputs)
+{
+    if (!netlist.isCombinational() || netlist.m_hasCustom) {
+        throw Pandaception(tr("Only combinational circuits without custom elements can be turned into an and-inverter graph."));
+    }
+
+    // Slots start at their current value, which is what input elements that are not in inputs keep. The constant
+    // slots after the element outputs are included, as gates may read them.
+    const auto slotCount = static_cast<int>(netlist.values().size()) * 64;
+    std::vector<int> literals(static_cast<size_t>(slotCount));
+
+    for (int slot = 0; slot < slotCount; ++slot) {
+        literals[slot] = inputs.value(slot, netlist.value(slot) ? trueLiteral : falseLiteral);
+    }
+
+    const auto reduce = [&](const int *fanin, const int faninCount, const int bit, const auto &operation, int result) {
+        for (int index = 0; index < faninCount; ++index) {
+            result = operation(result, literals[fanin[index] + bit]);
+        }
+
+        return result;
+    };
+
+    const auto andOf = [this](const int literal0, const int literal1) { return createAnd(literal0, literal1); };
+    const auto orOf = [this](const int literal0, const int literal1) { return createOr(literal0, literal1); };
+    const auto xorOf = [this](const int literal0, const int literal1) { return createXor(literal0, literal1); };
+
+    // Same operations as Netlist::evaluateLanes(), one literal per slot instead of one word.
+    for (int element = 0; element < netlist.elementCount(); ++element) {
+        const int *fanin = netlist.m_fanin.data() + netlist.m_faninBegin[element];
+        const int faninCount = netlist.m_faninBegin[element + 1] - netlist.m_faninBegin[element];
+        const int width = netlist.m_outputEnd[element] - netlist.m_outputBegin[element];
+        int *output = literals.data() + netlist.m_outputBegin[element];
+
+        switch (netlist.m_types[element]) {
+        case LogicType::And:  *output = reduce(fanin, faninCount, 0, andOf, trueLiteral);      break;
+        case LogicType::Nand: *output = reduce(fanin, faninCount, 0, andOf, trueLiteral) ^ 1;  break;
+        case LogicType::Or:   *output = reduce(fanin, faninCount, 0, orOf, falseLiteral);      break;
+        case LogicType::Nor:  *output = reduce(fanin, faninCount, 0, orOf, falseLiteral) ^ 1;  break;
+        case LogicType::Xor:  *output = reduce(fanin, faninCount, 0, xorOf, falseLiteral);     break;
+        case LogicType::Xnor: *output = reduce(fanin, faninCount, 0, xorOf, falseLiteral) ^ 1; break;
+        case LogicType::Node: *output = literals[fanin[0]];                                    break;
+        case LogicType::Not:  *output = literals[fanin[0]] ^ 1;                                break;
+        case LogicType::Mux:  *output = createMux(literals[fanin[2]], literals[fanin[1]], literals[fanin[0]]); break;
+
+        case LogicType::Demux:
+            output[0] = createAnd(literals[fanin[0]], literals[fanin[1]] ^ 1);
+            output[1] = createAnd(literals[fanin[0]], literals[fanin[1]]);
+            break;
+
+        case LogicType::Joiner:
+        case LogicType::Output:
+            for (int index = 0; index < faninCount; ++index) {
+                output[index] = literals[fanin[index]];
+            }
+            break;
+
+        case LogicType::BusAnd:
+            for (int bit = 0; bit < width; ++bit) {
+                output[bit] = reduce(fanin, faninCount, bit, andOf, trueLiteral);
+            }
+            break;
+
+        case LogicType::BusOr:
+            for (int bit = 0; bit < width; ++bit) {
+                output[bit] = reduce(fanin, faninCount, bit, orOf, falseLiteral);
+            }
+            break;
+
+        case LogicType::BusXor:
+            for (int bit = 0; bit < width; ++bit) {
+                output[bit] = reduce(fanin, faninCount, bit, xorOf, falseLiteral);
+            }
+            break;
+
+        case LogicType::BusNot:
+            for (int bit = 0; bit < width; ++bit) {
+                output[bit] = literals[fanin[0] + bit] ^ 1;
+            }
+            break;
+
+        case LogicType::BusMux:
+            for (int bit = 0; bit < width; ++bit) {
+                output[bit] = createMux(literals[fanin[2]], literals[fanin[1] + bit], literals[fanin[0] + bit]);
+            }
+            break;
+
+        case LogicType::Splitter:
+            for (int bit = 0; bit < width; ++bit) {
+                output[bit] = literals[fanin[0] + bit];
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return literals;
+}
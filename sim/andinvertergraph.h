@@ -0,0 +1,60 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QHash>
+
+#include <vector>
+
+class Netlist;
+
+/**
+ * @brief Combinational logic as a graph of two-input AND nodes and complemented edges.
+ *
+ * A literal is twice the index of a node, plus one when complemented; node 0 is the constant false, so literal 0
+ * is false and literal 1 is true. Nodes are created in topological order and structurally hashed: asking twice
+ * for the AND of the same literals returns the same node, and ANDs with a constant, of a literal with itself or
+ * with its complement are simplified away. Several netlists may be added to the same graph over shared inputs,
+ * so their identical parts end up as the same nodes.
+ */
+class AndInverterGraph
+{
+    Q_DECLARE_TR_FUNCTIONS(AndInverterGraph)
+
+public:
+    static constexpr int falseLiteral = 0;
+    static constexpr int trueLiteral = 1;
+
+    AndInverterGraph();
+
+    static int node(const int literal) { return literal >> 1; }
+    static bool isComplemented(const int literal) { return (literal & 1) != 0; }
+
+    int nodeCount() const;
+    bool isInput(const int node) const;
+    //! Literals the AND @p node is the conjunction of.
+    int fanin0(const int node) const;
+    int fanin1(const int node) const;
+
+    int createInput();
+    int createAnd(int literal0, int literal1);
+    int createOr(const int literal0, const int literal1);
+    int createXor(const int literal0, const int literal1);
+    int createMux(const int choice, const int whenTrue, const int whenFalse);
+
+    //! Adds @p netlist and returns the literal of each of its slots. The slots in @p inputs take the given
+    //! literals; the other input elements, like constants, keep their current value. Throws a Pandaception for
+    //! netlists that are not combinational or have custom elements.
+    std::vector<int> addNetlist(const Netlist &netlist, const QHash<int, int> &inputs);
+
+private:
+    struct Node {
+        int fanin0 = -1;
+        int fanin1 = -1;
+    };
+
+    std::vector<Node> m_nodes;
+    QHash<quint64, int> m_hash;
+};
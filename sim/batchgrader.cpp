@@ -0,0 +1,269 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "batchgrader.h"
+
+#include "common.h"
+#include "headlesscircuit.h"
+#include "netlist.h"
+#include "threadpool.h"
+#include "waveformreader.h"
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <memory>
+
+BatchGrader::BatchGrader(const QString &manifestFileName)
+{
+    QFile file(manifestFileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw Pandaception(tr("Error opening file: ") + file.errorString());
+    }
+
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(file.readAll(), &error);
+
+    if (error.error != QJsonParseError::NoError) {
+        throw Pandaception(tr("Invalid manifest: ") + error.errorString());
+    }
+
+    const QDir directory = QFileInfo(manifestFileName).absoluteDir();
+
+    for (const auto &value : document.object().value("jobs").toArray()) {
+        const auto job = value.toObject();
+
+        m_jobs.append({directory.absoluteFilePath(job.value("circuit").toString()),
+                       directory.absoluteFilePath(job.value("stimulus").toString()),
+                       directory.absoluteFilePath(job.value("golden").toString())});
+    }
+}
+
+BatchGrader::BatchGrader(const QVector<Job> &jobs)
+    : m_jobs(jobs)
+{
+}
+
+const QVector<BatchGrader::Job> &BatchGrader::jobs() const
+{
+    return m_jobs;
+}
+
+void BatchGrader::setNative(const bool native)
+{
+    m_native = native;
+}
+
+QVector<BatchGrader::Result> BatchGrader::run() const
+{
+    // Jobs of each circuit, in the order of the manifest.
+    QVector<QVector<int>> circuits;
+    QHash<QString, int> circuitIndex;
+
+    for (int job = 0; job < m_jobs.size(); ++job) {
+        const QString fileName = QFileInfo(m_jobs.at(job).circuit).absoluteFilePath();
+        auto index = circuitIndex.find(fileName);
+
+        if (index == circuitIndex.end()) {
+            index = circuitIndex.insert(fileName, circuits.size());
+            circuits.append({});
+        }
+
+        circuits[*index].append(job);
+    }
+
+    QVector<Result> results(m_jobs.size());
+    Result *resultData = results.data();
+
+    ThreadPool::instance().run(circuits.size(), [&](const int index) {
+        const auto &jobs = circuits.at(index);
+        std::unique_ptr<HeadlessCircuit> circuit;
+
+        try {
+            circuit = std::make_unique<HeadlessCircuit>(m_jobs.at(jobs.constFirst()).circuit);
+            // Circuits are already graded in parallel, and a loop on the pool cannot start another one.
+            circuit->netlist()->setParallel(false);
+
+            // Combinational circuits are graded on lanes, which native code does not run.
+            if (m_native && !circuit->netlist()->isCombinational()) {
+                circuit->netlist()->setNative(true);
+            }
+        } catch (const std::exception &e) {
+            for (const int job : jobs) {
+                resultData[job].error = QString::fromUtf8(e.what());
+            }
+
+            return;
+        }
+
+        for (const int job : jobs) {
+            try {
+                circuit->reset();
+                resultData[job] = grade(*circuit, m_jobs.at(job));
+            } catch (const std::exception &e) {
+                resultData[job].error = QString::fromUtf8(e.what());
+            }
+        }
+    });
+
+    return results;
+}
+
+BatchGrader::Result BatchGrader::grade(HeadlessCircuit &circuit, const Job &job) const
+{
+    const Waveform stimulus = WaveformReader::read(job.stimulus);
+    const Waveform golden = WaveformReader::read(job.golden);
+    const int inputCount = circuit.inputCount();
+    const int outputCount = circuit.outputCount();
+
+    if (golden.rows != inputCount + outputCount) {
+        throw Pandaception(tr("The golden trace has %1 rows, but the circuit has %2 inputs and %3 outputs.").arg(golden.rows).arg(inputCount).arg(outputCount));
+    }
+
+    if (golden.columns != stimulus.columns) {
+        throw Pandaception(tr("The golden trace has %1 columns, but the stimulus has %2.").arg(golden.columns).arg(stimulus.columns));
+    }
+
+    const int columns = stimulus.columns;
+    const int words = (columns + 63) / 64;
+    auto *netlist = circuit.netlist();
+
+    Result result;
+    result.columns = columns;
+    result.native = netlist->isNative();
+
+    // Rows past the inputs of the circuit are ignored and missing ones stay at 0, as in beWavedDolphin. Outputs
+    // that are not connected stay at 0 as well.
+    Waveform outputs;
+    outputs.resize(outputCount, columns);
+
+    if (netlist->isCombinational()) {
+        auto lanes = netlist->lanes();
+
+        for (int word = 0; word < words; ++word) {
+            for (int input = 0; input < inputCount; ++input) {
+                lanes[circuit.inputSlot(input)] = (input < stimulus.rows) ? stimulus.words.at(input).at(word) : 0;
+            }
+
+            netlist->updateLanes(lanes);
+
+            for (int output = 0; output < outputCount; ++output) {
+                if (const int slot = circuit.outputSlot(output); slot >= 0) {
+                    outputs.words[output][word] = lanes[slot];
+                }
+            }
+        }
+    } else {
+        for (int column = 0; column < columns; ++column) {
+            for (int input = 0; input < inputCount; ++input) {
+                circuit.setInput(input, (input < stimulus.rows) && stimulus.at(input, column));
+            }
+
+            if (netlist->evaluateUntilStable(maxIterations) < 0) {
+                ++result.unsettledColumns;
+            }
+
+            for (int output = 0; output < outputCount; ++output) {
+                if (const int slot = circuit.outputSlot(output); slot >= 0) {
+                    outputs.set(output, column, netlist->value(slot));
+                }
+            }
+        }
+    }
+
+    for (int word = 0; word < words; ++word) {
+        const quint64 mask = ((word + 1) * 64 <= columns) ? ~quint64(0) : (quint64(1) << (columns % 64)) - 1;
+        quint64 difference = 0;
+
+        for (int output = 0; output < outputCount; ++output) {
+            const quint64 outputDifference = (outputs.words.at(output).at(word) ^ golden.words.at(inputCount + output).at(word)) & mask;
+            result.mismatches += qPopulationCount(outputDifference);
+            difference |= outputDifference;
+        }
+
+        if ((result.firstColumn < 0) && (difference != 0)) {
+            result.firstColumn = word * 64 + qCountTrailingZeroBits(difference);
+
+            for (int output = 0; output < outputCount; ++output) {
+                if (outputs.at(output, result.firstColumn) != golden.at(inputCount + output, result.firstColumn)) {
+                    result.firstOutput = circuit.outputLabels().at(output);
+                    result.expected = golden.at(inputCount + output, result.firstColumn);
+                    result.actual = !result.expected;
+                    break;
+                }
+            }
+        }
+    }
+
+    result.status = (result.mismatches == 0) ? Result::Status::Passed : Result::Status::Failed;
+    return result;
+}
+
+QJsonObject BatchGrader::toJson(const QVector<Result> &results) const
+{
+    QJsonArray array;
+    int passed = 0;
+    int failed = 0;
+
+    for (int index = 0; index < results.size(); ++index) {
+        const auto &job = m_jobs.at(index);
+        const auto &result = results.at(index);
+
+        QJsonObject object{
+            {"circuit", job.circuit},
+            {"stimulus", job.stimulus},
+            {"golden", job.golden},
+        };
+
+        switch (result.status) {
+        case Result::Status::Passed: object.insert("status", "passed"); ++passed; break;
+        case Result::Status::Failed: object.insert("status", "failed"); ++failed; break;
+        case Result::Status::Error:  object.insert("status", "error"); break;
+        }
+
+        if (result.status == Result::Status::Error) {
+            object.insert("error", result.error);
+        } else {
+            object.insert("columns", result.columns);
+            object.insert("mismatches", result.mismatches);
+            object.insert("unsettledColumns", result.unsettledColumns);
+            object.insert("native", result.native);
+        }
+
+        if (result.firstColumn >= 0) {
+            object.insert("firstDivergence", QJsonObject{
+                {"column", result.firstColumn},
+                {"output", result.firstOutput},
+                {"expected", static_cast<int>(result.expected)},
+                {"actual", static_cast<int>(result.actual)},
+            });
+        }
+
+        array.append(object);
+    }
+
+    return {
+        {"version", APP_VERSION},
+        {"jobs", results.size()},
+        {"passed", passed},
+        {"failed", failed},
+        {"errors", results.size() - passed - failed},
+        {"results", array},
+    };
+}
+
+void BatchGrader::save(const QString &fileName) const
+{
+    const auto results = run();
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw Pandaception(tr("Error opening file: ") + file.errorString());
+    }
+
+    file.write(QJsonDocument(toJson(results)).toJson());
+}
@@ -0,0 +1,85 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QJsonObject>
+#include <QVector>
+
+class HeadlessCircuit;
+
+/**
+ * @brief Grades many circuits against many stimulus files in a single process.
+ *
+ * A manifest lists jobs, each a panda file, a stimulus and the golden trace its outputs are expected to follow.
+ * Stimuli are beWavedDolphin files, .dolphin or .csv, and golden traces are what -w and -c print: a CSV with the
+ * inputs followed by the outputs, one row per signal and one column per step. Jobs of the same circuit share a
+ * single HeadlessCircuit, reset between them, and circuits are graded in parallel on the ThreadPool.
+ *
+ * Outputs are packed 64 steps per word and compared with the golden trace a word at a time. Combinational circuits
+ * are evaluated on the lanes of the netlist, 64 steps at once; the others are settled step by step, as
+ * beWavedDolphin does.
+ */
+class BatchGrader
+{
+    Q_DECLARE_TR_FUNCTIONS(BatchGrader)
+
+public:
+    struct Job {
+        QString circuit;
+        QString stimulus;
+        QString golden;
+    };
+
+    struct Result {
+        enum class Status { Passed, Failed, Error };
+
+        Status status = Status::Error;
+        int columns = 0;
+        //! Steps and outputs that differ from the golden trace.
+        int mismatches = 0;
+        //! Steps that did not settle, as happens when the circuit oscillates.
+        int unsettledColumns = 0;
+        //! Whether the steps ran as native code, which only sequential circuits graded with setNative() do.
+        bool native = false;
+        //! First step that differs from the golden trace, and its first output that does, or -1 if none does.
+        int firstColumn = -1;
+        QString firstOutput;
+        bool expected = false;
+        bool actual = false;
+        QString error;
+    };
+
+    //! Reads the jobs of the JSON manifest @p fileName, whose paths are relative to it. Throws a Pandaception if it
+    //! cannot be read.
+    explicit BatchGrader(const QString &manifestFileName);
+    explicit BatchGrader(const QVector<Job> &jobs);
+
+    const QVector<Job> &jobs() const;
+
+    //! Runs sequential circuits as native code built by the system compiler, for long stimuli. Circuits stay on
+    //! the interpreter when no compiler is found or a build fails.
+    void setNative(const bool native);
+
+    //! Grades every job. Errors of a job, like a missing file, are reported in its result instead of thrown.
+    QVector<Result> run() const;
+
+    //! Summary and result of every job, in the order of the manifest.
+    QJsonObject toJson(const QVector<Result> &results) const;
+
+    //! Grades every job and writes the results to @p fileName as JSON. Throws a Pandaception if it cannot be
+    //! written.
+    void save(const QString &fileName) const;
+
+private:
+    Q_DISABLE_COPY(BatchGrader)
+
+    //! Updates a sequential circuit may take to settle at each step, as in Simulation::evaluateUntilStable().
+    static constexpr int maxIterations = 64;
+
+    Result grade(HeadlessCircuit &circuit, const Job &job) const;
+
+    QVector<Job> m_jobs;
+    bool m_native = false;
+};
@@ -0,0 +1,301 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "equivalencechecker.h"
+
+#include "andinvertergraph.h"
+#include "common.h"
+#include "headlesscircuit.h"
+#include "netlist.h"
+#include "satsolver.h"
+
+#include <QHash>
+#include <QPair>
+#include <QRandomGenerator>
+
+namespace
+{
+    //! Each label with the number of times it appeared before, so repeated labels are matched in order.
+    QVector<QPair<QString, int>> occurrences(const QStringList &labels)
+    {
+        QVector<QPair<QString, int>> keys;
+        QHash<QString, int> count;
+
+        for (const auto &label : labels) {
+            keys.append({label, count[label]++});
+        }
+
+        return keys;
+    }
+
+    quint64 slotValue(const std::vector<quint64> &lanes, const int slot)
+    {
+        return (slot >= 0) ? lanes[slot] : 0;
+    }
+
+    int slotLiteral(const std::vector<int> &literals, const int slot)
+    {
+        return (slot >= 0) ? literals[slot] : AndInverterGraph::falseLiteral;
+    }
+}
+
+EquivalenceChecker::EquivalenceChecker(const HeadlessCircuit &first, const HeadlessCircuit &second)
+    : m_first(first)
+    , m_second(second)
+{
+    if (!first.netlist()->isCombinational() || !second.netlist()->isCombinational()) {
+        throw Pandaception(tr("The equivalence check needs combinational circuits, without memory elements nor feedback."));
+    }
+
+    const auto firstInputs = occurrences(first.inputLabels());
+    const auto secondInputs = occurrences(second.inputLabels());
+
+    for (int index = 0; index < firstInputs.size(); ++index) {
+        const int secondIndex = secondInputs.indexOf(firstInputs.at(index));
+
+        m_inputLabels.append(first.inputLabels().at(index));
+        m_firstInputSlots.append(first.inputSlot(index));
+        m_secondInputSlots.append((secondIndex >= 0) ? second.inputSlot(secondIndex) : -1);
+    }
+
+    for (int index = 0; index < secondInputs.size(); ++index) {
+        if (!firstInputs.contains(secondInputs.at(index))) {
+            m_inputLabels.append(second.inputLabels().at(index));
+            m_firstInputSlots.append(-1);
+            m_secondInputSlots.append(second.inputSlot(index));
+        }
+    }
+
+    const auto firstOutputs = occurrences(first.outputLabels());
+    const auto secondOutputs = occurrences(second.outputLabels());
+    QStringList unmatched;
+
+    for (int index = 0; index < firstOutputs.size(); ++index) {
+        if (const int secondIndex = secondOutputs.indexOf(firstOutputs.at(index)); secondIndex >= 0) {
+            m_outputLabels.append(first.outputLabels().at(index));
+            m_firstOutputSlots.append(first.outputSlot(index));
+            m_secondOutputSlots.append(second.outputSlot(secondIndex));
+        } else {
+            unmatched.append(first.outputLabels().at(index));
+        }
+    }
+
+    for (int index = 0; index < secondOutputs.size(); ++index) {
+        if (!firstOutputs.contains(secondOutputs.at(index))) {
+            unmatched.append(second.outputLabels().at(index));
+        }
+    }
+
+    if (!unmatched.isEmpty()) {
+        throw Pandaception(tr("Outputs only one of the circuits has: ") + unmatched.join(", "));
+    }
+}
+
+const QStringList &EquivalenceChecker::inputLabels() const
+{
+    return m_inputLabels;
+}
+
+EquivalenceChecker::Result EquivalenceChecker::run() const
+{
+    Result result;
+
+    if (!simulate(result)) {
+        prove(result);
+    }
+
+    return result;
+}
+
+bool EquivalenceChecker::simulate(Result &result) const
+{
+    // A fixed seed, so the same pair of circuits always gives the same counterexample.
+    QRandomGenerator generator(1);
+    std::vector<quint64> inputs(static_cast<size_t>(m_inputLabels.size()));
+    std::vector<quint64> firstLanes;
+    std::vector<quint64> secondLanes;
+
+    for (int word = 0; word < randomWords; ++word) {
+        for (auto &input : inputs) {
+            input = generator.generate64();
+        }
+
+        evaluate(inputs, firstLanes, secondLanes);
+        quint64 difference = 0;
+
+        for (int output = 0; output < m_outputLabels.size(); ++output) {
+            difference |= slotValue(firstLanes, m_firstOutputSlots.at(output)) ^ slotValue(secondLanes, m_secondOutputSlots.at(output));
+        }
+
+        if (difference != 0) {
+            const int lane = qCountTrailingZeroBits(difference);
+            QVector<bool> counterexample;
+
+            for (const quint64 input : inputs) {
+                counterexample.append((input >> lane) & 1);
+            }
+
+            return check(counterexample, result);
+        }
+    }
+
+    return false;
+}
+
+bool EquivalenceChecker::prove(Result &result) const
+{
+    AndInverterGraph graph;
+    QHash<int, int> firstInputs;
+    QHash<int, int> secondInputs;
+    QVector<int> inputLiterals;
+
+    for (int input = 0; input < m_inputLabels.size(); ++input) {
+        inputLiterals.append(graph.createInput());
+
+        if (m_firstInputSlots.at(input) >= 0) {
+            firstInputs.insert(m_firstInputSlots.at(input), inputLiterals.constLast());
+        }
+
+        if (m_secondInputSlots.at(input) >= 0) {
+            secondInputs.insert(m_secondInputSlots.at(input), inputLiterals.constLast());
+        }
+    }
+
+    const auto firstLiterals = graph.addNetlist(*m_first.netlist(), firstInputs);
+    const auto secondLiterals = graph.addNetlist(*m_second.netlist(), secondInputs);
+
+    for (int output = 0; output < m_outputLabels.size(); ++output) {
+        const int miter = graph.createXor(slotLiteral(firstLiterals, m_firstOutputSlots.at(output)), slotLiteral(secondLiterals, m_secondOutputSlots.at(output)));
+
+        // Structural hashing already merged both outputs.
+        if (miter == AndInverterGraph::falseLiteral) {
+            continue;
+        }
+
+        QVector<bool> counterexample(m_inputLabels.size(), false);
+
+        if (miter != AndInverterGraph::trueLiteral) {
+            // Nodes only depend on nodes created before them, so a single backward pass finds the cone of the miter.
+            const int root = AndInverterGraph::node(miter);
+            std::vector<bool> inCone(static_cast<size_t>(root) + 1, false);
+            inCone[root] = true;
+
+            for (int node = root; node > 0; --node) {
+                if (inCone[node] && !graph.isInput(node)) {
+                    inCone[AndInverterGraph::node(graph.fanin0(node))] = true;
+                    inCone[AndInverterGraph::node(graph.fanin1(node))] = true;
+                }
+            }
+
+            SatSolver solver;
+            std::vector<int> variables(static_cast<size_t>(root) + 1, -1);
+
+            const auto satLiteral = [&variables](const int literal) {
+                return 2 * variables[AndInverterGraph::node(literal)] + (literal & 1);
+            };
+
+            // Node = fanin0 AND fanin1, as three clauses. AND nodes never have a constant fanin.
+            for (int node = 1; node <= root; ++node) {
+                if (!inCone[node]) {
+                    continue;
+                }
+
+                variables[node] = solver.createVariable();
+
+                if (!graph.isInput(node)) {
+                    const int literal = 2 * variables[node];
+                    const int fanin0 = satLiteral(graph.fanin0(node));
+                    const int fanin1 = satLiteral(graph.fanin1(node));
+
+                    solver.addClause({literal ^ 1, fanin0});
+                    solver.addClause({literal ^ 1, fanin1});
+                    solver.addClause({literal, fanin0 ^ 1, fanin1 ^ 1});
+                }
+            }
+
+            solver.addClause({satLiteral(miter)});
+
+            if (solver.solve() != SatSolver::Result::Satisfiable) {
+                continue;
+            }
+
+            // Inputs outside of the cone do not matter, and stay at 0.
+            for (int input = 0; input < m_inputLabels.size(); ++input) {
+                const int node = AndInverterGraph::node(inputLiterals.at(input));
+                counterexample[input] = (node <= root) && (variables[node] >= 0) && solver.value(variables[node]);
+            }
+        }
+
+        if (!check(counterexample, result)) {
+            throw Pandaception(tr("The counterexample found for output %1 does not hold.").arg(m_outputLabels.at(output)));
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+bool EquivalenceChecker::check(const QVector<bool> &counterexample, Result &result) const
+{
+    std::vector<quint64> inputs;
+    std::vector<quint64> firstLanes;
+    std::vector<quint64> secondLanes;
+
+    for (const bool value : counterexample) {
+        inputs.push_back(value ? ~quint64(0) : 0);
+    }
+
+    evaluate(inputs, firstLanes, secondLanes);
+
+    for (int output = 0; output < m_outputLabels.size(); ++output) {
+        const bool firstValue = slotValue(firstLanes, m_firstOutputSlots.at(output)) & 1;
+        const bool secondValue = slotValue(secondLanes, m_secondOutputSlots.at(output)) & 1;
+
+        if (firstValue != secondValue) {
+            result.equivalent = false;
+            result.output = m_outputLabels.at(output);
+            result.firstValue = firstValue;
+            result.secondValue = secondValue;
+            result.counterexample = counterexample;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void EquivalenceChecker::evaluate(const std::vector<quint64> &inputs, std::vector<quint64> &firstLanes, std::vector<quint64> &secondLanes) const
+{
+    firstLanes = m_first.netlist()->lanes();
+    secondLanes = m_second.netlist()->lanes();
+
+    for (int input = 0; input < m_inputLabels.size(); ++input) {
+        if (const int slot = m_firstInputSlots.at(input); slot >= 0) {
+            firstLanes[slot] = inputs[input];
+        }
+
+        if (const int slot = m_secondInputSlots.at(input); slot >= 0) {
+            secondLanes[slot] = inputs[input];
+        }
+    }
+
+    m_first.netlist()->updateLanes(firstLanes);
+    m_second.netlist()->updateLanes(secondLanes);
+}
+
+QString EquivalenceChecker::Result::summary(const QStringList &inputLabels) const
+{
+    if (equivalent) {
+        return tr("The circuits are equivalent.");
+    }
+
+    QStringList values;
+
+    for (int input = 0; input < counterexample.size(); ++input) {
+        values.append(inputLabels.at(input) + "=" + (counterexample.at(input) ? "1" : "0"));
+    }
+
+    return tr("The circuits differ on output \"%1\": %2 in the first one and %3 in the second one, for %4.")
+        .arg(output).arg(static_cast<int>(firstValue)).arg(static_cast<int>(secondValue)).arg(values.join(" "));
+}
@@ -0,0 +1,74 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+class HeadlessCircuit;
+
+/**
+ * @brief Checks whether two combinational circuits compute the same outputs for every input combination.
+ *
+ * Inputs and outputs are matched by label, the Nth input or output with a label in one circuit with the Nth one
+ * with the same label in the other. Inputs only one of the circuits has are free in both. Random vectors are
+ * first simulated on the lanes of both netlists, 64 at a time, which finds most differences at once. What is left
+ * is proven output by output: both netlists go into a single AndInverterGraph over shared inputs, and the XOR of
+ * each pair of outputs that structural hashing did not already merge is handed to a SatSolver.
+ */
+class EquivalenceChecker
+{
+    Q_DECLARE_TR_FUNCTIONS(EquivalenceChecker)
+
+public:
+    struct Result {
+        bool equivalent = true;
+        //! Output that differs, and its value in each circuit, when they are not equivalent.
+        QString output;
+        bool firstValue = false;
+        bool secondValue = false;
+        //! Value of each input, in the order of inputLabels(), that makes the output differ.
+        QVector<bool> counterexample;
+
+        QString summary(const QStringList &inputLabels) const;
+    };
+
+    //! Throws a Pandaception if either circuit is not combinational or their outputs do not have the same labels.
+    explicit EquivalenceChecker(const HeadlessCircuit &first, const HeadlessCircuit &second);
+
+    //! Inputs of both circuits, those of the first one followed by those only the second one has.
+    const QStringList &inputLabels() const;
+
+    Result run() const;
+
+private:
+    Q_DISABLE_COPY(EquivalenceChecker)
+
+    //! Words of random vectors simulated before proving, 64 vectors each.
+    static constexpr int randomWords = 64;
+
+    //! Looks for a counterexample among random vectors.
+    bool simulate(Result &result) const;
+    //! Proves that every pair of outputs is equivalent, or finds a counterexample.
+    bool prove(Result &result) const;
+    //! Fills @p result with the outputs of both circuits for @p counterexample, and returns whether they differ.
+    bool check(const QVector<bool> &counterexample, Result &result) const;
+
+    //! Values of the slots of both circuits for the input words @p inputs, one per input of inputLabels().
+    void evaluate(const std::vector<quint64> &inputs, std::vector<quint64> &firstLanes, std::vector<quint64> &secondLanes) const;
+
+    const HeadlessCircuit &m_first;
+    const HeadlessCircuit &m_second;
+    QStringList m_inputLabels;
+    //! Slot of each input of inputLabels() in each circuit, or -1 if it does not have it.
+    QVector<int> m_firstInputSlots;
+    QVector<int> m_secondInputSlots;
+    QStringList m_outputLabels;
+    //! Slot of each output of the first circuit, and of the matching output of the second one, -1 if not connected.
+    QVector<int> m_firstOutputSlots;
+    QVector<int> m_secondOutputSlots;
+};
@@ -0,0 +1,79 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "faultcoverage.h"
+
+#include "waveformreader.h"
+
+FaultCoverage::FaultCoverage(const QString &circuitFileName, const QString &stimulusFileName)
+    : m_circuit(circuitFileName, Netlist::AliasNodes)
+    , m_simulator(*m_circuit.netlist())
+{
+    const Waveform stimulus = WaveformReader::read(stimulusFileName);
+    const int inputCount = m_circuit.inputCount();
+
+    QVector<int> inputs;
+    QVector<int> observed;
+
+    for (int input = 0; input < inputCount; ++input) {
+        inputs.append(m_circuit.inputSlot(input));
+    }
+
+    for (int output = 0; output < m_circuit.outputCount(); ++output) {
+        if (const int slot = m_circuit.outputSlot(output); slot >= 0) {
+            observed.append(slot);
+        }
+    }
+
+    m_simulator.setInputSlots(inputs);
+    m_simulator.setObservedSlots(observed);
+
+    // Rows past the inputs of the circuit are ignored and missing ones stay at 0, as in --grade.
+    m_vectors.reserve(stimulus.columns);
+
+    for (int column = 0; column < stimulus.columns; ++column) {
+        QVector<bool> vector(inputCount, false);
+
+        for (int input = 0; input < qMin(inputCount, stimulus.rows); ++input) {
+            vector[input] = stimulus.at(input, column);
+        }
+
+        m_vectors.append(vector);
+    }
+}
+
+const HeadlessCircuit &FaultCoverage::circuit() const
+{
+    return m_circuit;
+}
+
+const QVector<QVector<bool>> &FaultCoverage::vectors() const
+{
+    return m_vectors;
+}
+
+FaultSimulator::Report FaultCoverage::run() const
+{
+    return m_simulator.run(m_vectors);
+}
+
+QString FaultCoverage::faultName(const FaultSimulator::Fault &fault) const
+{
+    return tr("%1, output %2, stuck at %3").arg(m_circuit.elementName(fault.logic)).arg(fault.port).arg(fault.stuckAt ? 1 : 0);
+}
+
+QString FaultCoverage::report(const FaultSimulator::Report &report) const
+{
+    QString text = report.summary() + '\n';
+    const auto undetected = report.undetected();
+
+    if (!undetected.isEmpty()) {
+        text += tr("Undetected faults:") + '\n';
+    }
+
+    for (const auto &fault : undetected) {
+        text += "  " + faultName(fault) + '\n';
+    }
+
+    return text;
+}
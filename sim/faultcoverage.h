@@ -0,0 +1,46 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "faultsimulator.h"
+#include "headlesscircuit.h"
+
+#include <QCoreApplication>
+#include <QVector>
+
+/**
+ * @brief Stuck-at fault coverage of a stimulus on a HeadlessCircuit.
+ *
+ * Each column of the stimulus, a beWavedDolphin file as in --grade, is a vector applied to the inputs of the
+ * circuit, and the faults are observed on its outputs. The circuit is loaded with nodes aliased but no other
+ * optimization, so every gate of the file has its faults, even one a constant makes redundant. Faults are named
+ * after the labels of the elements they are on, so the ones no vector detects can be found in the circuit.
+ */
+class FaultCoverage
+{
+    Q_DECLARE_TR_FUNCTIONS(FaultCoverage)
+
+public:
+    //! Throws a Pandaception if the circuit or the stimulus cannot be read.
+    FaultCoverage(const QString &circuitFileName, const QString &stimulusFileName);
+
+    const HeadlessCircuit &circuit() const;
+
+    const QVector<QVector<bool>> &vectors() const;
+
+    FaultSimulator::Report run() const;
+
+    //! Element, output port and stuck-at value of @p fault.
+    QString faultName(const FaultSimulator::Fault &fault) const;
+
+    //! Summary of @p report, followed by a line for each fault it leaves undetected.
+    QString report(const FaultSimulator::Report &report) const;
+
+private:
+    Q_DISABLE_COPY(FaultCoverage)
+
+    const HeadlessCircuit m_circuit;
+    FaultSimulator m_simulator;
+    QVector<QVector<bool>> m_vectors;
+};
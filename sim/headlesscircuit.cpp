@@ -0,0 +1,576 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "headlesscircuit.h"
+
+#include "common.h"
+#include "logicand.h"
+#include "logicbusgate.h"
+#include "logicbusmux.h"
+#include "logicarena.h"
+#include "logicdemux.h"
+#include "logicdflipflop.h"
+#include "logicdlatch.h"
+#include "logicjkflipflop.h"
+#include "logicjoiner.h"
+#include "logicmux.h"
+#include "logicnand.h"
+#include "logicnode.h"
+#include "logicnone.h"
+#include "logicnor.h"
+#include "logicnot.h"
+#include "logicor.h"
+#include "logicoutput.h"
+#include "logicsplitter.h"
+#include "logicsrflipflop.h"
+#include "logictflipflop.h"
+#include "logicxnor.h"
+#include "logicxor.h"
+#include "netlist.h"
+#include "vcdwriter.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QMetaEnum>
+
+namespace
+{
+    const int maximumICDepth = 64;
+
+    //! Minimum and maximum port sizes given to GraphicElement by each element constructor.
+    struct PortSizes {
+        int minInputs = 0;
+        int maxInputs = 0;
+        int minOutputs = 0;
+        int maxOutputs = 0;
+    };
+
+    PortSizes portSizes(const ElementType type)
+    {
+        switch (type) {
+        case ElementType::And:
+        case ElementType::Nand:
+        case ElementType::Nor:
+        case ElementType::Or:
+        case ElementType::Xnor:
+        case ElementType::Xor:         return {2, 8, 1, 1};
+        case ElementType::Buzzer:      return {1, 1, 0, 0};
+        case ElementType::DFlipFlop:   return {4, 4, 2, 2};
+        case ElementType::DLatch:      return {2, 2, 2, 2};
+        case ElementType::Demux:       return {2, 2, 2, 2};
+        case ElementType::Display14:   return {15, 15, 0, 0};
+        case ElementType::Display7:    return {8, 8, 0, 0};
+        case ElementType::InputRotary: return {0, 0, 2, 16};
+        case ElementType::JKFlipFlop:  return {5, 5, 2, 2};
+        case ElementType::Joiner:      return {2, 16, 1, 1};
+        case ElementType::Led:         return {1, 4, 0, 0};
+        case ElementType::Mux:         return {3, 3, 1, 1};
+        case ElementType::Node:
+        case ElementType::Not:         return {1, 1, 1, 1};
+        case ElementType::SRFlipFlop:  return {5, 5, 2, 2};
+        case ElementType::Splitter:    return {1, 1, 2, 16};
+        case ElementType::TFlipFlop:   return {4, 4, 2, 2};
+
+        case ElementType::Clock:
+        case ElementType::InputButton:
+        case ElementType::InputGnd:
+        case ElementType::InputSwitch:
+        case ElementType::InputVcc:    return {0, 0, 1, 1};
+
+        default:                       return {};
+        }
+    }
+
+    //! Same widths as GraphicElement::portWidth() and its overrides.
+    int portWidth(const PandaElement &elm, const bool isInputPort, const int port, const int inputSize, const int outputSize)
+    {
+        switch (elm.type) {
+        case ElementType::Joiner:   return isInputPort ? 1 : inputSize;
+        case ElementType::Mux:      return (isInputPort && (port == 2)) ? 1 : elm.busWidth;
+        case ElementType::Splitter: return isInputPort ? outputSize : 1;
+        default:                    return elm.busWidth;
+        }
+    }
+
+    bool isInput(const ElementType type)
+    {
+        return (type == ElementType::Clock) || (type == ElementType::InputButton) || (type == ElementType::InputRotary) || (type == ElementType::InputSwitch);
+    }
+
+    bool isOutput(const ElementType type)
+    {
+        return (type == ElementType::Buzzer) || (type == ElementType::Display14) || (type == ElementType::Display7) || (type == ElementType::Led);
+    }
+
+    //! Value of an input port right after loading, as set by the setOn() of each input element.
+    bool initialValue(const PandaElement &elm, const int port)
+    {
+        switch (elm.type) {
+        case ElementType::InputRotary: return (port == elm.currentPort);
+        case ElementType::InputSwitch: return elm.isOn;
+        default:                       return false;
+        }
+    }
+
+    //! Same name given by the element constructors, used by beWavedDolphin when an input or output has no label.
+    QString translatedName(const ElementType type)
+    {
+        switch (type) {
+        case ElementType::Buzzer:      return QCoreApplication::translate("Buzzer", "Buzzer");
+        case ElementType::Clock:       return QCoreApplication::translate("Clock", "Clock");
+        case ElementType::Display14:   return QCoreApplication::translate("Display14", "14-Segment Display");
+        case ElementType::Display7:    return QCoreApplication::translate("Display7", "7-Segment Display");
+        case ElementType::InputButton: return QCoreApplication::translate("InputButton", "Push Button");
+        case ElementType::InputRotary: return QCoreApplication::translate("InputRotary", "Rotary Switch");
+        case ElementType::InputSwitch: return QCoreApplication::translate("InputSwitch", "Input Switch");
+        case ElementType::Led:         return QCoreApplication::translate("Led", "LED");
+        default:                       return QMetaEnum::fromType<ElementType>().valueToKey(static_cast<int>(type));
+        }
+    }
+
+    //! Same order as IC::comparePorts(): by position of the element, top to bottom and then left to right.
+    bool comparePositions(const QPointF &pos1, const QPointF &pos2)
+    {
+        return (pos1.y() < pos2.y()) || (qFuzzyCompare(pos1.y(), pos2.y()) && (pos1.x() < pos2.x()));
+    }
+}
+
+HeadlessCircuit::HeadlessCircuit(const QString &fileName, const int optimizations)
+    : m_arena(LogicArena::create())
+{
+    const QFileInfo fileInfo(fileName);
+    m_directory = fileInfo.absolutePath();
+
+    qCDebug(zero) << tr("Loading headless circuit: ") << fileInfo.absoluteFilePath();
+    instantiate(PandaReader::read(fileInfo.absoluteFilePath()), false, 0, {});
+
+    qCDebug(zero) << tr("Compiling netlist with ") << m_logicElms.size() << tr(" elements.");
+    Netlist::levelize(m_logicElms);
+    m_netlist = std::make_unique<Netlist>(m_logicElms, optimizations);
+    m_initialState = m_netlist->saveState();
+}
+
+HeadlessCircuit::~HeadlessCircuit()
+{
+    m_globalGND.clearSucessors();
+    m_globalVCC.clearSucessors();
+}
+
+HeadlessCircuit::ICLogic HeadlessCircuit::instantiate(const PandaFile &pandaFile, const bool isIC, const int depth, const QString &path)
+{
+    if (depth > maximumICDepth) {
+        throw Pandaception(tr("ICs nested too deep. Does an IC include itself?"));
+    }
+
+    // Every input port to be connected, and the ids of the ports of this file.
+    QVector<PortLogic> inputPorts;
+    QVector<quint64> inputPortIds;
+    QHash<quint64, int> inputPortIndices;
+    QHash<quint64, Port> outputPorts;
+    //! Width of the bus ports, every other port being a single wire.
+    QHash<quint64, int> portWidths;
+
+    QVector<QPair<QPointF, PortLogic>> icInputs;
+    QVector<QPair<QPointF, PortLogic>> icOutputs;
+    QVector<QPair<const PandaElement *, LogicElement *>> inputElms;
+    QVector<QPair<const PandaElement *, LogicElement *>> outputElms;
+
+    const auto addInputPort = [&](const PortLogic &portLogic, const QVector<quint64> &ids, const int port) {
+        const quint64 id = (port < ids.size()) ? ids.at(port) : 0;
+
+        if (port < ids.size()) {
+            inputPortIndices.insert(id, inputPorts.size());
+        }
+
+        inputPorts.append(portLogic);
+        inputPortIds.append(id);
+    };
+
+    const auto addOutputPort = [&](const Port &portLogic, const QVector<quint64> &ids, const int port) {
+        if (port < ids.size()) {
+            outputPorts.insert(ids.at(port), portLogic);
+        }
+    };
+
+    const auto elementName = [&path](const PandaElement &elm) {
+        const QString name = elm.label.isEmpty() ? translatedName(elm.type) + tr(" at (%1, %2)").arg(elm.pos.x()).arg(elm.pos.y()) : elm.label;
+        return path + name;
+    };
+
+    for (const auto &elm : pandaFile.elements) {
+        if (elm.type == ElementType::IC) {
+            const auto ic = instantiate(icFile(elm.icFile), true, depth + 1, elementName(elm) + "/");
+
+            for (int port = 0; port < ic.inputs.size(); ++port) {
+                addInputPort(ic.inputs.at(port), elm.inputPorts, port);
+            }
+
+            for (int port = 0; port < ic.outputs.size(); ++port) {
+                addOutputPort({ic.outputs.at(port).logic, 0}, elm.outputPorts, port);
+            }
+
+            continue;
+        }
+
+        const PortSizes sizes = portSizes(elm.type);
+        const int inputSize = qBound(sizes.minInputs, static_cast<int>(elm.inputPorts.size()), sizes.maxInputs);
+        const int outputSize = qBound(sizes.minOutputs, static_cast<int>(elm.outputPorts.size()), sizes.maxOutputs);
+
+        // Like IC::loadInputElement() and IC::loadOutputElement(), the inputs and outputs of an IC become nodes.
+        if (isIC && isInput(elm.type)) {
+            for (int port = 0; port < outputSize; ++port) {
+                auto node = m_arena->make<LogicNode>();
+                m_logicElms.append(node);
+                m_elementNames.insert(node.get(), elementName(elm));
+
+                const bool required = (elm.type == ElementType::Clock);
+                const Status status = required ? Status::Invalid : static_cast<Status>(initialValue(elm, port));
+                icInputs.append({elm.pos, {node.get(), 0, required, status}});
+                addOutputPort({node.get(), 0}, elm.outputPorts, port);
+            }
+
+            continue;
+        }
+
+        if (isIC && isOutput(elm.type)) {
+            for (int port = 0; port < inputSize; ++port) {
+                auto node = m_arena->make<LogicNode>();
+                m_logicElms.append(node);
+                m_elementNames.insert(node.get(), elementName(elm));
+
+                icOutputs.append({elm.pos, {node.get(), 0}});
+                addInputPort({node.get(), 0}, elm.inputPorts, port);
+            }
+
+            continue;
+        }
+
+        auto logic = buildLogicElement(elm, inputSize, outputSize);
+        logic->setDelay(elm.delay);
+        m_logicElms.append(logic);
+        m_elementNames.insert(logic.get(), elementName(elm));
+
+        for (int port = 0; port < elm.inputPorts.size(); ++port) {
+            portWidths.insert(elm.inputPorts.at(port), portWidth(elm, true, port, inputSize, outputSize));
+        }
+
+        for (int port = 0; port < elm.outputPorts.size(); ++port) {
+            portWidths.insert(elm.outputPorts.at(port), portWidth(elm, false, port, inputSize, outputSize));
+        }
+
+        for (int port = 0; port < inputSize; ++port) {
+            PortLogic portLogic = inputPortProperties(elm.type, port);
+            portLogic.logic = logic.get();
+            portLogic.port = port;
+            addInputPort(portLogic, elm.inputPorts, port);
+        }
+
+        for (int port = 0; port < outputSize; ++port) {
+            addOutputPort({logic.get(), port}, elm.outputPorts, port);
+
+            if (isInput(elm.type)) {
+                logic->setOutputValue(port, initialValue(elm, port));
+            }
+        }
+
+        if (isInput(elm.type)) {
+            inputElms.append({&elm, logic.get()});
+        }
+
+        if (isOutput(elm.type)) {
+            outputElms.append({&elm, logic.get()});
+        }
+    }
+
+    // -------------------------------------------
+
+    QHash<quint64, int> connectionCount;
+    QHash<quint64, quint64> predecessors;
+
+    for (const auto &connection : pandaFile.connections) {
+        quint64 inputId = connection.port1;
+        quint64 outputId = connection.port2;
+
+        if (!inputPortIndices.contains(inputId)) {
+            std::swap(inputId, outputId);
+        }
+
+        if (!inputPortIndices.contains(inputId) || !outputPorts.contains(outputId)) {
+            continue;
+        }
+
+        if (portWidths.value(inputId, 1) != portWidths.value(outputId, 1)) {
+            qCDebug(zero) << tr("Connection between ports of different widths is ignored.");
+            continue;
+        }
+
+        connectionCount[inputId] += 1;
+        predecessors[inputId] = outputId;
+    }
+
+    // Same rules as ElementMapping::applyConnection().
+    for (int index = 0; index < inputPorts.size(); ++index) {
+        const auto &portLogic = inputPorts.at(index);
+        const quint64 id = inputPortIds.at(index);
+        const int connections = inputPortIndices.contains(id) ? connectionCount.value(id) : 0;
+
+        if ((connections == 0) && !portLogic.required) {
+            auto *predecessorLogic = (portLogic.defaultStatus == Status::Active) ? &m_globalVCC : &m_globalGND;
+            portLogic.logic->connectPredecessor(portLogic.port, predecessorLogic, 0);
+        }
+
+        if (connections == 1) {
+            const Port predecessor = outputPorts.value(predecessors.value(id));
+            portLogic.logic->connectPredecessor(portLogic.port, predecessor.logic, predecessor.port);
+        }
+    }
+
+    // -------------------------------------------
+
+    ICLogic icLogic;
+
+    if (isIC) {
+        const auto byPosition = [](const auto &port1, const auto &port2) {
+            return comparePositions(port1.first, port2.first);
+        };
+
+        std::stable_sort(icInputs.begin(), icInputs.end(), byPosition);
+        std::stable_sort(icOutputs.begin(), icOutputs.end(), byPosition);
+
+        for (const auto &input : qAsConst(icInputs)) {
+            icLogic.inputs.append(input.second);
+        }
+
+        for (const auto &output : qAsConst(icOutputs)) {
+            icLogic.outputs.append(output.second);
+        }
+
+        return icLogic;
+    }
+
+    // Same order and names as BewavedDolphin::loadElements() and BewavedDolphin::loadNewTable().
+    const auto sortByLabel = [](QVector<QPair<const PandaElement *, LogicElement *>> &elms, const bool isOutputGroup, QStringList &labels, QVector<Port> &ports) {
+        std::stable_sort(elms.begin(), elms.end(), [](const auto &elm1, const auto &elm2) {
+            return QString::compare(elm1.first->label, elm2.first->label, Qt::CaseInsensitive) < 0;
+        });
+
+        for (const auto &[elmPtr, logic] : qAsConst(elms)) {
+            const PandaElement &elm = *elmPtr;
+            const PortSizes sizes = portSizes(elm.type);
+            const int count = isOutputGroup ? qBound(sizes.minInputs, static_cast<int>(elm.inputPorts.size()), sizes.maxInputs)
+                                            : qBound(sizes.minOutputs, static_cast<int>(elm.outputPorts.size()), sizes.maxOutputs);
+            const QString label = elm.label.isEmpty() ? translatedName(elm.type) : elm.label;
+
+            for (int port = 0; port < count; ++port) {
+                labels.append((count > 1) ? label + "[" + QString::number(port) + "]" : label);
+                ports.append({logic, port, elm.pos});
+            }
+        }
+    };
+
+    sortByLabel(inputElms, false, m_inputLabels, m_inputs);
+    sortByLabel(outputElms, true, m_outputLabels, m_outputs);
+
+    return icLogic;
+}
+
+PandaFile HeadlessCircuit::icFile(const QString &fileName)
+{
+    const QString filePath = QDir(m_directory).absoluteFilePath(QFileInfo(fileName).fileName());
+
+    if (!m_icFiles.contains(filePath)) {
+        if (!QFileInfo(filePath).isFile()) {
+            throw Pandaception(filePath + tr(" not found."));
+        }
+
+        qCDebug(three) << tr("Reading IC: ") << filePath;
+        m_icFiles.insert(filePath, PandaReader::read(filePath));
+    }
+
+    return m_icFiles.value(filePath);
+}
+
+std::shared_ptr<LogicElement> HeadlessCircuit::buildLogicElement(const PandaElement &elm, const int inputSize, const int outputSize)
+{
+    // Same logic as ElementFactory::buildLogicElement().
+    if (elm.busWidth > 1) {
+        switch (elm.type) {
+        case ElementType::And: return m_arena->make<LogicBusGate>(LogicType::BusAnd, inputSize, elm.busWidth);
+        case ElementType::Mux: return m_arena->make<LogicBusMux>(elm.busWidth);
+        case ElementType::Not: return m_arena->make<LogicBusGate>(LogicType::BusNot, 1, elm.busWidth);
+        case ElementType::Or:  return m_arena->make<LogicBusGate>(LogicType::BusOr, inputSize, elm.busWidth);
+        case ElementType::Xor: return m_arena->make<LogicBusGate>(LogicType::BusXor, inputSize, elm.busWidth);
+        default:               throw Pandaception(tr("Bus not supported: ") + QString::number(static_cast<int>(elm.type)));
+        }
+    }
+
+    switch (elm.type) {
+    case ElementType::Clock:
+    case ElementType::InputButton:
+    case ElementType::InputRotary:
+    case ElementType::InputSwitch: return m_arena->make<LogicInput>(false, outputSize);
+
+    case ElementType::Buzzer:
+    case ElementType::Display14:
+    case ElementType::Display7:
+    case ElementType::Led:         return m_arena->make<LogicOutput>(inputSize);
+
+    case ElementType::And:         return m_arena->make<LogicAnd>(inputSize);
+    case ElementType::DFlipFlop:   return m_arena->make<LogicDFlipFlop>();
+    case ElementType::Demux:       return m_arena->make<LogicDemux>();
+    case ElementType::InputGnd:    return m_arena->make<LogicInput>(false);
+    case ElementType::InputVcc:    return m_arena->make<LogicInput>(true);
+    case ElementType::JKFlipFlop:  return m_arena->make<LogicJKFlipFlop>();
+    case ElementType::Joiner:      return m_arena->make<LogicJoiner>(inputSize);
+    case ElementType::Mux:         return m_arena->make<LogicMux>();
+    case ElementType::Nand:        return m_arena->make<LogicNand>(inputSize);
+    case ElementType::Node:        return m_arena->make<LogicNode>();
+    case ElementType::Nor:         return m_arena->make<LogicNor>(inputSize);
+    case ElementType::Not:         return m_arena->make<LogicNot>();
+    case ElementType::Or:          return m_arena->make<LogicOr>(inputSize);
+    case ElementType::SRFlipFlop:  return m_arena->make<LogicSRFlipFlop>();
+    case ElementType::Splitter:    return m_arena->make<LogicSplitter>(outputSize);
+    case ElementType::TFlipFlop:   return m_arena->make<LogicTFlipFlop>();
+    case ElementType::Xnor:        return m_arena->make<LogicXnor>(inputSize);
+    case ElementType::Xor:         return m_arena->make<LogicXor>(inputSize);
+
+    case ElementType::DLatch:      return m_arena->make<LogicDLatch>();
+
+    case ElementType::Line:
+    case ElementType::Text:        return m_arena->make<LogicNone>();
+
+    default:                       throw Pandaception(tr("Not implemented yet: ") + QString::number(static_cast<int>(elm.type)));
+    }
+}
+
+HeadlessCircuit::PortLogic HeadlessCircuit::inputPortProperties(const ElementType type, const int port)
+{
+    // Required flags and default values set to the input ports by each element constructor.
+    const PortLogic required;
+    const PortLogic active{nullptr, 0, false, Status::Active};
+    const PortLogic inactive{nullptr, 0, false, Status::Inactive};
+
+    switch (type) {
+    case ElementType::DFlipFlop:  return (port >= 2) ? active : required;
+    case ElementType::JKFlipFlop: return (port != 1) ? active : required;
+    case ElementType::SRFlipFlop: return (port >= 3) ? active : ((port != 1) ? inactive : required);
+    case ElementType::TFlipFlop:  return (port >= 2) ? active : ((port == 0) ? inactive : required);
+
+    case ElementType::Display14:
+    case ElementType::Display7:
+    case ElementType::Led:        return inactive;
+
+    default:                      return required;
+    }
+}
+
+Netlist *HeadlessCircuit::netlist() const
+{
+    return m_netlist.get();
+}
+
+QString HeadlessCircuit::elementName(const LogicElement *logic) const
+{
+    return m_elementNames.value(logic);
+}
+
+const QStringList &HeadlessCircuit::inputLabels() const
+{
+    return m_inputLabels;
+}
+
+const QStringList &HeadlessCircuit::outputLabels() const
+{
+    return m_outputLabels;
+}
+
+int HeadlessCircuit::inputCount() const
+{
+    return m_inputs.size();
+}
+
+int HeadlessCircuit::outputCount() const
+{
+    return m_outputs.size();
+}
+
+int HeadlessCircuit::inputIndex(const QString &label) const
+{
+    return m_inputLabels.indexOf(label);
+}
+
+int HeadlessCircuit::outputIndex(const QString &label) const
+{
+    return m_outputLabels.indexOf(label);
+}
+
+QPointF HeadlessCircuit::inputPosition(const int index) const
+{
+    return m_inputs.at(index).position;
+}
+
+QPointF HeadlessCircuit::outputPosition(const int index) const
+{
+    return m_outputs.at(index).position;
+}
+
+int HeadlessCircuit::inputSlot(const int index) const
+{
+    const auto &input = m_inputs.at(index);
+    return m_netlist->outputSlot(input.logic, input.port);
+}
+
+int HeadlessCircuit::outputSlot(const int index) const
+{
+    const auto &output = m_outputs.at(index);
+    return output.logic->isValid() ? m_netlist->inputSlot(output.logic, output.port) : -1;
+}
+
+bool HeadlessCircuit::input(const int index) const
+{
+    const auto &input = m_inputs.at(index);
+    return input.logic->outputValue(input.port);
+}
+
+void HeadlessCircuit::reset()
+{
+    m_netlist->restoreState(m_initialState);
+}
+
+void HeadlessCircuit::setInput(const int index, const bool value)
+{
+    const auto &input = m_inputs.at(index);
+    input.logic->setOutputValue(input.port, value);
+    m_netlist->loadOutputs(input.logic);
+}
+
+Status HeadlessCircuit::output(const int index) const
+{
+    const auto &output = m_outputs.at(index);
+    return output.logic->isValid() ? static_cast<Status>(output.logic->inputValue(output.port)) : Status::Invalid;
+}
+
+void HeadlessCircuit::startTrace(const QString &fileName)
+{
+    QVector<VcdWriter::Signal> signalList;
+    QVector<int> firstSlots;
+
+    for (int index = 0; index < m_inputs.size(); ++index) {
+        signalList.append({m_inputLabels.at(index), 1});
+        firstSlots.append(inputSlot(index));
+    }
+
+    for (int index = 0; index < m_outputs.size(); ++index) {
+        signalList.append({m_outputLabels.at(index), 1});
+        firstSlots.append(outputSlot(index));
+    }
+
+    auto trace = std::make_shared<VcdWriter>(fileName, signalList);
+    trace->setSlots(firstSlots);
+    m_netlist->setTrace(trace);
+}
+
+void HeadlessCircuit::update()
+{
+    m_netlist->update();
+}
@@ -0,0 +1,113 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "enums.h"
+#include "logicinput.h"
+#include "netlist.h"
+#include "pandareader.h"
+
+#include <QHash>
+#include <QPointF>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+class LogicArena;
+
+/**
+ * @brief Circuit loaded from a panda file straight into a Netlist, without any scene, graphic item or widget.
+ *
+ * Inputs are the ports of the switches, buttons, rotary switches and clocks; outputs are the ports of the LEDs,
+ * displays and buzzers. Both are sorted and named like in beWavedDolphin. Clocks do not tick by themselves, they
+ * are driven like any other input. ICs are expanded recursively, looking for their files in the directory of the
+ * loaded file.
+ */
+class HeadlessCircuit
+{
+    Q_DECLARE_TR_FUNCTIONS(HeadlessCircuit)
+
+public:
+    //! Loads and compiles the circuit with the Netlist::Optimization flags @p optimizations, all of them by default
+    //! as only the inputs and outputs are observed. Throws a Pandaception if the file cannot be read.
+    explicit HeadlessCircuit(const QString &fileName, const int optimizations = Netlist::AllOptimizations);
+    ~HeadlessCircuit();
+
+    Netlist *netlist() const;
+    //! Label of the element @p logic was built for, prefixed by the ICs it is in. Unlabeled elements are named
+    //! after their type and position.
+    QString elementName(const LogicElement *logic) const;
+    Status output(const int index) const;
+    bool input(const int index) const;
+    const QStringList &inputLabels() const;
+    const QStringList &outputLabels() const;
+    int inputCount() const;
+    int inputIndex(const QString &label) const;
+    //! Position of the element input @p index belongs to, which tells apart elements with the same label.
+    QPointF inputPosition(const int index) const;
+    //! Netlist slot driven by input @p index.
+    int inputSlot(const int index) const;
+    int outputCount() const;
+    int outputIndex(const QString &label) const;
+    //! Position of the element output @p index belongs to.
+    QPointF outputPosition(const int index) const;
+    //! Netlist slot read by output @p index, or -1 if the output is not connected.
+    int outputSlot(const int index) const;
+    //! Brings the circuit back to its state right after loading, inputs included, as if it was loaded again.
+    void reset();
+    void setInput(const int index, const bool value);
+
+    //! Writes the changes of every input and output to the VCD file @p fileName, at each update from now on.
+    //! Throws a Pandaception if the file cannot be written.
+    void startTrace(const QString &fileName);
+
+    //! Evaluates the circuit once, like one tick of Simulation::update().
+    void update();
+
+private:
+    Q_DISABLE_COPY(HeadlessCircuit)
+
+    //! Logic element and port an element port of a panda file was mapped to.
+    struct PortLogic {
+        LogicElement *logic = nullptr;
+        int port = 0;
+        bool required = true;
+        Status defaultStatus = Status::Invalid;
+    };
+
+    //! Logic of an instantiated IC, in port order.
+    struct ICLogic {
+        QVector<PortLogic> inputs;
+        QVector<PortLogic> outputs;
+    };
+
+    struct Port {
+        LogicElement *logic = nullptr;
+        int port = 0;
+        QPointF position;
+    };
+
+    static PortLogic inputPortProperties(const ElementType type, const int port);
+    std::shared_ptr<LogicElement> buildLogicElement(const PandaElement &elm, const int inputSize, const int outputSize);
+
+    //! Builds the logic of every element of the file and connects them. ICs return their port nodes instead of
+    //! registering top-level inputs and outputs. Elements are named after @p path, the ICs they are in.
+    ICLogic instantiate(const PandaFile &pandaFile, const bool isIC, const int depth, const QString &path);
+    PandaFile icFile(const QString &fileName);
+
+    std::shared_ptr<LogicArena> m_arena;
+    LogicInput m_globalGND{false};
+    LogicInput m_globalVCC{true};
+    QHash<QString, PandaFile> m_icFiles;
+    QHash<const LogicElement *, QString> m_elementNames;
+    QString m_directory;
+    QStringList m_inputLabels;
+    QStringList m_outputLabels;
+    QVector<Port> m_inputs;
+    QVector<Port> m_outputs;
+    QVector<std::shared_ptr<LogicElement>> m_logicElms;
+    std::unique_ptr<Netlist> m_netlist;
+    std::vector<quint64> m_initialState;
+};
@@ -0,0 +1,317 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pandareader.h"
+
+#include "common.h"
+#include "globalproperties.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QKeySequence>
+#include <QRectF>
+
+namespace
+{
+    // Same values as GraphicElement::Type and QNEConnection::Type, which are QGraphicsItem::UserType + 3 and + 2.
+    const int elementItemType = 65536 + 3;
+    const int connectionItemType = 65536 + 2;
+    const quint64 maximumValidPortSize = 256;
+}
+
+PandaFile PandaReader::read(const QString &fileName)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw Pandaception(tr("Error opening file: ") + file.errorString());
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    return read(stream);
+}
+
+PandaFile PandaReader::read(QDataStream &stream)
+{
+    PandaFile pandaFile;
+
+    QString header; stream >> header;
+
+    if (!header.startsWith("WiRedPanda", Qt::CaseInsensitive)) {
+        throw Pandaception(tr("Invalid file format."));
+    }
+
+    pandaFile.version = VERSION(header.remove("WiRedPanda", Qt::CaseInsensitive));
+
+    if (pandaFile.version.isNull()) {
+        throw Pandaception(tr("Invalid version number."));
+    }
+
+    const QVersionNumber &version = pandaFile.version;
+
+    if (version >= VERSION("3.0")) {
+        QString dolphinFileName; stream >> dolphinFileName;
+    }
+
+    if (version >= VERSION("1.4")) {
+        QRectF rect; stream >> rect;
+    }
+
+    while (!stream.atEnd()) {
+        int type; stream >> type;
+
+        switch (type) {
+        case elementItemType: {
+            pandaFile.elements.append(readElement(stream, version));
+            break;
+        }
+
+        case connectionItemType: {
+            PandaConnection connection;
+            stream >> connection.port1;
+            stream >> connection.port2;
+            pandaFile.connections.append(connection);
+            break;
+        }
+
+        default:
+            throw Pandaception(tr("Invalid type. Data is possibly corrupted."));
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            throw Pandaception(tr("Corrupted DataStream!"));
+        }
+    }
+
+    return pandaFile;
+}
+
+PandaElement PandaReader::readElement(QDataStream &stream, const QVersionNumber &version)
+{
+    PandaElement elm;
+    stream >> elm.type;
+
+    if ((elm.type == ElementType::Unknown) || (elm.type == ElementType::JKLatch)) {
+        throw Pandaception(tr("Unknown type: ") + QString::number(static_cast<int>(elm.type)));
+    }
+
+    if (elm.type == ElementType::RemoteDevice) {
+        throw Pandaception(tr("Remote devices are not supported by the headless simulation."));
+    }
+
+    (version < VERSION("4.1")) ? readOldFormat(stream, elm, version) : readNewFormat(stream, elm);
+
+    readProperties(stream, elm, version);
+
+    return elm;
+}
+
+void PandaReader::readNewFormat(QDataStream &stream, PandaElement &elm)
+{
+    QMap<QString, QVariant> map; stream >> map;
+
+    elm.pos = map.value("pos").toPointF();
+    elm.label = map.value("label").toString();
+    elm.busWidth = map.value("busWidth", 1).toInt();
+    elm.delay = map.value("delay", -1).toInt();
+
+    const auto readPortIds = [&stream](QVector<quint64> &ports) {
+        QList<QMap<QString, QVariant>> portMap; stream >> portMap;
+
+        for (const auto &port : qAsConst(portMap)) {
+            ports.append(port.value("ptr").toULongLong());
+        }
+    };
+
+    readPortIds(elm.inputPorts);
+    readPortIds(elm.outputPorts);
+
+    QList<QMap<QString, QVariant>> skinsMap; stream >> skinsMap;
+}
+
+void PandaReader::readOldFormat(QDataStream &stream, PandaElement &elm, const QVersionNumber &version)
+{
+    stream >> elm.pos;
+    qreal angle; stream >> angle;
+
+    if (version >= VERSION("1.2")) {
+        stream >> elm.label;
+    }
+
+    if (version >= VERSION("1.3")) {
+        quint64 portsSize;
+
+        for (int index = 0; index < 4; ++index) {
+            stream >> portsSize;
+        }
+    }
+
+    if (version >= VERSION("1.9")) {
+        QKeySequence trigger; stream >> trigger;
+    }
+
+    if (version >= VERSION("4.01")) {
+        quint64 priority; stream >> priority;
+    }
+
+    readPorts(stream, elm.inputPorts);
+    readPorts(stream, elm.outputPorts);
+
+    if (version >= VERSION("2.7")) {
+        quint64 skinSize; stream >> skinSize;
+
+        if (skinSize > maximumValidPortSize) {
+            throw Pandaception(tr("Corrupted DataStream!"));
+        }
+
+        for (quint64 skin = 0; skin < skinSize; ++skin) {
+            QString name; stream >> name;
+        }
+    }
+}
+
+void PandaReader::readPorts(QDataStream &stream, QVector<quint64> &ports)
+{
+    quint64 size; stream >> size;
+
+    if (size > maximumValidPortSize) {
+        throw Pandaception(tr("Corrupted DataStream!"));
+    }
+
+    for (quint64 port = 0; port < size; ++port) {
+        quint64 ptr;  stream >> ptr;
+        QString name; stream >> name;
+        int flags;    stream >> flags;
+
+        ports.append(ptr);
+    }
+}
+
+void PandaReader::readProperties(QDataStream &stream, PandaElement &elm, const QVersionNumber &version)
+{
+    // Properties saved after the common ones by the elements that override GraphicElement::save().
+    switch (elm.type) {
+    case ElementType::Buzzer:
+    case ElementType::Clock:
+    case ElementType::Display14:
+    case ElementType::Display7:
+    case ElementType::IC:
+    case ElementType::InputButton:
+    case ElementType::InputRotary:
+    case ElementType::InputSwitch:
+    case ElementType::Led:
+        break;
+
+    default:
+        return;
+    }
+
+    if (version >= VERSION("4.1")) {
+        QMap<QString, QVariant> map; stream >> map;
+
+        elm.icFile = map.value("fileName").toString();
+        elm.currentPort = map.value("currentPort").toInt();
+        elm.isOn = map.value("isOn").toBool();
+        return;
+    }
+
+    QString string;
+    bool locked;
+
+    switch (elm.type) {
+    case ElementType::Buzzer: {
+        if (version >= VERSION("2.4")) {
+            stream >> string;
+        }
+        break;
+    }
+
+    case ElementType::Clock: {
+        if (version >= VERSION("1.1")) {
+            float frequency; stream >> frequency;
+
+            if (version >= VERSION("3.1")) {
+                stream >> locked;
+            }
+        }
+        break;
+    }
+
+    case ElementType::Display14:
+    case ElementType::Display7: {
+        if (elm.type == ElementType::Display7) {
+            // Displays saved before 1.6 and 1.7 had their inputs in a different order.
+            const auto remapInputs = [&elm](const QVector<int> &order) {
+                if (elm.inputPorts.size() != order.size()) {
+                    return;
+                }
+
+                QVector<quint64> ports = elm.inputPorts;
+
+                for (int index = 0; index < ports.size(); ++index) {
+                    ports[order.at(index)] = elm.inputPorts.at(index);
+                }
+
+                elm.inputPorts = ports;
+            };
+
+            if (version < VERSION("1.6")) {
+                remapInputs({2, 1, 4, 5, 0, 7, 3, 6});
+            }
+
+            if (version < VERSION("1.7")) {
+                remapInputs({2, 5, 4, 0, 7, 3, 6, 1});
+            }
+        }
+
+        if (version >= VERSION("3.1")) {
+            stream >> string;
+        }
+        break;
+    }
+
+    case ElementType::IC: {
+        if (version >= VERSION("1.2")) {
+            stream >> elm.icFile;
+        }
+        break;
+    }
+
+    case ElementType::InputButton: {
+        if (version >= VERSION("3.1")) {
+            stream >> locked;
+        }
+        break;
+    }
+
+    case ElementType::InputRotary: {
+        stream >> elm.currentPort;
+
+        if (version >= VERSION("3.1")) {
+            stream >> locked;
+        }
+        break;
+    }
+
+    case ElementType::InputSwitch: {
+        stream >> elm.isOn;
+
+        if (version >= VERSION("3.1")) {
+            stream >> locked;
+        }
+        break;
+    }
+
+    case ElementType::Led: {
+        if (version >= VERSION("1.1")) {
+            stream >> string;
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "enums.h"
+
+#include <QCoreApplication>
+#include <QPointF>
+#include <QVector>
+#include <QVersionNumber>
+
+//! Element of a panda file, holding only what the simulation needs.
+struct PandaElement
+{
+    ElementType type = ElementType::Unknown;
+    QPointF pos;
+    QString label;
+    QString icFile;
+    //! Ids used by the connections to refer to each port, in port order.
+    QVector<quint64> inputPorts;
+    QVector<quint64> outputPorts;
+    int busWidth = 1;
+    int currentPort = 0;
+    int delay = -1;
+    bool isOn = false;
+};
+
+//! Connection between two port ids of a panda file, in any order.
+struct PandaConnection
+{
+    quint64 port1 = 0;
+    quint64 port2 = 0;
+};
+
+struct PandaFile
+{
+    QVector<PandaElement> elements;
+    QVector<PandaConnection> connections;
+    QVersionNumber version;
+};
+
+/**
+ * @brief Reads panda files without building any graphic item.
+ *
+ * Mirrors the load() functions of GraphicElement, its subclasses and QNEConnection, skipping every property that
+ * only matters to the scene (rotation, skins, colors, triggers).
+ */
+class PandaReader
+{
+    Q_DECLARE_TR_FUNCTIONS(PandaReader)
+
+public:
+    static PandaFile read(QDataStream &stream);
+    static PandaFile read(const QString &fileName);
+
+private:
+    static PandaElement readElement(QDataStream &stream, const QVersionNumber &version);
+    static void readNewFormat(QDataStream &stream, PandaElement &elm);
+    static void readOldFormat(QDataStream &stream, PandaElement &elm, const QVersionNumber &version);
+    static void readPorts(QDataStream &stream, QVector<quint64> &ports);
+    static void readProperties(QDataStream &stream, PandaElement &elm, const QVersionNumber &version);
+};
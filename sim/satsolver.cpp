@@ -0,0 +1,407 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "satsolver.h"
+
+#include <algorithm>
+
+int SatSolver::createVariable()
+{
+    const int variable = variableCount();
+
+    m_watches.resize(m_watches.size() + 2);
+    m_values.push_back(-1);
+    m_phases.push_back(false);
+    m_seen.push_back(false);
+    m_levels.push_back(0);
+    m_reasons.push_back(-1);
+    m_activity.push_back(0.0);
+    m_heapPositions.push_back(-1);
+    heapInsert(variable);
+
+    return variable;
+}
+
+int SatSolver::variableCount() const
+{
+    return static_cast<int>(m_values.size());
+}
+
+void SatSolver::addClause(std::vector<int> literals)
+{
+    if (m_unsatisfiable) {
+        return;
+    }
+
+    std::sort(literals.begin(), literals.end());
+    literals.erase(std::unique(literals.begin(), literals.end()), literals.end());
+
+    // Clauses are added at level 0, where any assignment is final.
+    size_t kept = 0;
+
+    for (size_t index = 0; index < literals.size(); ++index) {
+        const int literal = literals.at(index);
+
+        if ((literalValue(literal) == 1) || ((index + 1 < literals.size()) && (literals.at(index + 1) == (literal ^ 1)))) {
+            return;
+        }
+
+        if (literalValue(literal) == -1) {
+            literals[kept++] = literal;
+        }
+    }
+
+    literals.resize(kept);
+
+    if (literals.empty()) {
+        m_unsatisfiable = true;
+    } else if (literals.size() == 1) {
+        assign(literals.front(), -1);
+        m_unsatisfiable = (propagate() >= 0);
+    } else {
+        m_clauses.push_back(std::move(literals));
+        watch(static_cast<int>(m_clauses.size()) - 1);
+    }
+}
+
+SatSolver::Result SatSolver::solve(const quint64 conflictLimit)
+{
+    if (m_unsatisfiable || (propagate() >= 0)) {
+        m_unsatisfiable = true;
+        return Result::Unsatisfiable;
+    }
+
+    std::vector<int> learnt;
+    quint64 conflicts = 0;
+    int restarts = 0;
+    quint64 restartConflicts = restartInterval * luby(restarts);
+
+    while (true) {
+        if (const int conflict = propagate(); conflict >= 0) {
+            if (decisionLevel() == 0) {
+                m_unsatisfiable = true;
+                return Result::Unsatisfiable;
+            }
+
+            int backtrackLevel = 0;
+            analyze(conflict, learnt, backtrackLevel);
+            backtrack(backtrackLevel);
+            learn(std::move(learnt));
+            m_activityIncrement /= activityDecay;
+            ++conflicts;
+
+            if ((conflictLimit > 0) && (conflicts >= conflictLimit)) {
+                backtrack(0);
+                return Result::Unknown;
+            }
+
+            if (--restartConflicts == 0) {
+                restartConflicts = restartInterval * luby(++restarts);
+                backtrack(0);
+            }
+
+            continue;
+        }
+
+        int variable = -1;
+
+        while (!m_heap.empty() && (variable < 0)) {
+            variable = heapPop();
+
+            if (m_values.at(variable) >= 0) {
+                variable = -1;
+            }
+        }
+
+        if (variable < 0) {
+            m_model = m_values;
+            backtrack(0);
+            return Result::Satisfiable;
+        }
+
+        m_trailLimits.push_back(static_cast<int>(m_trail.size()));
+        assign(2 * variable + (m_phases.at(variable) ? 0 : 1), -1);
+    }
+}
+
+bool SatSolver::value(const int variable) const
+{
+    return m_model.at(variable) == 1;
+}
+
+quint64 SatSolver::luby(int index)
+{
+    // 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8...
+    quint64 size = 1;
+    int sequence = 0;
+
+    while (size < static_cast<quint64>(index) + 1) {
+        ++sequence;
+        size = 2 * size + 1;
+    }
+
+    while (size - 1 != static_cast<quint64>(index)) {
+        size = (size - 1) >> 1;
+        --sequence;
+        index = static_cast<int>(static_cast<quint64>(index) % size);
+    }
+
+    return quint64(1) << sequence;
+}
+
+int SatSolver::literalValue(const int literal) const
+{
+    const int value = m_values[literal >> 1];
+    return (value < 0) ? -1 : (value ^ (literal & 1));
+}
+
+int SatSolver::decisionLevel() const
+{
+    return static_cast<int>(m_trailLimits.size());
+}
+
+void SatSolver::assign(const int literal, const int reason)
+{
+    const int variable = literal >> 1;
+
+    m_values[variable] = static_cast<qint8>((literal & 1) ^ 1);
+    m_levels[variable] = decisionLevel();
+    m_reasons[variable] = reason;
+    m_trail.push_back(literal);
+}
+
+int SatSolver::propagate()
+{
+    while (m_propagated < m_trail.size()) {
+        const int falseLiteral = m_trail[m_propagated++] ^ 1;
+        auto &watches = m_watches[falseLiteral];
+        size_t kept = 0;
+
+        for (size_t index = 0; index < watches.size(); ++index) {
+            const int clauseIndex = watches[index];
+            auto &clause = m_clauses[clauseIndex];
+
+            // The false literal goes second, so the first one is the literal a unit clause implies.
+            if (clause[0] == falseLiteral) {
+                std::swap(clause[0], clause[1]);
+            }
+
+            if (literalValue(clause[0]) == 1) {
+                watches[kept++] = clauseIndex;
+                continue;
+            }
+
+            bool moved = false;
+
+            for (size_t other = 2; other < clause.size(); ++other) {
+                if (literalValue(clause[other]) != 0) {
+                    std::swap(clause[1], clause[other]);
+                    m_watches[clause[1]].push_back(clauseIndex);
+                    moved = true;
+                    break;
+                }
+            }
+
+            if (moved) {
+                continue;
+            }
+
+            watches[kept++] = clauseIndex;
+
+            if (literalValue(clause[0]) == 0) {
+                std::copy(watches.cbegin() + static_cast<std::ptrdiff_t>(index) + 1, watches.cend(), watches.begin() + static_cast<std::ptrdiff_t>(kept));
+                watches.resize(kept + watches.size() - index - 1);
+                m_propagated = m_trail.size();
+                return clauseIndex;
+            }
+
+            assign(clause[0], clauseIndex);
+        }
+
+        watches.resize(kept);
+    }
+
+    return -1;
+}
+
+void SatSolver::analyze(const int conflict, std::vector<int> &learnt, int &backtrackLevel)
+{
+    learnt.assign(1, -1);
+    int pending = 0;
+    int literal = -1;
+    int reason = conflict;
+    auto trailIndex = static_cast<int>(m_trail.size()) - 1;
+
+    // Resolves the conflict with the reasons of the literals of the current level, latest first, until a single
+    // one of them is left.
+    do {
+        const auto &clause = m_clauses.at(reason);
+
+        for (size_t index = (literal < 0) ? 0 : 1; index < clause.size(); ++index) {
+            const int variable = clause.at(index) >> 1;
+
+            if (!m_seen[variable] && (m_levels[variable] > 0)) {
+                m_seen[variable] = true;
+                bump(variable);
+
+                if (m_levels[variable] == decisionLevel()) {
+                    ++pending;
+                } else {
+                    learnt.push_back(clause.at(index));
+                }
+            }
+        }
+
+        while (!m_seen[m_trail[trailIndex] >> 1]) {
+            --trailIndex;
+        }
+
+        literal = m_trail[trailIndex--];
+        reason = m_reasons[literal >> 1];
+        m_seen[literal >> 1] = false;
+        --pending;
+    } while (pending > 0);
+
+    learnt[0] = literal ^ 1;
+    backtrackLevel = 0;
+
+    for (size_t index = 1; index < learnt.size(); ++index) {
+        m_seen[learnt.at(index) >> 1] = false;
+
+        if (m_levels[learnt.at(index) >> 1] > backtrackLevel) {
+            backtrackLevel = m_levels[learnt.at(index) >> 1];
+            std::swap(learnt[1], learnt[index]);
+        }
+    }
+}
+
+void SatSolver::backtrack(const int level)
+{
+    if (decisionLevel() <= level) {
+        return;
+    }
+
+    const auto begin = static_cast<size_t>(m_trailLimits.at(level));
+
+    for (size_t index = m_trail.size(); index-- > begin;) {
+        const int variable = m_trail.at(index) >> 1;
+
+        m_phases[variable] = (m_values.at(variable) == 1);
+        m_values[variable] = -1;
+        m_reasons[variable] = -1;
+        heapInsert(variable);
+    }
+
+    m_trail.resize(begin);
+    m_trailLimits.resize(level);
+    m_propagated = m_trail.size();
+}
+
+void SatSolver::learn(std::vector<int> &&learnt)
+{
+    if (learnt.size() == 1) {
+        assign(learnt.front(), -1);
+        return;
+    }
+
+    const int asserting = learnt.front();
+    m_clauses.push_back(std::move(learnt));
+    const int clause = static_cast<int>(m_clauses.size()) - 1;
+    watch(clause);
+    assign(asserting, clause);
+}
+
+void SatSolver::watch(const int clause)
+{
+    m_watches[m_clauses.at(clause).at(0)].push_back(clause);
+    m_watches[m_clauses.at(clause).at(1)].push_back(clause);
+}
+
+void SatSolver::bump(const int variable)
+{
+    m_activity[variable] += m_activityIncrement;
+
+    if (m_activity[variable] > 1e100) {
+        for (auto &activity : m_activity) {
+            activity *= 1e-100;
+        }
+
+        m_activityIncrement *= 1e-100;
+    }
+
+    if (m_heapPositions[variable] >= 0) {
+        heapUp(m_heapPositions[variable]);
+    }
+}
+
+void SatSolver::heapInsert(const int variable)
+{
+    if (m_heapPositions[variable] >= 0) {
+        return;
+    }
+
+    m_heapPositions[variable] = static_cast<int>(m_heap.size());
+    m_heap.push_back(variable);
+    heapUp(m_heapPositions[variable]);
+}
+
+void SatSolver::heapUp(int position)
+{
+    const int variable = m_heap[position];
+
+    while (position > 0) {
+        const int parent = (position - 1) / 2;
+
+        if (m_activity[m_heap[parent]] >= m_activity[variable]) {
+            break;
+        }
+
+        m_heap[position] = m_heap[parent];
+        m_heapPositions[m_heap[position]] = position;
+        position = parent;
+    }
+
+    m_heap[position] = variable;
+    m_heapPositions[variable] = position;
+}
+
+void SatSolver::heapDown(int position)
+{
+    const int variable = m_heap[position];
+    const auto size = static_cast<int>(m_heap.size());
+
+    while (2 * position + 1 < size) {
+        int child = 2 * position + 1;
+
+        if ((child + 1 < size) && (m_activity[m_heap[child + 1]] > m_activity[m_heap[child]])) {
+            ++child;
+        }
+
+        if (m_activity[m_heap[child]] <= m_activity[variable]) {
+            break;
+        }
+
+        m_heap[position] = m_heap[child];
+        m_heapPositions[m_heap[position]] = position;
+        position = child;
+    }
+
+    m_heap[position] = variable;
+    m_heapPositions[variable] = position;
+}
+
+int SatSolver::heapPop()
+{
+    const int variable = m_heap.front();
+    m_heapPositions[variable] = -1;
+
+    if (m_heap.size() > 1) {
+        m_heap.front() = m_heap.back();
+        m_heap.pop_back();
+        heapDown(0);
+    } else {
+        m_heap.pop_back();
+    }
+
+    return variable;
+}
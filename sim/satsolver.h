@@ -0,0 +1,84 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <vector>
+
+/**
+ * @brief Conflict-driven clause learning SAT solver, small enough for the miters of EquivalenceChecker.
+ *
+ * Literals are numbered like those of an AndInverterGraph: 2 * variable for the variable itself and
+ * 2 * variable + 1 for its negation. Clauses are watched by two literals, conflicts learn their first unique
+ * implication point, branching follows the activity of the variables and keeps their last phase, and the search
+ * restarts after a Luby sequence of conflicts. Learnt clauses are never deleted.
+ */
+class SatSolver
+{
+public:
+    enum class Result { Satisfiable, Unsatisfiable, Unknown };
+
+    SatSolver() = default;
+
+    int createVariable();
+    int variableCount() const;
+
+    //! Adds a clause, the disjunction of @p literals. Clauses are only added between calls to solve().
+    void addClause(std::vector<int> literals);
+
+    //! Looks for an assignment that satisfies every clause, giving up with Unknown after @p conflictLimit conflicts,
+    //! or never with 0.
+    Result solve(const quint64 conflictLimit = 0);
+
+    //! Value of @p variable in the assignment found by the last solve() that returned Satisfiable.
+    bool value(const int variable) const;
+
+private:
+    Q_DISABLE_COPY(SatSolver)
+
+    //! Conflicts before the first restart, multiplied by the Luby sequence for the next ones.
+    static constexpr quint64 restartInterval = 100;
+    static constexpr double activityDecay = 0.95;
+
+    static quint64 luby(int index);
+
+    //! 1 if @p literal is true, 0 if it is false and -1 if its variable is not assigned.
+    int literalValue(const int literal) const;
+    int decisionLevel() const;
+    void assign(const int literal, const int reason);
+    //! Propagates the assignments of the trail, returning the clause left with every literal false, or -1.
+    int propagate();
+    //! Learns the clause of the first unique implication point of @p conflict, its asserting literal first and a
+    //! literal of the level to go back to second.
+    void analyze(const int conflict, std::vector<int> &learnt, int &backtrackLevel);
+    void backtrack(const int level);
+    void learn(std::vector<int> &&learnt);
+    void watch(const int clause);
+    void bump(const int variable);
+
+    void heapInsert(const int variable);
+    void heapUp(int position);
+    void heapDown(int position);
+    int heapPop();
+
+    std::vector<std::vector<int>> m_clauses;
+    //! Clauses watching each literal, visited when it becomes false.
+    std::vector<std::vector<int>> m_watches;
+    std::vector<qint8> m_values;
+    std::vector<qint8> m_model;
+    std::vector<bool> m_phases;
+    std::vector<bool> m_seen;
+    std::vector<int> m_levels;
+    std::vector<int> m_reasons;
+    std::vector<int> m_trail;
+    std::vector<int> m_trailLimits;
+    std::vector<double> m_activity;
+    //! Variables by decreasing activity, and the position of each one in it, or -1.
+    std::vector<int> m_heap;
+    std::vector<int> m_heapPositions;
+    double m_activityIncrement = 1.0;
+    size_t m_propagated = 0;
+    bool m_unsatisfiable = false;
+};
@@ -0,0 +1,55 @@
+# Sources of the wpanda-sim library: the simulation core of the app and the headless tools built on it.
+
+include($$PWD/../app/logicelement/logicelement.pri)
+
+SOURCES += \
+    $$PWD/../app/clockqueue.cpp \
+    $$PWD/../app/common.cpp \
+    $$PWD/../app/enums.cpp \
+    $$PWD/../app/faultsimulator.cpp \
+    $$PWD/../app/logicarena.cpp \
+    $$PWD/../app/logicelement.cpp \
+    $$PWD/../app/nativecode.cpp \
+    $$PWD/../app/netlist.cpp \
+    $$PWD/../app/statehistory.cpp \
+    $$PWD/../app/threadpool.cpp \
+    $$PWD/../app/vcdwriter.cpp \
+    $$PWD/andinvertergraph.cpp \
+    $$PWD/batchgrader.cpp \
+    $$PWD/equivalencechecker.cpp \
+    $$PWD/faultcoverage.cpp \
+    $$PWD/headlesscircuit.cpp \
+    $$PWD/pandareader.cpp \
+    $$PWD/satsolver.cpp \
+    $$PWD/truthtable.cpp \
+    $$PWD/waveformreader.cpp
+
+HEADERS += \
+    $$PWD/../app/clockqueue.h \
+    $$PWD/../app/common.h \
+    $$PWD/../app/enums.h \
+    $$PWD/../app/faultsimulator.h \
+    $$PWD/../app/globalproperties.h \
+    $$PWD/../app/levelizer.h \
+    $$PWD/../app/logicarena.h \
+    $$PWD/../app/logicelement.h \
+    $$PWD/../app/nativecode.h \
+    $$PWD/../app/netlist.h \
+    $$PWD/../app/statehistory.h \
+    $$PWD/../app/threadpool.h \
+    $$PWD/../app/timingwheel.h \
+    $$PWD/../app/vcdwriter.h \
+    $$PWD/andinvertergraph.h \
+    $$PWD/batchgrader.h \
+    $$PWD/equivalencechecker.h \
+    $$PWD/faultcoverage.h \
+    $$PWD/headlesscircuit.h \
+    $$PWD/pandareader.h \
+    $$PWD/satsolver.h \
+    $$PWD/truthtable.h \
+    $$PWD/waveformreader.h
+
+INCLUDEPATH += \
+    $$PWD \
+    $$PWD/../app \
+    $$PWD/../app/logicelement
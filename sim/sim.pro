@@ -0,0 +1,22 @@
+# Headless simulation library: loads panda files straight into a Netlist, without any graphic item or widget.
+# QtGui is only needed to deserialize the QKeySequence triggers saved by old panda files.
+
+TARGET = wpanda-sim
+
+TEMPLATE = lib
+
+CONFIG += staticlib c++17 warn_on strict_c strict_c++
+
+QT = core gui
+
+VERSION = 4.1.12
+
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+DEFINES += QT_MESSAGELOGCONTEXT
+
+MOC_DIR     = build_files/moc
+OBJECTS_DIR = build_files/obj
+
+include(sim.pri)
@@ -0,0 +1,154 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "truthtable.h"
+
+#include "common.h"
+#include "headlesscircuit.h"
+#include "netlist.h"
+#include "threadpool.h"
+
+#include <QFile>
+
+#include <algorithm>
+
+namespace
+{
+    //! Words of combinations in a block, the unit of work of a thread.
+    const quint64 blockWords = 256;
+
+    //! Blocks per thread in each round, which bounds the memory held by the rows not yet written.
+    const int blocksPerThread = 4;
+
+    const char separator[] = " : ";
+    const int separatorLength = 3;
+}
+
+TruthTable::TruthTable(const HeadlessCircuit &circuit)
+    : m_circuit(circuit)
+    , m_netlist(circuit.netlist())
+{
+    if (!m_netlist->isCombinational()) {
+        throw Pandaception(tr("The truth table needs a combinational circuit, without memory elements nor feedback."));
+    }
+
+    if (circuit.inputCount() > maxInputs) {
+        throw Pandaception(tr("The truth table is limited to %1 inputs, the circuit has %2.").arg(maxInputs).arg(circuit.inputCount()));
+    }
+
+    for (int index = 0; index < circuit.inputCount(); ++index) {
+        m_inputSlots.append(circuit.inputSlot(index));
+    }
+
+    for (int index = 0; index < circuit.outputCount(); ++index) {
+        m_outputSlots.append(circuit.outputSlot(index));
+    }
+}
+
+quint64 TruthTable::rowCount() const
+{
+    return quint64(1) << m_inputSlots.size();
+}
+
+void TruthTable::save(const QString &fileName) const
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw Pandaception(tr("Error opening file: ") + file.errorString());
+    }
+
+    write(file);
+}
+
+void TruthTable::write(QIODevice &device) const
+{
+    QStringList header;
+
+    for (const auto &label : m_circuit.inputLabels()) {
+        header.append("\"" + label + "\"");
+    }
+
+    header.append(":");
+
+    for (const auto &label : m_circuit.outputLabels()) {
+        header.append("\"" + label + "\"");
+    }
+
+    const auto writeBytes = [&device](const QByteArray &bytes) {
+        if (device.write(bytes) != bytes.size()) {
+            throw Pandaception(tr("Could not write the truth table: ") + device.errorString());
+        }
+    };
+
+    writeBytes(header.join(' ').toUtf8() + '\n');
+
+    auto &threadPool = ThreadPool::instance();
+    const quint64 words = (rowCount() + 63) / 64;
+    const quint64 blockCount = (words + blockWords - 1) / blockWords;
+    const int roundSize = blocksPerThread * threadPool.threadCount();
+    QVector<QByteArray> blocks(roundSize);
+    QByteArray *blockData = blocks.data();
+
+    for (quint64 firstBlock = 0; firstBlock < blockCount; firstBlock += static_cast<quint64>(roundSize)) {
+        const int count = static_cast<int>(qMin(static_cast<quint64>(roundSize), blockCount - firstBlock));
+
+        threadPool.run(count, [&](const int block) {
+            const quint64 firstWord = (firstBlock + static_cast<quint64>(block)) * blockWords;
+            blockData[block] = rows(firstWord, qMin(blockWords, words - firstWord));
+        });
+
+        for (int block = 0; block < count; ++block) {
+            writeBytes(blockData[block]);
+            blockData[block].clear();
+        }
+    }
+}
+
+QByteArray TruthTable::rows(const quint64 firstWord, const quint64 wordCount) const
+{
+    // Input N of lane L of word W is bit N of the combination W * 64 + L: the lowest six inputs follow the same
+    // pattern in every word, the others are constant within a word.
+    const quint64 patterns[] = {0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC, 0xF0F0F0F0F0F0F0F0,
+                                0xFF00FF00FF00FF00, 0xFFFF0000FFFF0000, 0xFFFFFFFF00000000};
+
+    const int inputCount = m_inputSlots.size();
+    const int outputCount = m_outputSlots.size();
+    const int rowLength = inputCount + separatorLength + outputCount + 1;
+    const quint64 firstRow = firstWord * 64;
+    const quint64 endRow = qMin(rowCount(), (firstWord + wordCount) * 64);
+
+    QByteArray text(static_cast<int>(endRow - firstRow) * rowLength, '0');
+    char *row = text.data();
+    auto lanes = m_netlist->lanes();
+
+    for (quint64 word = firstWord; word < firstWord + wordCount; ++word) {
+        for (int input = 0; input < inputCount; ++input) {
+            lanes[m_inputSlots.at(input)] = (input < 6) ? patterns[input] : (((word >> (input - 6)) & 1) ? ~quint64(0) : 0);
+        }
+
+        m_netlist->updateLanes(lanes);
+
+        const int laneCount = static_cast<int>(qMin(quint64(64), endRow - word * 64));
+
+        for (int lane = 0; lane < laneCount; ++lane) {
+            for (int input = 0; input < inputCount; ++input) {
+                row[input] = static_cast<char>('0' + ((lanes[m_inputSlots.at(input)] >> lane) & 1));
+            }
+
+            std::copy(separator, separator + separatorLength, row + inputCount);
+
+            // Outputs that are not connected stay at '0'.
+            for (int output = 0; output < outputCount; ++output) {
+                if (const int slot = m_outputSlots.at(output); slot >= 0) {
+                    row[inputCount + separatorLength + output] = static_cast<char>('0' + ((lanes[slot] >> lane) & 1));
+                }
+            }
+
+            row[rowLength - 1] = '\n';
+            row += rowLength;
+        }
+    }
+
+    return text;
+}
@@ -0,0 +1,48 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QVector>
+
+class HeadlessCircuit;
+class Netlist;
+class QIODevice;
+
+/**
+ * @brief Exhaustive truth table of a combinational HeadlessCircuit, streamed row by row.
+ *
+ * The first line names the inputs and outputs, in the order of the circuit; each next line holds the bits of an
+ * input combination, " : " and the bits of the outputs. The first input is the lowest bit of the combination,
+ * as in beWavedDolphin. Combinations are evaluated 64 at a time on the lanes of the netlist, in blocks spread
+ * over the ThreadPool, and each round of blocks is written before the next one starts, so the table is never
+ * held in memory as a whole.
+ */
+class TruthTable
+{
+    Q_DECLARE_TR_FUNCTIONS(TruthTable)
+
+public:
+    //! Throws a Pandaception if the circuit has memory or feedback, or more than maxInputs inputs.
+    explicit TruthTable(const HeadlessCircuit &circuit);
+
+    static constexpr int maxInputs = 32;
+
+    quint64 rowCount() const;
+
+    //! Writes the table to the file @p fileName. Throws a Pandaception if it cannot be written.
+    void save(const QString &fileName) const;
+    void write(QIODevice &device) const;
+
+private:
+    Q_DISABLE_COPY(TruthTable)
+
+    //! Rows of the @p wordCount words of combinations from @p firstWord, 64 combinations per word.
+    QByteArray rows(const quint64 firstWord, const quint64 wordCount) const;
+
+    const HeadlessCircuit &m_circuit;
+    const Netlist *m_netlist;
+    QVector<int> m_inputSlots;
+    QVector<int> m_outputSlots;
+};
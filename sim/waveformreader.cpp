@@ -0,0 +1,91 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "waveformreader.h"
+
+#include "common.h"
+
+#include <QDataStream>
+#include <QFile>
+
+void Waveform::resize(const int rows_, const int columns_)
+{
+    if ((rows_ < 0) || (columns_ < 1)) {
+        throw Pandaception(WaveformReader::tr("Invalid number of rows or columns."));
+    }
+
+    rows = rows_;
+    columns = columns_;
+    words = QVector<QVector<quint64>>(rows, QVector<quint64>((columns + 63) / 64, 0));
+}
+
+void Waveform::set(const int row, const int column, const bool value)
+{
+    if (value) {
+        words[row][column / 64] |= quint64(1) << (column % 64);
+    }
+}
+
+bool Waveform::at(const int row, const int column) const
+{
+    return (words.at(row).at(column / 64) >> (column % 64)) & 1;
+}
+
+Waveform WaveformReader::read(const QString &fileName)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw Pandaception(tr("Error opening file: ") + fileName + ": " + file.errorString());
+    }
+
+    Waveform waveform;
+
+    if (fileName.endsWith(".dolphin")) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_12);
+
+        QString header; stream >> header;
+
+        if (!header.startsWith("beWavedDolphin")) {
+            throw Pandaception(tr("Invalid file format: ") + fileName);
+        }
+
+        qint64 rows; stream >> rows;
+        qint64 cols; stream >> cols;
+        waveform.resize(static_cast<int>(rows), static_cast<int>(cols));
+
+        for (int col = 0; col < waveform.columns; ++col) {
+            for (int row = 0; row < waveform.rows; ++row) {
+                qint64 value; stream >> value;
+                waveform.set(row, col, value != 0);
+            }
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            throw Pandaception(tr("Truncated file: ") + fileName);
+        }
+
+        return waveform;
+    }
+
+    const auto wordList(file.readAll().split(','));
+
+    if (wordList.size() < 2) {
+        throw Pandaception(tr("Invalid file format: ") + fileName);
+    }
+
+    waveform.resize(wordList.at(0).trimmed().toInt(), wordList.at(1).trimmed().toInt());
+
+    if (wordList.size() < 2 + waveform.rows * waveform.columns) {
+        throw Pandaception(tr("Truncated file: ") + fileName);
+    }
+
+    for (int row = 0; row < waveform.rows; ++row) {
+        for (int col = 0; col < waveform.columns; ++col) {
+            waveform.set(row, col, wordList.at(2 + col + row * waveform.columns).trimmed().toInt() != 0);
+        }
+    }
+
+    return waveform;
+}
@@ -0,0 +1,35 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QVector>
+
+//! Signals of a beWavedDolphin file, one row per signal, packed 64 columns per word with the first one in the
+//! lowest bit.
+struct Waveform
+{
+    int rows = 0;
+    int columns = 0;
+    QVector<QVector<quint64>> words;
+
+    //! Clears the waveform to @p rows_ signals of @p columns_ steps. Throws a Pandaception if either is invalid.
+    void resize(const int rows_, const int columns_);
+    void set(const int row, const int column, const bool value);
+    bool at(const int row, const int column) const;
+};
+
+/**
+ * @brief Reads the stimuli and traces used by the headless modes.
+ *
+ * Both the .dolphin and the .csv files of beWavedDolphin are read, the latter being also what -w and -c print.
+ */
+class WaveformReader
+{
+    Q_DECLARE_TR_FUNCTIONS(WaveformReader)
+
+public:
+    //! Throws a Pandaception if @p fileName cannot be read.
+    static Waveform read(const QString &fileName);
+};
@@ -10,6 +10,7 @@ DEFINES += CURRENTDIR=\\\"$$_PRO_FILE_PWD_\\\"
 
 SOURCES += \
     testmain.cpp \
+    testbenchmarks.cpp \
     testelements.cpp \
     testfiles.cpp \
     testcommands.cpp \
@@ -19,6 +20,7 @@ SOURCES += \
     testlogicelements.cpp
 
 HEADERS += \
+    testbenchmarks.h \
     testelements.h \
     testfiles.h \
     testcommands.h \
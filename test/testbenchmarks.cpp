@@ -0,0 +1,388 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "testbenchmarks.h"
+
+#include "and.h"
+#include "elementmapping.h"
+#include "globalproperties.h"
+#include "inputswitch.h"
+#include "logicand.h"
+#include "logicarena.h"
+#include "logicbusgate.h"
+#include "logicbusmux.h"
+#include "logicdemux.h"
+#include "logicdflipflop.h"
+#include "logicdlatch.h"
+#include "logicinput.h"
+#include "logicjkflipflop.h"
+#include "logicjoiner.h"
+#include "logicmux.h"
+#include "logicnand.h"
+#include "logicnode.h"
+#include "logicnor.h"
+#include "logicnot.h"
+#include "logicor.h"
+#include "logicoutput.h"
+#include "logicsplitter.h"
+#include "logicsrflipflop.h"
+#include "logictflipflop.h"
+#include "logicxnor.h"
+#include "logicxor.h"
+#include "network.h"
+#include "qneconnection.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTest>
+
+#include <memory>
+
+namespace
+{
+    //! Keeps the compiler from dropping the work of a benchmark.
+    volatile quint64 sink = 0;
+
+    //! Only gathers its inputs, so updateInputs() is timed on its own.
+    class LogicInputGather : public LogicElement
+    {
+    public:
+        explicit LogicInputGather(const int inputSize)
+            : LogicElement(inputSize, 1)
+        {
+        }
+
+        void updateLogic() override { updateInputs(); }
+    };
+
+    //! Fixed amount of plain integer work, the unit that costs are measured in.
+    void calibrationLoop()
+    {
+        quint64 value = sink + 88172645463325252ULL;
+
+        for (int round = 0; round < 256; ++round) {
+            value ^= value << 13;
+            value ^= value >> 7;
+            value ^= value << 17;
+        }
+
+        sink = value;
+    }
+
+    //! Nanoseconds per call of @p function, the best of a few runs long enough for the timer resolution not to matter.
+    template <typename Function>
+    double nanosecondsPerCall(Function function)
+    {
+        const qint64 runTime = 2'000'000;
+        qint64 calls = 1;
+        QElapsedTimer timer;
+
+        while (true) {
+            timer.start();
+
+            for (qint64 call = 0; call < calls; ++call) {
+                function();
+            }
+
+            if (timer.nsecsElapsed() >= runTime) {
+                break;
+            }
+
+            calls *= 2;
+        }
+
+        double best = static_cast<double>(timer.nsecsElapsed()) / static_cast<double>(calls);
+
+        for (int run = 1; run < 5; ++run) {
+            timer.start();
+
+            for (qint64 call = 0; call < calls; ++call) {
+                function();
+            }
+
+            best = qMin(best, static_cast<double>(timer.nsecsElapsed()) / static_cast<double>(calls));
+        }
+
+        return best;
+    }
+
+    std::unique_ptr<LogicElement> buildKernel(const QString &name)
+    {
+        if (name == "LogicAnd")        { return std::make_unique<LogicAnd>(2); }
+        if (name == "LogicBusGate")    { return std::make_unique<LogicBusGate>(LogicType::BusAnd, 2, 8); }
+        if (name == "LogicBusMux")     { return std::make_unique<LogicBusMux>(8); }
+        if (name == "LogicDFlipFlop")  { return std::make_unique<LogicDFlipFlop>(); }
+        if (name == "LogicDLatch")     { return std::make_unique<LogicDLatch>(); }
+        if (name == "LogicDemux")      { return std::make_unique<LogicDemux>(); }
+        if (name == "LogicJKFlipFlop") { return std::make_unique<LogicJKFlipFlop>(); }
+        if (name == "LogicJoiner")     { return std::make_unique<LogicJoiner>(8); }
+        if (name == "LogicMux")        { return std::make_unique<LogicMux>(); }
+        if (name == "LogicNand")       { return std::make_unique<LogicNand>(2); }
+        if (name == "LogicNode")       { return std::make_unique<LogicNode>(); }
+        if (name == "LogicNor")        { return std::make_unique<LogicNor>(2); }
+        if (name == "LogicNot")        { return std::make_unique<LogicNot>(); }
+        if (name == "LogicOr")         { return std::make_unique<LogicOr>(2); }
+        if (name == "LogicOutput")     { return std::make_unique<LogicOutput>(1); }
+        if (name == "LogicSRFlipFlop") { return std::make_unique<LogicSRFlipFlop>(); }
+        if (name == "LogicSplitter")   { return std::make_unique<LogicSplitter>(8); }
+        if (name == "LogicTFlipFlop")  { return std::make_unique<LogicTFlipFlop>(); }
+        if (name == "LogicXnor")       { return std::make_unique<LogicXnor>(2); }
+        if (name == "LogicXor")        { return std::make_unique<LogicXor>(2); }
+        return {};
+    }
+}
+
+void TestBenchmarks::initTestCase()
+{
+    // Wall-clock timings are only meaningful on an idle machine, so the benchmarks run when asked for.
+    if (!qEnvironmentVariableIsSet("WPANDA_BENCHMARK") && !qEnvironmentVariableIsSet("WPANDA_BENCHMARK_RECORD")) {
+        QSKIP("Benchmarks are disabled, enable them with WPANDA_BENCHMARK=1");
+    }
+
+    QFile file(QString(CURRENTDIR) + "/benchmarks.json");
+
+    if (file.open(QIODevice::ReadOnly)) {
+        const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+        m_baseline = json.value("benchmarks").toObject();
+        m_tolerance = json.value("tolerance").toDouble(m_tolerance);
+    } else {
+        qWarning() << "No benchmark baseline:" << file.errorString();
+    }
+
+    if (const QString tolerance = qEnvironmentVariable("WPANDA_BENCHMARK_TOLERANCE"); !tolerance.isEmpty()) {
+        m_tolerance = tolerance.toDouble();
+    }
+
+    m_reference = nanosecondsPerCall(calibrationLoop);
+}
+
+void TestBenchmarks::cleanupTestCase()
+{
+    if (!qEnvironmentVariableIsSet("WPANDA_BENCHMARK_RECORD")) {
+        return;
+    }
+
+    // Benchmarks that did not run, because of a filter on the command line, keep their baseline.
+    QJsonObject benchmarks = m_baseline;
+
+    for (auto it = m_results.cbegin(); it != m_results.cend(); ++it) {
+        benchmarks.insert(it.key(), it.value().toDouble());
+    }
+
+    const QJsonObject json{
+        {"tolerance", m_tolerance},
+        {"benchmarks", benchmarks},
+    };
+
+    QFile file(QString(CURRENTDIR) + "/benchmarks.json");
+    QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+    file.write(QJsonDocument(json).toJson());
+}
+
+void TestBenchmarks::compare(const QString &name, const double nanoseconds)
+{
+    // QBENCHMARK runs a test function again until its timing is reliable, but each benchmark is compared once.
+    if (m_results.contains(name)) {
+        return;
+    }
+
+    const double cost = nanoseconds / m_reference;
+    m_results.insert(name, cost);
+    qInfo().noquote() << QString("%1: %2 ns, %3 calibration loops").arg(name).arg(nanoseconds, 0, 'f', 1).arg(cost, 0, 'f', 4);
+
+    // A new benchmark takes its baseline from the run that records it, and is skipped until then.
+    if (!m_baseline.contains(name)) {
+        if (!qEnvironmentVariableIsSet("WPANDA_BENCHMARK_RECORD")) {
+            QSKIP(qPrintable(QString("No baseline for %1, record it with WPANDA_BENCHMARK_RECORD=1").arg(name)));
+        }
+
+        return;
+    }
+
+    // Debug builds are not optimized, so only release builds are held to the baseline.
+#ifdef QT_NO_DEBUG
+    const double baseline = m_baseline.value(name).toDouble();
+    QVERIFY2(cost <= baseline * (1.0 + m_tolerance / 100.0),
+             qPrintable(QString("%1 costs %2, more than %3% over its baseline of %4").arg(name).arg(cost).arg(m_tolerance).arg(baseline)));
+#endif
+}
+
+void TestBenchmarks::benchmarkLogicKernel_data()
+{
+    QTest::addColumn<QString>("kernel");
+
+    const QStringList kernels{
+        "LogicAnd", "LogicBusGate", "LogicBusMux", "LogicDFlipFlop", "LogicDLatch", "LogicDemux", "LogicJKFlipFlop",
+        "LogicJoiner", "LogicMux", "LogicNand", "LogicNode", "LogicNor", "LogicNot", "LogicOr", "LogicOutput",
+        "LogicSRFlipFlop", "LogicSplitter", "LogicTFlipFlop", "LogicXnor", "LogicXor",
+    };
+
+    for (const auto &kernel : kernels) {
+        QTest::newRow(qPrintable(kernel)) << kernel;
+    }
+}
+
+void TestBenchmarks::benchmarkLogicKernel()
+{
+    QFETCH(QString, kernel);
+
+    LogicInput driver(false, maxBusWidth);
+    const auto elm = buildKernel(kernel);
+    QVERIFY(elm);
+
+    for (int index = 0; index < static_cast<int>(elm->getInputAmount()); ++index) {
+        elm->connectPredecessor(index, &driver, 0);
+    }
+
+    // Every input reads the first output of the driver, which toggles on each call, so no kernel settles on one path.
+    bool value = false;
+
+    const auto update = [&] {
+        value = !value;
+        driver.setOutputValue(0, value);
+        elm->updateLogic();
+    };
+
+    QBENCHMARK {
+        update();
+    }
+
+    compare(kernel + "::updateLogic", nanosecondsPerCall(update));
+}
+
+void TestBenchmarks::benchmarkUpdateInputs()
+{
+    LogicInput driver(false, maxBusWidth);
+    LogicInputGather elm(8);
+
+    for (int index = 0; index < 8; ++index) {
+        elm.connectPredecessor(index, &driver, index);
+    }
+
+    const auto update = [&elm] { elm.updateLogic(); };
+
+    QBENCHMARK {
+        update();
+    }
+
+    compare("LogicElement::updateInputs", nanosecondsPerCall(update));
+}
+
+void TestBenchmarks::benchmarkElementMappingSort()
+{
+    // Each gate is fed by the previous one and by one halfway back, so the levels are uneven.
+    const int gateCount = 1024;
+    QVector<GraphicElement *> elements{new InputSwitch()};
+    QVector<QNEConnection *> connections;
+
+    const auto connect = [&connections](GraphicElement *from, GraphicElement *to, const int inputPort) {
+        auto *connection = new QNEConnection();
+        connection->setStartPort(from->outputPort());
+        connection->setEndPort(to->inputPort(inputPort));
+        connections.append(connection);
+    };
+
+    for (int gate = 0; gate < gateCount; ++gate) {
+        auto *elm = new And();
+        connect(elements.last(), elm, 0);
+        connect(elements.at(elements.size() / 2), elm, 1);
+        elements.append(elm);
+    }
+
+    {
+        ElementMapping mapping(elements, LogicArena::create());
+
+        // Priorities are kept between sorts, so they are cleared to levelize the whole circuit every time.
+        const auto sort = [&mapping] {
+            for (const auto &logic : mapping.logicElms()) {
+                logic->clearPriority();
+            }
+
+            mapping.sort();
+        };
+
+        QBENCHMARK {
+            sort();
+        }
+
+        compare("ElementMapping::sort", nanosecondsPerCall(sort));
+    }
+
+    // Connections first, as they detach themselves from the ports of the elements.
+    qDeleteAll(connections);
+    qDeleteAll(elements);
+}
+
+void TestBenchmarks::benchmarkGraphicElementSave()
+{
+    And elm;
+    elm.setLabel("benchmark");
+
+    const auto save = [&elm] {
+        QByteArray bytes;
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_12);
+        elm.save(stream);
+        sink = sink + static_cast<quint64>(bytes.size());
+    };
+
+    QBENCHMARK {
+        save();
+    }
+
+    compare("GraphicElement::save", nanosecondsPerCall(save));
+}
+
+void TestBenchmarks::benchmarkGraphicElementLoad()
+{
+    QByteArray bytes;
+
+    {
+        And elm;
+        elm.setLabel("benchmark");
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_12);
+        elm.save(stream);
+    }
+
+    And elm;
+
+    const auto load = [&bytes, &elm] {
+        QDataStream stream(bytes);
+        stream.setVersion(QDataStream::Qt_5_12);
+        QMap<quint64, QNEPort *> portMap;
+        elm.load(stream, portMap, GlobalProperties::version);
+    };
+
+    QBENCHMARK {
+        load();
+    }
+
+    QCOMPARE(elm.label(), QString("benchmark"));
+    compare("GraphicElement::load", nanosecondsPerCall(load));
+}
+
+void TestBenchmarks::benchmarkNetworkIncomingMessage()
+{
+    // The payload of an output message after a session token, without the opcode.
+    NetworkOutgoingMessage message(0);
+    message.addString("0123456789abcdef");
+    message.addByte<quint32>(7);
+    message.addByte<quint8>(1);
+    const QByteArray payload = message.mid(1);
+
+    const auto parse = [&payload] {
+        NetworkIncomingMessage incoming(0, payload);
+        const QString token = incoming.popString();
+        const auto pinId = incoming.pop<quint32>();
+        const auto value = incoming.pop<quint8>();
+        sink = sink + static_cast<quint64>(token.size()) + pinId + value;
+    };
+
+    QBENCHMARK {
+        parse();
+    }
+
+    compare("NetworkIncomingMessage", nanosecondsPerCall(parse));
+}
@@ -0,0 +1,41 @@
+// Copyright 2015 - 2022, GIBIS-UNIFESP and the WiRedPanda contributors
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QJsonObject>
+#include <QObject>
+#include <QVariantMap>
+
+/**
+ * @brief Micro-benchmarks of the hot paths, checked against the baseline in benchmarks.json.
+ *
+ * Only run with WPANDA_BENCHMARK=1, as timings are not reliable on a loaded machine. Costs are kept relative to a
+ * calibration loop, so the baseline holds on other machines. A benchmark fails when it is slower than its baseline
+ * by more than the tolerance of the file, or WPANDA_BENCHMARK_TOLERANCE percent, and is skipped when it has no
+ * baseline. Running with WPANDA_BENCHMARK_RECORD=1 writes the measured costs as the new baseline.
+ */
+class TestBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchmarkElementMappingSort();
+    void benchmarkGraphicElementLoad();
+    void benchmarkGraphicElementSave();
+    void benchmarkLogicKernel();
+    void benchmarkLogicKernel_data();
+    void benchmarkNetworkIncomingMessage();
+    void benchmarkUpdateInputs();
+    void cleanupTestCase();
+    void initTestCase();
+
+private:
+    //! Records @p nanoseconds per call for @p name and compares it against the baseline.
+    void compare(const QString &name, const double nanoseconds);
+
+    QJsonObject m_baseline;
+    QVariantMap m_results;
+    double m_reference = 1.0;
+    double m_tolerance = 50.0;
+};
@@ -4,7 +4,15 @@
 #include "testcommands.h"
 
 #include "and.h"
+#include "clock.h"
 #include "commands.h"
+#include "dflipflop.h"
+#include "inputbutton.h"
+#include "led.h"
+#include "netlist.h"
+#include "not.h"
+#include "qneconnection.h"
+#include "qneport.h"
 #include "scene.h"
 #include "workspace.h"
 
@@ -39,3 +47,105 @@ void TestCommands::testAddDeleteCommands()
     QCOMPARE(scene->elements().size(), 0);
     QCOMPARE(undoStack->index(), 1);
 }
+
+void TestCommands::testDeleteWhileRunning()
+{
+    auto *button = new InputButton();
+    auto *clock = new Clock();
+    auto *flipFlop = new DFlipFlop();
+    auto *notItem = new Not();
+    auto *flipFlopLed = new Led();
+    auto *notLed = new Led();
+    QList<QGraphicsItem *> items{button, clock, flipFlop, notItem, flipFlopLed, notLed};
+
+    const auto connect = [&items](QNEOutputPort *start, QNEInputPort *end) {
+        auto *connection = new QNEConnection();
+        connection->setStartPort(start);
+        connection->setEndPort(end);
+        items.append(connection);
+    };
+
+    connect(button->outputPort(), flipFlop->inputPort(0));
+    connect(clock->outputPort(), flipFlop->inputPort(1));
+    connect(flipFlop->outputPort(0), flipFlopLed->inputPort());
+    connect(button->outputPort(), notItem->inputPort());
+    connect(notItem->outputPort(), notLed->inputPort());
+    clock->setFrequency(50);
+
+    WorkSpace workspace;
+    auto *scene = workspace.scene();
+    auto *simulation = scene->simulation();
+    scene->receiveCommand(new AddItemsCommand(items, scene));
+
+    simulation->start();
+    button->setOn();
+    QTRY_COMPARE(flipFlopLed->inputPort()->status(), Status::Active);
+
+    // Deleting patches the running simulation layer, so the flip-flop state goes away with it while the rest of the
+    // circuit keeps running, without the layer being generated again.
+    flipFlop->setSelected(true);
+    scene->deleteAction();
+    QVERIFY(simulation->isRunning());
+    QTRY_COMPARE(flipFlopLed->inputPort()->status(), Status::Inactive);
+
+    button->setOff();
+    QTRY_COMPARE(notLed->inputPort()->status(), Status::Active);
+    button->setOn();
+    QTRY_COMPARE(notLed->inputPort()->status(), Status::Inactive);
+
+    scene->undoStack()->undo();
+    QTRY_COMPARE(flipFlopLed->inputPort()->status(), Status::Active);
+
+    simulation->stop();
+    QCOMPARE(simulation->counters().sample().initializations, quint64(1));
+}
+
+void TestCommands::testNetlistDelta()
+{
+    auto *button = new InputButton();
+    auto *notItem = new Not();
+    auto *led = new Led();
+    auto *connection1 = new QNEConnection();
+    auto *connection2 = new QNEConnection();
+
+    connection1->setStartPort(button->outputPort());
+    connection1->setEndPort(notItem->inputPort());
+    connection2->setStartPort(notItem->outputPort());
+    connection2->setEndPort(led->inputPort());
+
+    WorkSpace workspace;
+    auto *scene = workspace.scene();
+    auto *simulation = scene->simulation();
+    auto *undoStack = scene->undoStack();
+    scene->receiveCommand(new AddItemsCommand({button, notItem, led}, scene));
+
+    simulation->update();
+    QCOMPARE(led->inputPort()->status(), Status::Active);
+
+    // Edits patch the simulation layer, so the elements they do not touch keep their logic.
+    auto *buttonLogic = button->logic();
+    auto *ledLogic = led->logic();
+
+    scene->receiveCommand(new MorphCommand({notItem}, ElementType::Node, scene));
+    simulation->update();
+    QCOMPARE(led->inputPort()->status(), Status::Inactive);
+    QCOMPARE(simulation->netlist()->elementCount(), 3);
+    QCOMPARE(button->logic(), buttonLogic);
+    QCOMPARE(led->logic(), ledLogic);
+
+    undoStack->undo();
+    simulation->update();
+    QCOMPARE(led->inputPort()->status(), Status::Active);
+    QCOMPARE(button->logic(), buttonLogic);
+
+    button->setOn();
+    simulation->update();
+    QCOMPARE(led->inputPort()->status(), Status::Inactive);
+
+    // Each morph retires one logic element; once more are retired than in use, the layer is generated again.
+    undoStack->redo();
+    undoStack->undo();
+    simulation->update();
+    QVERIFY(button->logic() != buttonLogic);
+    QCOMPARE(led->inputPort()->status(), Status::Inactive);
+}
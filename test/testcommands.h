@@ -11,4 +11,6 @@ class TestCommands : public QObject
 
 private slots:
     void testAddDeleteCommands();
+    void testDeleteWhileRunning();
+    void testNetlistDelta();
 };
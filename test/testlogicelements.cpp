@@ -3,18 +3,35 @@
 
 #include "testlogicelements.h"
 
+#include "clockqueue.h"
+#include "faultsimulator.h"
 #include "logicand.h"
+#include "logicarena.h"
+#include "logicbusgate.h"
+#include "logicbusmux.h"
 #include "logicdemux.h"
 #include "logicdflipflop.h"
 #include "logicdlatch.h"
 #include "logicinput.h"
 #include "logicjkflipflop.h"
+#include "logicjoiner.h"
 #include "logicmux.h"
+#include "logicnand.h"
 #include "logicnode.h"
+#include "logicnor.h"
+#include "logicnot.h"
 #include "logicor.h"
+#include "logicoutput.h"
+#include "logicsplitter.h"
 #include "logicsrflipflop.h"
 #include "logictflipflop.h"
+#include "logicxnor.h"
+#include "logicxor.h"
+#include "netlist.h"
+#include "timingwheel.h"
+#include "vcdwriter.h"
 
+#include <QTemporaryDir>
 #include <QTest>
 
 void TestLogicElements::init()
@@ -396,3 +413,957 @@ void TestLogicElements::testLogicTFlipFlop()
         QCOMPARE(elm.outputValue(1), test.at(6));
     }
 }
+
+void TestLogicElements::testNetlist()
+{
+    auto input1 = std::make_shared<LogicInput>();
+    auto input2 = std::make_shared<LogicInput>();
+    auto sum = std::make_shared<LogicXor>(2);
+    auto carry = std::make_shared<LogicAnd>(2);
+
+    sum->connectPredecessor(0, input1.get(), 0);
+    sum->connectPredecessor(1, input2.get(), 0);
+    carry->connectPredecessor(0, input1.get(), 0);
+    carry->connectPredecessor(1, input2.get(), 0);
+
+    const QVector<std::shared_ptr<LogicElement>> logicElms{input1, input2, sum, carry};
+
+    for (int index = 0; index < logicElms.size(); ++index) {
+        logicElms.at(index)->setSortIndex(index);
+    }
+
+    Netlist netlist(logicElms);
+
+    const QVector<QVector<bool>> truthTable{
+        {0, 0, 0, 0},
+        {0, 1, 1, 0},
+        {1, 0, 1, 0},
+        {1, 1, 0, 1},
+    };
+
+    for (const auto &test : truthTable) {
+        input1->setOutputValue(test.at(0));
+        input2->setOutputValue(test.at(1));
+        netlist.loadOutputs(input1.get());
+        netlist.loadOutputs(input2.get());
+
+        netlist.update();
+
+        QCOMPARE(netlist.value(netlist.outputSlot(sum.get())), test.at(2));
+        QCOMPARE(netlist.value(netlist.outputSlot(carry.get())), test.at(3));
+        QCOMPARE(sum->outputValue(), test.at(2));
+        QCOMPARE(carry->outputValue(), test.at(3));
+    }
+
+    // The first update evaluates every element, the next ones only the gates behind a changed input.
+    QCOMPARE(netlist.updateCount(), quint64(4));
+    QCOMPARE(netlist.evaluationCount(), quint64(10));
+
+    QVERIFY(netlist.isCombinational());
+
+    auto lanes = netlist.lanes();
+    lanes[netlist.outputSlot(input1.get())] = 0b1100;
+    lanes[netlist.outputSlot(input2.get())] = 0b1010;
+
+    netlist.updateLanes(lanes);
+
+    QCOMPARE(lanes[netlist.outputSlot(sum.get())] & 0b1111, quint64(0b0110));
+    QCOMPARE(lanes[netlist.outputSlot(carry.get())] & 0b1111, quint64(0b1000));
+}
+
+void TestLogicElements::testNetlistOptimizations()
+{
+    // A constant outside of the netlist, like the global GND of a mapping.
+    LogicInput gnd(false);
+    auto input = std::make_shared<LogicInput>();
+    auto node = std::make_shared<LogicNode>();
+    auto not1 = std::make_shared<LogicNot>();
+    auto not2 = std::make_shared<LogicNot>();
+    auto masked = std::make_shared<LogicAnd>(2);
+    auto unused = std::make_shared<LogicXor>(2);
+    auto output = std::make_shared<LogicOutput>(2);
+
+    node->connectPredecessor(0, input.get(), 0);
+    not1->connectPredecessor(0, node.get(), 0);
+    not2->connectPredecessor(0, not1.get(), 0);
+    masked->connectPredecessor(0, not2.get(), 0);
+    masked->connectPredecessor(1, &gnd, 0);
+    unused->connectPredecessor(0, input.get(), 0);
+    unused->connectPredecessor(1, node.get(), 0);
+    output->connectPredecessor(0, not2.get(), 0);
+    output->connectPredecessor(1, masked.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{input, node, not1, not2, masked, unused, output};
+    Netlist::levelize(logicElms);
+
+    Netlist safe(logicElms, Netlist::SafeOptimizations);
+    QCOMPARE(safe.outputSlot(node.get()), safe.outputSlot(input.get()));
+    QCOMPARE(safe.inputSlot(not1.get(), 0), safe.outputSlot(input.get()));
+    QCOMPARE(safe.outputSlot(masked.get()), safe.inputSlot(masked.get(), 1));
+    QVERIFY(safe.outputSlot(not2.get()) != safe.outputSlot(input.get()));
+
+    // The inverters cancel out, after which only the input and the output are left to evaluate.
+    Netlist all(logicElms, Netlist::AllOptimizations);
+    QCOMPARE(all.inputSlot(output.get(), 0), all.outputSlot(input.get()));
+    QVERIFY(all.isCombinational());
+
+    for (const bool value : {true, false, true}) {
+        input->setOutputValue(value);
+        all.loadOutputs(input.get());
+        all.update();
+
+        QCOMPARE(output->outputValue(0), value);
+        QCOMPARE(output->outputValue(1), false);
+        QCOMPARE(node->outputValue(), value);
+        QCOMPARE(not2->outputValue(), value);
+        QCOMPARE(masked->outputValue(), false);
+    }
+
+    QCOMPARE(all.evaluationCount(), quint64(4));
+}
+
+void TestLogicElements::testParallelNetlist()
+{
+    // Columns of XOR gates, each one reading two neighbours of the previous row.
+    const int width = 256;
+    const int depth = 64;
+
+    QVector<std::shared_ptr<LogicElement>> logicElms;
+    QVector<std::shared_ptr<LogicInput>> inputs;
+
+    for (int column = 0; column < width; ++column) {
+        inputs.append(std::make_shared<LogicInput>());
+        logicElms.append(inputs.constLast());
+    }
+
+    for (int row = 0; row < depth; ++row) {
+        const int previous = logicElms.size() - width;
+
+        for (int column = 0; column < width; ++column) {
+            auto gate = std::make_shared<LogicXor>(2);
+            gate->connectPredecessor(0, logicElms.at(previous + column).get(), 0);
+            gate->connectPredecessor(1, logicElms.at(previous + (column + 1) % width).get(), 0);
+            logicElms.append(gate);
+        }
+    }
+
+    Netlist::levelize(logicElms);
+
+    Netlist serial(logicElms);
+    serial.setParallel(false);
+
+    Netlist parallel(logicElms);
+    parallel.setParallel(true);
+
+    for (int test = 0; test < 8; ++test) {
+        for (int column = 0; column < width; ++column) {
+            inputs.at(column)->setOutputValue(((column * 7 + test * 13) % 5) < 2);
+            serial.loadOutputs(inputs.at(column).get());
+            parallel.loadOutputs(inputs.at(column).get());
+        }
+
+        serial.update();
+        parallel.update();
+
+        for (const auto &logic : qAsConst(logicElms)) {
+            QCOMPARE(parallel.value(parallel.outputSlot(logic.get())), serial.value(serial.outputSlot(logic.get())));
+        }
+    }
+}
+
+void TestLogicElements::testFeedbackLoop()
+{
+    // SR latch made of two cross-coupled NOR gates, which must settle within a single update.
+    auto set = std::make_shared<LogicInput>();
+    auto reset = std::make_shared<LogicInput>();
+    auto q = std::make_shared<LogicNor>(2);
+    auto qBar = std::make_shared<LogicNor>(2);
+
+    q->connectPredecessor(0, reset.get(), 0);
+    q->connectPredecessor(1, qBar.get(), 0);
+    qBar->connectPredecessor(0, set.get(), 0);
+    qBar->connectPredecessor(1, q.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{set, reset, q, qBar};
+    Netlist::levelize(logicElms);
+
+    QVERIFY(q->component());
+    QCOMPARE(q->component(), qBar->component());
+    QCOMPARE(q->priority(), qBar->priority());
+    QVERIFY(!set->component());
+
+    Netlist netlist(logicElms);
+    QVERIFY(!netlist.isCombinational());
+
+    // Set, hold, reset, hold.
+    const QVector<QVector<bool>> truthTable{
+        {1, 0, 1},
+        {0, 0, 1},
+        {0, 1, 0},
+        {0, 0, 0},
+    };
+
+    for (const auto &test : truthTable) {
+        set->setOutputValue(test.at(0));
+        reset->setOutputValue(test.at(1));
+        netlist.loadOutputs(set.get());
+        netlist.loadOutputs(reset.get());
+
+        netlist.update();
+
+        QCOMPARE(netlist.value(netlist.outputSlot(q.get())), test.at(2));
+        QCOMPARE(netlist.value(netlist.outputSlot(qBar.get())), !test.at(2));
+        QVERIFY(netlist.isStable());
+    }
+
+    // A NAND gate fed back into itself oscillates while enabled, which no number of updates can settle.
+    auto enable = std::make_shared<LogicInput>();
+    auto ring = std::make_shared<LogicNand>(2);
+
+    ring->connectPredecessor(0, enable.get(), 0);
+    ring->connectPredecessor(1, ring.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> ringElms{enable, ring};
+    Netlist::levelize(ringElms);
+    Netlist ringNetlist(ringElms);
+
+    QCOMPARE(ringNetlist.evaluateUntilStable(8), 1);
+    QCOMPARE(ringNetlist.value(ringNetlist.outputSlot(ring.get())), true);
+
+    enable->setOutputValue(true);
+    ringNetlist.loadOutputs(enable.get());
+    QVERIFY(!ringNetlist.isStable());
+    QCOMPARE(ringNetlist.evaluateUntilStable(8), -1);
+
+    enable->setOutputValue(false);
+    ringNetlist.loadOutputs(enable.get());
+    QCOMPARE(ringNetlist.evaluateUntilStable(8), 1);
+    QCOMPARE(ringNetlist.value(ringNetlist.outputSlot(ring.get())), true);
+}
+
+void TestLogicElements::testLevelizeLongChain()
+{
+    // Deep enough to overflow the call stack with a recursive levelization.
+    const int length = 200'000;
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{std::make_shared<LogicInput>()};
+
+    for (int index = 1; index < length; ++index) {
+        auto node = std::make_shared<LogicNode>();
+        node->connectPredecessor(0, logicElms.constLast().get(), 0);
+        logicElms.append(node);
+    }
+
+    auto *first = logicElms.constFirst().get();
+    auto *last = logicElms.constLast().get();
+
+    Netlist::levelize(logicElms);
+
+    QCOMPARE(first->priority(), length);
+    QCOMPARE(last->priority(), 1);
+    QCOMPARE(logicElms.constFirst().get(), first);
+    QCOMPARE(logicElms.constLast().get(), last);
+}
+
+void TestLogicElements::testLogicArena()
+{
+    auto arena = LogicArena::create();
+    const std::weak_ptr<LogicArena> weakArena = arena;
+
+    // Enough elements to span several blocks of the arena. The first gate reads the input on both of its ports.
+    QVector<std::shared_ptr<LogicElement>> logicElms{arena->make<LogicInput>()};
+
+    for (int index = 1; index < 10'000; ++index) {
+        auto gate = arena->make<LogicAnd>(2);
+        gate->connectPredecessor(0, logicElms.constFirst().get(), 0);
+        gate->connectPredecessor(1, logicElms.constLast().get(), 0);
+        logicElms.append(gate);
+    }
+
+    QCOMPARE(logicElms.constFirst()->successors().size(), logicElms.size() - 1);
+    QCOMPARE(logicElms.at(1)->successors().size(), 1);
+
+    // Any element keeps the whole arena alive.
+    auto last = logicElms.constLast();
+    arena.reset();
+    logicElms.clear();
+
+    QVERIFY(!weakArena.expired());
+    QCOMPARE(last->inputPairs().size(), 2);
+
+    last.reset();
+    QVERIFY(weakArena.expired());
+}
+
+void TestLogicElements::testBusNetlist()
+{
+    // out = select ? reverse(a ^ b) : (a & b), with the reversal done by a splitter and a joiner.
+    const int width = 8;
+    auto a = std::make_shared<LogicInput>(false, width);
+    auto b = std::make_shared<LogicInput>(false, width);
+    auto select = std::make_shared<LogicInput>();
+    auto andGate = std::make_shared<LogicBusGate>(LogicType::BusAnd, 2, width);
+    auto xorGate = std::make_shared<LogicBusGate>(LogicType::BusXor, 2, width);
+    auto splitter = std::make_shared<LogicSplitter>(width);
+    auto joiner = std::make_shared<LogicJoiner>(width);
+    auto mux = std::make_shared<LogicBusMux>(width);
+
+    andGate->connectPredecessor(0, a.get(), 0);
+    andGate->connectPredecessor(1, b.get(), 0);
+    xorGate->connectPredecessor(0, a.get(), 0);
+    xorGate->connectPredecessor(1, b.get(), 0);
+    splitter->connectPredecessor(0, xorGate.get(), 0);
+
+    for (int bit = 0; bit < width; ++bit) {
+        joiner->connectPredecessor(bit, splitter.get(), width - 1 - bit);
+    }
+
+    mux->connectPredecessor(0, andGate.get(), 0);
+    mux->connectPredecessor(1, joiner.get(), 0);
+    mux->connectPredecessor(2, select.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{a, b, select, andGate, xorGate, splitter, joiner, mux};
+    Netlist::levelize(logicElms);
+    Netlist netlist(logicElms);
+
+    const QVector<QVector<quint64>> tests{
+        // a, b, select, out
+        {0b1100'1010, 0b1010'0110, 0, 0b1000'0010},
+        {0b1100'1010, 0b1010'0110, 1, 0b0011'0110},
+        {0b1111'1111, 0b0000'0001, 1, 0b0111'1111},
+        {0b0000'0000, 0b0000'0000, 1, 0b0000'0000},
+    };
+
+    for (const auto &test : tests) {
+        for (int bit = 0; bit < width; ++bit) {
+            a->setOutputValue(bit, (test.at(0) >> bit) & 1);
+            b->setOutputValue(bit, (test.at(1) >> bit) & 1);
+        }
+
+        select->setOutputValue(test.at(2));
+        netlist.loadOutputs(a.get());
+        netlist.loadOutputs(b.get());
+        netlist.loadOutputs(select.get());
+
+        netlist.update();
+
+        QCOMPARE(netlist.word(netlist.outputSlot(mux.get()), width), test.at(3));
+
+        for (int bit = 0; bit < width; ++bit) {
+            QCOMPARE(mux->outputValue(bit), static_cast<bool>((test.at(3) >> bit) & 1));
+        }
+    }
+
+    // With every bit of a set and b cleared, lane 0 selects the AND of the inputs and lane 1 their XOR.
+    auto lanes = netlist.lanes();
+
+    for (int bit = 0; bit < width; ++bit) {
+        lanes[netlist.outputSlot(a.get(), bit)] = ~quint64(0);
+        lanes[netlist.outputSlot(b.get(), bit)] = 0;
+    }
+
+    lanes[netlist.outputSlot(select.get())] = 0b10;
+
+    netlist.updateLanes(lanes);
+
+    for (int bit = 0; bit < width; ++bit) {
+        QCOMPARE(lanes[netlist.outputSlot(mux.get(), bit)] & 0b11, quint64(0b10));
+    }
+}
+
+void TestLogicElements::testRewind()
+{
+    // A 2-bit counter behind an SR latch, so the state is kept in flip-flops and in a feedback loop alike.
+    auto clock = std::make_shared<LogicInput>();
+    auto set = std::make_shared<LogicInput>();
+    auto high = std::make_shared<LogicInput>(true);
+    auto bit0 = std::make_shared<LogicTFlipFlop>();
+    auto bit1 = std::make_shared<LogicTFlipFlop>();
+    auto q = std::make_shared<LogicNor>(2);
+    auto qBar = std::make_shared<LogicNor>(2);
+
+    for (auto *bit : {bit0.get(), bit1.get()}) {
+        bit->connectPredecessor(0, high.get(), 0);
+        bit->connectPredecessor(2, high.get(), 0);
+        bit->connectPredecessor(3, high.get(), 0);
+    }
+
+    bit0->connectPredecessor(1, clock.get(), 0);
+    bit1->connectPredecessor(1, bit0.get(), 1);
+    q->connectPredecessor(0, bit1.get(), 0);
+    q->connectPredecessor(1, qBar.get(), 0);
+    qBar->connectPredecessor(0, set.get(), 0);
+    qBar->connectPredecessor(1, q.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{clock, set, high, bit0, bit1, q, qBar};
+    Netlist::levelize(logicElms);
+    Netlist netlist(logicElms);
+    netlist.update();
+    netlist.setHistory(1024 * 1024, 16);
+
+    QCOMPARE(netlist.firstCycle(), quint64(1));
+
+    QVector<std::vector<quint64>> values;
+    values.append(netlist.values());
+
+    for (int cycle = 2; cycle <= 300; ++cycle) {
+        clock->setOutputValue(cycle % 3 == 0);
+        netlist.loadOutputs(clock.get());
+
+        if (cycle % 37 == 0) {
+            set->setOutputValue(!set->outputValue());
+            netlist.loadOutputs(set.get());
+        }
+
+        netlist.update();
+        values.append(netlist.values());
+    }
+
+    QCOMPARE(netlist.cycle(), quint64(300));
+
+    for (const int cycle : {299, 160, 151, 150, 17, 1}) {
+        QVERIFY(netlist.rewind(cycle));
+        QCOMPARE(netlist.cycle(), static_cast<quint64>(cycle));
+        QVERIFY(netlist.values() == values.at(cycle - 1));
+        QCOMPARE(bit0->outputValue(0), netlist.value(netlist.outputSlot(bit0.get())));
+    }
+
+    // Going forward again replaces the cycles that were rewound.
+    QVERIFY(!netlist.rewind(2));
+    clock->setOutputValue(true);
+    netlist.loadOutputs(clock.get());
+    netlist.update();
+    netlist.update();
+    QVERIFY(netlist.rewind(2));
+    QCOMPARE(netlist.value(netlist.outputSlot(clock.get())), true);
+
+    // A tight memory limit only keeps the latest checkpoints.
+    netlist.setHistory(2048, 16);
+
+    for (int cycle = 0; cycle < 1000; ++cycle) {
+        clock->setOutputValue(!clock->outputValue());
+        netlist.loadOutputs(clock.get());
+        netlist.update();
+    }
+
+    QVERIFY(netlist.firstCycle() > 2);
+    QVERIFY(!netlist.rewind(2));
+    QVERIFY(netlist.rewind(netlist.firstCycle()));
+}
+
+void TestLogicElements::testTimedNetlist()
+{
+    // out = a & !a is always low when settled, but a rising edge of a goes through the AND gate before the
+    // inverter catches up, leaving a pulse as long as the delay of the inverter.
+    for (const int notDelay : {-1, 4}) {
+        auto a = std::make_shared<LogicInput>();
+        auto notGate = std::make_shared<LogicNot>();
+        auto andGate = std::make_shared<LogicAnd>(2);
+
+        notGate->setDelay(notDelay);
+        notGate->connectPredecessor(0, a.get(), 0);
+        andGate->connectPredecessor(0, a.get(), 0);
+        andGate->connectPredecessor(1, notGate.get(), 0);
+
+        QVector<std::shared_ptr<LogicElement>> logicElms{a, notGate, andGate};
+        Netlist::levelize(logicElms);
+        Netlist netlist(logicElms);
+        netlist.update();
+
+        QCOMPARE(netlist.value(netlist.outputSlot(andGate.get())), false);
+
+        netlist.setTimed(true);
+        a->setOutputValue(true);
+        netlist.loadOutputs(a.get());
+
+        const int andDelay = Netlist::defaultDelay(LogicType::And);
+        const int pulseEnd = andDelay + ((notDelay < 0) ? Netlist::defaultDelay(LogicType::Not) : notDelay);
+
+        for (int time = 1; time <= pulseEnd + 2; ++time) {
+            netlist.update();
+
+            QCOMPARE(netlist.time(), static_cast<quint64>(time));
+            QCOMPARE(netlist.value(netlist.outputSlot(andGate.get())), (time >= andDelay) && (time < pulseEnd));
+            QCOMPARE(andGate->outputValue(), (time >= andDelay) && (time < pulseEnd));
+        }
+
+        // A pulse shorter than the delay of the inverter still goes through it, delayed.
+        a->setOutputValue(false);
+        netlist.loadOutputs(a.get());
+        netlist.update();
+        a->setOutputValue(true);
+        netlist.loadOutputs(a.get());
+
+        int pulseLength = notGate->outputValue();
+
+        for (int time = 0; time < 10; ++time) {
+            netlist.update();
+            pulseLength += notGate->outputValue();
+        }
+
+        QCOMPARE(pulseLength, 1);
+        QCOMPARE(andGate->outputValue(), false);
+
+        // Leaving timed mode settles the netlist at once again.
+        a->setOutputValue(false);
+        netlist.loadOutputs(a.get());
+        netlist.setTimed(false);
+        netlist.update();
+
+        QCOMPARE(notGate->outputValue(), true);
+        QCOMPARE(andGate->outputValue(), false);
+    }
+
+    // D changes right after a clock edge, within the delay of the flip-flop, which must still latch the old D.
+    auto d = std::make_shared<LogicInput>(true);
+    auto clk = std::make_shared<LogicInput>();
+    auto high = std::make_shared<LogicInput>(true);
+    auto flipFlop = std::make_shared<LogicDFlipFlop>();
+
+    flipFlop->connectPredecessor(0, d.get(), 0);
+    flipFlop->connectPredecessor(1, clk.get(), 0);
+    flipFlop->connectPredecessor(2, high.get(), 0);
+    flipFlop->connectPredecessor(3, high.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{d, clk, high, flipFlop};
+    Netlist::levelize(logicElms);
+    Netlist netlist(logicElms);
+    netlist.update();
+
+    QCOMPARE(flipFlop->outputValue(0), false);
+
+    netlist.setTimed(true);
+    clk->setOutputValue(true);
+    netlist.loadOutputs(clk.get());
+    netlist.update();
+    d->setOutputValue(false);
+    netlist.loadOutputs(d.get());
+
+    const int delay = Netlist::defaultDelay(LogicType::DFlipFlop);
+
+    for (int time = 2; time <= delay + 3; ++time) {
+        netlist.update();
+
+        QCOMPARE(flipFlop->outputValue(0), time >= delay);
+        QCOMPARE(flipFlop->outputValue(1), time < delay);
+    }
+}
+
+void TestLogicElements::testClockQueue()
+{
+    // A 1 kHz clock drives a T flip-flop, next to a 1.5 kHz clock and a 1 MHz clock with no fan-out.
+    auto clock1 = std::make_shared<LogicInput>();
+    auto clock2 = std::make_shared<LogicInput>();
+    auto clock3 = std::make_shared<LogicInput>();
+    auto high = std::make_shared<LogicInput>(true);
+    auto tFlipFlop = std::make_shared<LogicTFlipFlop>();
+
+    tFlipFlop->connectPredecessor(0, high.get(), 0);
+    tFlipFlop->connectPredecessor(1, clock1.get(), 0);
+    tFlipFlop->connectPredecessor(2, high.get(), 0);
+    tFlipFlop->connectPredecessor(3, high.get(), 0);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{clock1, clock2, clock3, high, tFlipFlop};
+    Netlist::levelize(logicElms);
+    Netlist netlist(logicElms);
+    netlist.update();
+
+    ClockQueue clocks;
+    clocks.addClock(clock1.get(), 1000);
+    clocks.addClock(clock2.get(), 1500);
+    clocks.addClock(clock3.get(), 1'000'000);
+
+    const quint64 millisecond = ClockQueue::second / 1000;
+
+    for (quint64 time = 1; time <= 10; ++time) {
+        QVERIFY(clocks.advance(&netlist, time * millisecond));
+        QCOMPARE(clocks.time(), time * millisecond);
+
+        // The clock rises half a period after it starts, and then once per period.
+        QCOMPARE(tFlipFlop->outputValue(0), time % 2 == 1);
+        QCOMPARE(netlist.value(netlist.outputSlot(tFlipFlop.get())), time % 2 == 1);
+        QCOMPARE(clock1->outputValue(), false);
+        QCOMPARE(clock2->outputValue(), time % 2 == 1);
+        QCOMPARE(clock3->outputValue(), false);
+    }
+
+    // A deadline already passed stops the queue after a few instants.
+    QVERIFY(!clocks.advance(&netlist, 20 * millisecond, std::chrono::steady_clock::now()));
+    QVERIFY(clocks.time() > 10 * millisecond);
+    QVERIFY(clocks.time() < 11 * millisecond);
+
+    clocks.clear();
+    QVERIFY(clocks.isEmpty());
+    QCOMPARE(clocks.time(), quint64(0));
+}
+
+void TestLogicElements::testTimingWheel()
+{
+    struct Event {
+        quint64 time;
+        int id;
+    };
+
+    // Times spread over every level of the wheel and its overflow, scheduled out of order.
+    const QVector<quint64> times{5, 3, 64, 63, 4095, 4096, 1, 3, 200000, quint64(1) << 40, 70, 262143};
+
+    TimingWheel<Event> wheel;
+
+    for (int id = 0; id < times.size(); ++id) {
+        wheel.schedule({times.at(id), id});
+    }
+
+    QVector<quint64> expected = times;
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<Event> due;
+    QVector<quint64> taken;
+
+    QVERIFY(!wheel.takeNext(0, due));
+
+    // An event scheduled while the wheel runs goes after the ones already due.
+    while (wheel.takeNext(~quint64(0), due)) {
+        for (const auto &event : due) {
+            QCOMPARE(event.time, wheel.time());
+            taken.append(event.time);
+        }
+
+        if (wheel.time() == 64) {
+            wheel.schedule({65, -1});
+            expected.insert(std::upper_bound(expected.begin(), expected.end(), 65), 65);
+        }
+
+        due.clear();
+    }
+
+    QCOMPARE(taken, expected);
+    QVERIFY(wheel.isEmpty());
+}
+
+void TestLogicElements::testNativeNetlist()
+{
+    // Two copies of a circuit with every kind of compiled element, one simulated by the interpreter and the
+    // other by native code, must go through the same values.
+    struct Circuit {
+        QVector<std::shared_ptr<LogicInput>> inputs;
+        //! In the order they were built, as levelization may sort both copies differently.
+        QVector<std::shared_ptr<LogicElement>> logicElms;
+        std::unique_ptr<Netlist> netlist;
+    };
+
+    const auto build = [] {
+        Circuit circuit;
+        auto vcc = std::make_shared<LogicInput>(true);
+        auto bus = std::make_shared<LogicInput>(false, 4);
+
+        for (int index = 0; index < 4; ++index) {
+            circuit.inputs << std::make_shared<LogicInput>();
+        }
+
+        auto *a = circuit.inputs.at(0).get();
+        auto *b = circuit.inputs.at(1).get();
+        auto *c = circuit.inputs.at(2).get();
+        auto *clk = circuit.inputs.at(3).get();
+        circuit.inputs << bus;
+
+        auto nand = std::make_shared<LogicNand>(2);
+        auto orGate = std::make_shared<LogicOr>(3);
+        auto xnor = std::make_shared<LogicXnor>(2);
+        auto xorGate = std::make_shared<LogicXor>(2);
+        auto mux = std::make_shared<LogicMux>();
+        auto demux = std::make_shared<LogicDemux>();
+        auto dLatch = std::make_shared<LogicDLatch>();
+        auto dFlipFlop = std::make_shared<LogicDFlipFlop>();
+        auto jkFlipFlop = std::make_shared<LogicJKFlipFlop>();
+        auto srFlipFlop = std::make_shared<LogicSRFlipFlop>();
+        auto tFlipFlop = std::make_shared<LogicTFlipFlop>();
+        auto nor1 = std::make_shared<LogicNor>(2);
+        auto nor2 = std::make_shared<LogicNor>(2);
+        auto busNot = std::make_shared<LogicBusGate>(LogicType::BusNot, 1, 4);
+        auto busMux = std::make_shared<LogicBusMux>(4);
+        auto splitter = std::make_shared<LogicSplitter>(4);
+        auto joiner = std::make_shared<LogicJoiner>(4);
+        auto output = std::make_shared<LogicOutput>(4);
+
+        nand->connectPredecessor(0, a, 0);
+        nand->connectPredecessor(1, b, 0);
+        orGate->connectPredecessor(0, a, 0);
+        orGate->connectPredecessor(1, b, 0);
+        orGate->connectPredecessor(2, c, 0);
+        xnor->connectPredecessor(0, a, 0);
+        xnor->connectPredecessor(1, c, 0);
+        xorGate->connectPredecessor(0, nand.get(), 0);
+        xorGate->connectPredecessor(1, orGate.get(), 0);
+        mux->connectPredecessor(0, a, 0);
+        mux->connectPredecessor(1, b, 0);
+        mux->connectPredecessor(2, c, 0);
+        demux->connectPredecessor(0, xnor.get(), 0);
+        demux->connectPredecessor(1, b, 0);
+        dLatch->connectPredecessor(0, b, 0);
+        dLatch->connectPredecessor(1, c, 0);
+
+        dFlipFlop->connectPredecessor(0, xorGate.get(), 0);
+        dFlipFlop->connectPredecessor(1, clk, 0);
+        dFlipFlop->connectPredecessor(2, vcc.get(), 0);
+        dFlipFlop->connectPredecessor(3, c, 0);
+        jkFlipFlop->connectPredecessor(0, a, 0);
+        jkFlipFlop->connectPredecessor(1, clk, 0);
+        jkFlipFlop->connectPredecessor(2, b, 0);
+        jkFlipFlop->connectPredecessor(3, vcc.get(), 0);
+        jkFlipFlop->connectPredecessor(4, vcc.get(), 0);
+        srFlipFlop->connectPredecessor(0, a, 0);
+        srFlipFlop->connectPredecessor(1, clk, 0);
+        srFlipFlop->connectPredecessor(2, c, 0);
+        srFlipFlop->connectPredecessor(3, vcc.get(), 0);
+        srFlipFlop->connectPredecessor(4, vcc.get(), 0);
+        tFlipFlop->connectPredecessor(0, vcc.get(), 0);
+        tFlipFlop->connectPredecessor(1, dFlipFlop.get(), 0);
+        tFlipFlop->connectPredecessor(2, vcc.get(), 0);
+        tFlipFlop->connectPredecessor(3, vcc.get(), 0);
+
+        nor1->connectPredecessor(0, a, 0);
+        nor1->connectPredecessor(1, nor2.get(), 0);
+        nor2->connectPredecessor(0, b, 0);
+        nor2->connectPredecessor(1, nor1.get(), 0);
+
+        busNot->connectPredecessor(0, bus.get(), 0);
+        busMux->connectPredecessor(0, bus.get(), 0);
+        busMux->connectPredecessor(1, busNot.get(), 0);
+        busMux->connectPredecessor(2, tFlipFlop.get(), 0);
+        splitter->connectPredecessor(0, busMux.get(), 0);
+
+        for (int bit = 0; bit < 4; ++bit) {
+            joiner->connectPredecessor(bit, splitter.get(), 3 - bit);
+        }
+
+        output->connectPredecessor(0, jkFlipFlop.get(), 0);
+        output->connectPredecessor(1, srFlipFlop.get(), 1);
+        output->connectPredecessor(2, nor1.get(), 0);
+        output->connectPredecessor(3, mux.get(), 0);
+
+        circuit.logicElms = {vcc, bus, nand, orGate, xnor, xorGate, mux, demux, dLatch, dFlipFlop, jkFlipFlop, srFlipFlop,
+                             tFlipFlop, nor1, nor2, busNot, busMux, splitter, joiner, output};
+
+        for (int index = 0; index < 4; ++index) {
+            circuit.logicElms << circuit.inputs.at(index);
+        }
+
+        auto sorted = circuit.logicElms;
+        Netlist::levelize(sorted);
+        circuit.netlist = std::make_unique<Netlist>(sorted);
+        return circuit;
+    };
+
+    auto interpreted = build();
+    auto native = build();
+    native.netlist->setNative(true);
+
+    if (!native.netlist->isNative()) {
+        QSKIP("No working C++ compiler found.");
+    }
+
+    for (quint32 step = 0; step < 256; ++step) {
+        // A pseudo-random pattern, with a clock that ticks every other step.
+        const quint32 pattern = (step * 2654435761U) >> 16;
+
+        for (auto *circuit : {&interpreted, &native}) {
+            for (int index = 0; index < 3; ++index) {
+                circuit->inputs.at(index)->setOutputValue((pattern >> index) & 1);
+            }
+
+            circuit->inputs.at(3)->setOutputValue(step & 1);
+
+            for (int bit = 0; bit < 4; ++bit) {
+                circuit->inputs.at(4)->setOutputValue(bit, (pattern >> (3 + bit)) & 1);
+            }
+
+            for (const auto &input : qAsConst(circuit->inputs)) {
+                circuit->netlist->loadOutputs(input.get());
+            }
+
+            circuit->netlist->update();
+        }
+
+        for (int index = 0; index < interpreted.logicElms.size(); ++index) {
+            auto *logic1 = interpreted.logicElms.at(index).get();
+            auto *logic2 = native.logicElms.at(index).get();
+
+            for (int port = 0; port < static_cast<int>(logic1->getOutputAmount()); ++port) {
+                QCOMPARE(logic1->outputValue(port), logic2->outputValue(port));
+                QCOMPARE(native.netlist->value(native.netlist->outputSlot(logic2, port)), logic2->outputValue(port));
+            }
+        }
+    }
+}
+
+void TestLogicElements::testVcdWriter()
+{
+    // A 2-bit counter traced along with its clock, next to a constant left out of the netlist.
+    auto clock = std::make_shared<LogicInput>();
+    auto high = std::make_shared<LogicInput>(true);
+    auto bit0 = std::make_shared<LogicTFlipFlop>();
+    auto bit1 = std::make_shared<LogicTFlipFlop>();
+
+    for (auto *bit : {bit0.get(), bit1.get()}) {
+        bit->connectPredecessor(0, high.get(), 0);
+        bit->connectPredecessor(2, high.get(), 0);
+        bit->connectPredecessor(3, high.get(), 0);
+    }
+
+    bit0->connectPredecessor(1, clock.get(), 0);
+    bit1->connectPredecessor(1, bit0.get(), 1);
+
+    QVector<std::shared_ptr<LogicElement>> logicElms{clock, high, bit0, bit1};
+    Netlist::levelize(logicElms);
+    Netlist netlist(logicElms);
+    netlist.update();
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath("trace.vcd");
+
+    {
+        auto trace = std::make_shared<VcdWriter>(fileName, QVector<VcdWriter::Signal>{{"clock", 1}, {"bit 0", 1}, {"bit1", 1}, {"missing", 4}});
+        trace->setSlots({netlist.outputSlot(clock.get()), netlist.outputSlot(bit0.get()), netlist.outputSlot(bit1.get()), -1});
+        netlist.setTrace(trace);
+
+        for (int cycle = 0; cycle < 8; ++cycle) {
+            clock->setOutputValue(!clock->outputValue());
+            netlist.loadOutputs(clock.get());
+            netlist.update();
+            netlist.update();
+        }
+
+        netlist.setTrace(nullptr);
+    }
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+
+    QVERIFY(contents.contains("$var wire 1 \" bit_0 $end\n"));
+    QVERIFY(contents.contains("$var wire 4 $ missing [3:0] $end\n"));
+    QVERIFY(contents.contains("$enddefinitions $end\n#2\n1!\n1\"\n1#\n#4\n0!\n#6\n"));
+
+    // The second update of each clock phase changes nothing, so it is not written, and neither is the signal left out.
+    QCOMPARE(contents.count("\n#"), 8);
+    QVERIFY(!contents.contains("#3\n"));
+    QCOMPARE(contents.count("\n1!"), 4);
+    QCOMPARE(contents.count("\n1\""), 2);
+    QCOMPARE(contents.count("\n1#"), 2);
+    QVERIFY(!contents.contains(" $\n"));
+}
+
+void TestLogicElements::testFaultSimulator()
+{
+    // A half adder, its sum and carry on LEDs.
+    auto a = std::make_shared<LogicInput>();
+    auto b = std::make_shared<LogicInput>();
+    auto sum = std::make_shared<LogicXor>(2);
+    auto carry = std::make_shared<LogicAnd>(2);
+    auto sumLed = std::make_shared<LogicOutput>(1);
+    auto carryLed = std::make_shared<LogicOutput>(1);
+
+    sum->connectPredecessor(0, a.get(), 0);
+    sum->connectPredecessor(1, b.get(), 0);
+    carry->connectPredecessor(0, a.get(), 0);
+    carry->connectPredecessor(1, b.get(), 0);
+    sumLed->connectPredecessor(0, sum.get(), 0);
+    carryLed->connectPredecessor(0, carry.get(), 0);
+
+    const QVector<std::shared_ptr<LogicElement>> logicElms{a, b, sum, carry, sumLed, carryLed};
+
+    for (int index = 0; index < logicElms.size(); ++index) {
+        logicElms.at(index)->setSortIndex(index);
+    }
+
+    Netlist netlist(logicElms);
+    FaultSimulator simulator(netlist);
+
+    QCOMPARE(simulator.inputSlots(), (QVector<int>{netlist.outputSlot(a.get()), netlist.outputSlot(b.get())}));
+    QCOMPARE(simulator.observedSlots(), (QVector<int>{netlist.outputSlot(sumLed.get()), netlist.outputSlot(carryLed.get())}));
+    QCOMPARE(simulator.faults().size(), 12);
+
+    // With both inputs set, only the faults that pull an output away from 0 1 show.
+    const auto partial = simulator.run({{1, 1}});
+    QCOMPARE(partial.detectedCount(), 6);
+    QCOMPARE(partial.coverage(), 50.0);
+
+    for (const auto &fault : partial.undetected()) {
+        QCOMPARE(fault.stuckAt, (fault.logic != sum.get()) && (fault.logic != sumLed.get()));
+    }
+
+    const auto report = simulator.run({{0, 0}, {0, 1}, {1, 0}, {1, 1}});
+    QCOMPARE(report.detectedCount(), 12);
+    QVERIFY(report.undetected().isEmpty());
+
+    for (int index = 0; index < report.faults.size(); ++index) {
+        const auto &fault = report.faults.at(index);
+
+        if ((fault.logic == a.get()) && fault.stuckAt) {
+            QCOMPARE(report.detectedBy.at(index), 0);
+        }
+
+        if ((fault.logic == sum.get()) && !fault.stuckAt) {
+            QCOMPARE(report.detectedBy.at(index), 1);
+        }
+    }
+
+    // A D flip-flop carries its state from one vector to the next: D stuck at 0 shows on the first clock edge,
+    // stuck at 1 on the second.
+    auto data = std::make_shared<LogicInput>();
+    auto clock = std::make_shared<LogicInput>();
+    auto vcc = std::make_shared<LogicInput>(true);
+    auto flipFlop = std::make_shared<LogicDFlipFlop>();
+    auto led = std::make_shared<LogicOutput>(1);
+
+    flipFlop->connectPredecessor(0, data.get(), 0);
+    flipFlop->connectPredecessor(1, clock.get(), 0);
+    flipFlop->connectPredecessor(2, vcc.get(), 0);
+    flipFlop->connectPredecessor(3, vcc.get(), 0);
+    led->connectPredecessor(0, flipFlop.get(), 0);
+
+    const QVector<std::shared_ptr<LogicElement>> sequentialElms{data, clock, vcc, flipFlop, led};
+
+    for (int index = 0; index < sequentialElms.size(); ++index) {
+        sequentialElms.at(index)->setSortIndex(index);
+    }
+
+    Netlist sequential(sequentialElms);
+    FaultSimulator sequentialSimulator(sequential);
+    sequentialSimulator.setInputSlots({sequential.outputSlot(data.get()), sequential.outputSlot(clock.get())});
+
+    const auto sequentialReport = sequentialSimulator.run({{1, 0}, {1, 1}, {0, 0}, {0, 1}});
+
+    for (int index = 0; index < sequentialReport.faults.size(); ++index) {
+        const auto &fault = sequentialReport.faults.at(index);
+
+        if (fault.logic == data.get()) {
+            QCOMPARE(sequentialReport.detectedBy.at(index), fault.stuckAt ? 3 : 1);
+        }
+    }
+
+    // A chain of inverters has more faults than a batch holds; both values reach every output on the way.
+    auto input = std::make_shared<LogicInput>();
+    QVector<std::shared_ptr<LogicElement>> chainElms{input};
+
+    for (int index = 0; index < 40; ++index) {
+        auto inverter = std::make_shared<LogicNot>();
+        inverter->connectPredecessor(0, chainElms.last().get(), 0);
+        chainElms.append(inverter);
+    }
+
+    auto output = std::make_shared<LogicOutput>(1);
+    output->connectPredecessor(0, chainElms.last().get(), 0);
+    chainElms.append(output);
+
+    for (int index = 0; index < chainElms.size(); ++index) {
+        chainElms.at(index)->setSortIndex(index);
+    }
+
+    Netlist chain(chainElms);
+    const auto chainReport = FaultSimulator(chain).run({{0}, {1}});
+
+    QCOMPARE(chainReport.faults.size(), 84);
+    QCOMPARE(chainReport.detectedCount(), 84);
+}
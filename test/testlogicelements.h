@@ -15,6 +15,10 @@ class TestLogicElements : public QObject
 private slots:
     void cleanup();
     void init();
+    void testBusNetlist();
+    void testClockQueue();
+    void testFaultSimulator();
+    void testFeedbackLoop();
     void testLogicAnd();
     void testLogicDFlipFlop();
     void testLogicDLatch();
@@ -26,6 +30,16 @@ private slots:
     void testLogicOr();
     void testLogicSRFlipFlop();
     void testLogicTFlipFlop();
+    void testLevelizeLongChain();
+    void testLogicArena();
+    void testNativeNetlist();
+    void testNetlist();
+    void testNetlistOptimizations();
+    void testParallelNetlist();
+    void testRewind();
+    void testTimedNetlist();
+    void testTimingWheel();
+    void testVcdWriter();
 
 private:
     QVector<LogicInput *> switches{5};
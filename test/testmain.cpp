@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "common.h"
+#include "testbenchmarks.h"
 #include "testcommands.h"
 #include "testelements.h"
 #include "testfiles.h"
@@ -22,6 +23,7 @@ int main(int argc, char **argv)
     app.setApplicationVersion(APP_VERSION);
 
     int status = 0;
+    status |= QTest::qExec(new TestBenchmarks(), argc, argv);
     status |= QTest::qExec(new TestCommands(), argc, argv);
     status |= QTest::qExec(new TestElements(), argc, argv);
     status |= QTest::qExec(new TestFiles(), argc, argv);
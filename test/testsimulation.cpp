@@ -4,15 +4,82 @@
 #include "testsimulation.h"
 
 #include "and.h"
+#include "batchgrader.h"
 #include "common.h"
+#include "equivalencechecker.h"
+#include "faultcoverage.h"
+#include "graphicelementinput.h"
+#include "headlesscircuit.h"
 #include "inputbutton.h"
+#include "inputgnd.h"
+#include "inputswitch.h"
 #include "led.h"
+#include "not.h"
+#include "satsolver.h"
 #include "qneconnection.h"
+#include "qneport.h"
 #include "scene.h"
+#include "truthtable.h"
 #include "workspace.h"
 
+#include <QBuffer>
+#include <QDir>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
 #include <QTest>
 
+namespace
+{
+    //! Reads the rows of the inputs and of the outputs of a waveform saved as text.
+    bool readWaveform(const QString &fileName, QStringList &inputRows, QStringList &outputRows)
+    {
+        QFile file(fileName);
+
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        QStringList *rows = &inputRows;
+
+        while (!file.atEnd()) {
+            const QString line = QString(file.readLine()).trimmed();
+
+            if (line.isEmpty()) {
+                rows = &outputRows;
+                continue;
+            }
+
+            rows->append(line);
+        }
+
+        return true;
+    }
+
+    //! Writes @p rows of bits as a CSV in the format beWavedDolphin reads and -w prints.
+    bool writeWaveform(const QString &fileName, const QStringList &rows)
+    {
+        QFile file(fileName);
+
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+
+        QByteArray content = QByteArray::number(rows.size()) + "," + QByteArray::number(rows.constFirst().size()) + ",\n";
+
+        for (const auto &row : rows) {
+            for (const QChar bit : row) {
+                content += bit.toLatin1();
+                content += ',';
+            }
+
+            content += '\n';
+        }
+
+        return file.write(content) == content.size();
+    }
+}
+
 void TestSimulation::testCase1()
 {
     WorkSpace workspace;
@@ -48,3 +115,484 @@ void TestSimulation::testCase1()
     QVERIFY(elements.at(2) == &andItem);
     QVERIFY(elements.at(3) == &led);
 }
+
+void TestSimulation::testSelectiveUpdate()
+{
+    WorkSpace workspace;
+
+    InputButton button;
+    Not notItem;
+    Led led;
+    QNEConnection connection1;
+    QNEConnection connection2;
+
+    auto *scene = workspace.scene();
+    scene->addItem(&led);
+    scene->addItem(&notItem);
+    scene->addItem(&button);
+    scene->addItem(&connection1);
+    scene->addItem(&connection2);
+
+    connection1.setStartPort(button.outputPort());
+    connection1.setEndPort(notItem.inputPort());
+    connection2.setStartPort(notItem.outputPort());
+    connection2.setEndPort(led.inputPort());
+
+    auto *simulation = scene->simulation();
+    QVERIFY(simulation->initialize());
+
+    simulation->update();
+    QCOMPARE(led.inputPort()->status(), Status::Active);
+
+    simulation->update();
+    QCOMPARE(led.inputPort()->status(), Status::Active);
+
+    button.setOn();
+    simulation->update();
+    QCOMPARE(led.inputPort()->status(), Status::Inactive);
+
+    button.setOff();
+    simulation->update();
+    QCOMPARE(led.inputPort()->status(), Status::Active);
+}
+
+void TestSimulation::testSimulationThread()
+{
+    WorkSpace workspace;
+
+    InputButton button;
+    Not notItem;
+    Led led;
+    QNEConnection connection1;
+    QNEConnection connection2;
+
+    auto *scene = workspace.scene();
+    scene->addItem(&led);
+    scene->addItem(&notItem);
+    scene->addItem(&button);
+    scene->addItem(&connection1);
+    scene->addItem(&connection2);
+
+    connection1.setStartPort(button.outputPort());
+    connection1.setEndPort(notItem.inputPort());
+    connection2.setStartPort(notItem.outputPort());
+    connection2.setEndPort(led.inputPort());
+
+    auto *simulation = scene->simulation();
+    simulation->start();
+    QTRY_COMPARE(led.inputPort()->status(), Status::Active);
+
+    button.setOn();
+    QTRY_COMPARE(led.inputPort()->status(), Status::Inactive);
+
+    button.setOff();
+    QTRY_COMPARE(led.inputPort()->status(), Status::Active);
+
+    simulation->stop();
+    QCOMPARE(led.inputPort()->status(), Status::Active);
+
+    const auto counters = simulation->counters().sample();
+    QCOMPARE(counters.initializations, quint64(1));
+    QVERIFY(counters.ticks > 0);
+    QVERIFY(counters.evaluations > 0);
+    QVERIFY(counters.portUpdates > 0);
+    QVERIFY(counters.toJson().contains("ticksPerSecond"));
+}
+
+void TestSimulation::testEquivalenceChecker()
+{
+    // Seven pigeons do not fit in six holes.
+    SatSolver solver;
+    const int pigeons = 7;
+    const int holes = 6;
+
+    for (int variable = 0; variable < pigeons * holes; ++variable) {
+        solver.createVariable();
+    }
+
+    for (int pigeon = 0; pigeon < pigeons; ++pigeon) {
+        std::vector<int> clause;
+
+        for (int hole = 0; hole < holes; ++hole) {
+            clause.push_back(2 * (pigeon * holes + hole));
+        }
+
+        solver.addClause(clause);
+    }
+
+    for (int hole = 0; hole < holes; ++hole) {
+        for (int pigeon = 0; pigeon < pigeons; ++pigeon) {
+            for (int other = pigeon + 1; other < pigeons; ++other) {
+                solver.addClause({2 * (pigeon * holes + hole) + 1, 2 * (other * holes + hole) + 1});
+            }
+        }
+    }
+
+    QCOMPARE(solver.solve(), SatSolver::Result::Unsatisfiable);
+
+    const QDir examplesDir(QString(CURRENTDIR) + "/../examples/");
+    const HeadlessCircuit circuit(examplesDir.absoluteFilePath("display-4bits.panda"));
+    const HeadlessCircuit copy(examplesDir.absoluteFilePath("display-4bits.panda"));
+    const HeadlessCircuit sequential(examplesDir.absoluteFilePath("counter.panda"));
+
+    QVERIFY_EXCEPTION_THROWN(EquivalenceChecker checker(circuit, sequential), Pandaception);
+
+    const EquivalenceChecker checker(circuit, copy);
+    QCOMPARE(checker.inputLabels(), circuit.inputLabels());
+    QVERIFY(checker.run().equivalent);
+}
+
+void TestSimulation::testHeadlessCircuit()
+{
+    const QDir examplesDir(QString(CURRENTDIR) + "/../examples/");
+
+    for (const auto &fileInfo : examplesDir.entryInfoList(QStringList("*.panda"))) {
+        HeadlessCircuit circuit(fileInfo.absoluteFilePath());
+        QVERIFY(circuit.netlist() != nullptr);
+    }
+
+    HeadlessCircuit circuit(examplesDir.absoluteFilePath("display-4bits.panda"));
+
+    QStringList inputRows;
+    QStringList outputRows;
+    QVERIFY(readWaveform(examplesDir.absoluteFilePath("display-4bits.txt"), inputRows, outputRows));
+
+    QCOMPARE(circuit.inputCount(), inputRows.size());
+    QCOMPARE(circuit.outputCount(), outputRows.size());
+
+    for (int row = 0; row < outputRows.size(); ++row) {
+        QVERIFY(outputRows.at(row).endsWith("\"" + circuit.outputLabels().at(row) + "\""));
+    }
+
+    for (int column = 0; column < inputRows.constFirst().indexOf(' '); ++column) {
+        for (int input = 0; input < circuit.inputCount(); ++input) {
+            circuit.setInput(input, inputRows.at(input).at(column) == '1');
+        }
+
+        circuit.update();
+
+        for (int output = 0; output < circuit.outputCount(); ++output) {
+            const Status expected = (outputRows.at(output).at(column) == '1') ? Status::Active : Status::Inactive;
+            QCOMPARE(circuit.output(output), expected);
+        }
+    }
+}
+
+void TestSimulation::testHeadlessExamples_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    const QDir examplesDir(QString(CURRENTDIR) + "/../examples/");
+
+    for (const auto &fileInfo : examplesDir.entryInfoList(QStringList("*.panda"))) {
+        QTest::newRow(qPrintable(fileInfo.fileName())) << fileInfo.absoluteFilePath();
+    }
+}
+
+void TestSimulation::testHeadlessExamples()
+{
+    QFETCH(QString, fileName);
+
+    WorkSpace workspace;
+    workspace.load(fileName);
+    HeadlessCircuit circuit(fileName);
+
+    // Elements with the same label come in no particular order, so the ports are matched by element position.
+    const auto key = [](const QPointF &pos, const int port) {
+        return QString::number(pos.x()) + "," + QString::number(pos.y()) + "," + QString::number(port);
+    };
+
+    QHash<QString, QPair<GraphicElementInput *, int>> sceneInputs;
+    QHash<QString, QNEInputPort *> sceneOutputs;
+
+    for (auto *elm : workspace.scene()->elements()) {
+        if (elm->elementGroup() == ElementGroup::Input) {
+            for (int port = 0; port < elm->outputSize(); ++port) {
+                sceneInputs.insert(key(elm->pos(), port), {qobject_cast<GraphicElementInput *>(elm), port});
+            }
+        }
+
+        if (elm->elementGroup() == ElementGroup::Output) {
+            for (int port = 0; port < elm->inputSize(); ++port) {
+                sceneOutputs.insert(key(elm->pos(), port), elm->inputPort(port));
+            }
+        }
+    }
+
+    QCOMPARE(circuit.inputCount(), sceneInputs.size());
+    QCOMPARE(circuit.outputCount(), sceneOutputs.size());
+
+    QStringList inputKeys;
+    QStringList outputKeys;
+
+    for (int index = 0, port = 0; index < circuit.inputCount(); ++index) {
+        port = ((index > 0) && (circuit.inputPosition(index) == circuit.inputPosition(index - 1))) ? port + 1 : 0;
+        inputKeys.append(key(circuit.inputPosition(index), port));
+        QVERIFY(sceneInputs.contains(inputKeys.constLast()));
+    }
+
+    for (int index = 0, port = 0; index < circuit.outputCount(); ++index) {
+        port = ((index > 0) && (circuit.outputPosition(index) == circuit.outputPosition(index - 1))) ? port + 1 : 0;
+        outputKeys.append(key(circuit.outputPosition(index), port));
+        QVERIFY(sceneOutputs.contains(outputKeys.constLast()));
+    }
+
+    auto *simulation = workspace.simulation();
+    QRandomGenerator generator(1);
+
+    // The first step compares the circuits as loaded, the others toggle random inputs.
+    for (int step = 0; step < 64; ++step) {
+        for (const auto &inputKey : qAsConst(inputKeys)) {
+            const auto input = sceneInputs.value(inputKey);
+
+            if ((step > 0) && (generator.bounded(2) == 1)) {
+                input.first->setOn(!input.first->isOn(input.second), input.second);
+            }
+        }
+
+        // Read back after every change, as a rotary switch also turns its other ports off.
+        for (int index = 0; index < inputKeys.size(); ++index) {
+            const auto input = sceneInputs.value(inputKeys.at(index));
+            circuit.setInput(index, input.first->isOn(input.second));
+        }
+
+        simulation->update();
+        circuit.update();
+
+        for (int index = 0; index < outputKeys.size(); ++index) {
+            QCOMPARE(circuit.output(index), sceneOutputs.value(outputKeys.at(index))->status());
+        }
+    }
+}
+
+void TestSimulation::testBatchGrader()
+{
+    const QDir examplesDir(QString(CURRENTDIR) + "/../examples/");
+    const QTemporaryDir temporaryDir;
+    QVERIFY(temporaryDir.isValid());
+    const QDir dir(temporaryDir.path());
+
+    // Combinational: the stored display-4bits waveform, and a copy with a wrong output bit.
+    QStringList inputRows;
+    QStringList outputRows;
+    QVERIFY(readWaveform(examplesDir.absoluteFilePath("display-4bits.txt"), inputRows, outputRows));
+
+    for (auto *rows : {&inputRows, &outputRows}) {
+        for (auto &row : *rows) {
+            row = row.left(row.indexOf(' '));
+        }
+    }
+
+    QVERIFY(writeWaveform(dir.filePath("display.csv"), inputRows));
+    QVERIFY(writeWaveform(dir.filePath("display-golden.csv"), inputRows + outputRows));
+
+    QStringList wrongRows = outputRows;
+    wrongRows[2][5] = (wrongRows.at(2).at(5) == '1') ? '0' : '1';
+    QVERIFY(writeWaveform(dir.filePath("display-wrong.csv"), inputRows + wrongRows));
+
+    // Sequential: two identical jobs, the second one graded after the first on the same circuit, against a trace of
+    // a circuit loaded just for it.
+    const QString flipFlopFile = examplesDir.absoluteFilePath("dflipflop.panda");
+    HeadlessCircuit reference(flipFlopFile);
+    const int columns = 32;
+    QStringList sequentialRows;
+
+    for (int row = 0; row < reference.inputCount() + reference.outputCount(); ++row) {
+        sequentialRows.append(QString(columns, '0'));
+    }
+
+    for (int column = 0; column < columns; ++column) {
+        for (int input = 0; input < reference.inputCount(); ++input) {
+            const bool value = ((column * 7 + input * 3) % 5) < 2;
+            sequentialRows[input][column] = value ? '1' : '0';
+            reference.setInput(input, value);
+        }
+
+        QVERIFY(reference.netlist()->evaluateUntilStable(64) >= 0);
+
+        for (int output = 0; output < reference.outputCount(); ++output) {
+            sequentialRows[reference.inputCount() + output][column] = (reference.output(output) == Status::Active) ? '1' : '0';
+        }
+    }
+
+    QVERIFY(writeWaveform(dir.filePath("flipflop.csv"), sequentialRows.mid(0, reference.inputCount())));
+    QVERIFY(writeWaveform(dir.filePath("flipflop-golden.csv"), sequentialRows));
+
+    const BatchGrader grader({
+        {examplesDir.absoluteFilePath("display-4bits.panda"), dir.filePath("display.csv"), dir.filePath("display-golden.csv")},
+        {flipFlopFile, dir.filePath("flipflop.csv"), dir.filePath("flipflop-golden.csv")},
+        {examplesDir.absoluteFilePath("display-4bits.panda"), dir.filePath("display.csv"), dir.filePath("display-wrong.csv")},
+        {flipFlopFile, dir.filePath("flipflop.csv"), dir.filePath("flipflop-golden.csv")},
+        {examplesDir.absoluteFilePath("display-4bits.panda"), dir.filePath("missing.csv"), dir.filePath("display-golden.csv")},
+    });
+
+    const auto results = grader.run();
+    QCOMPARE(results.size(), 5);
+
+    QCOMPARE(results.at(0).status, BatchGrader::Result::Status::Passed);
+    QCOMPARE(results.at(0).columns, 16);
+
+    QCOMPARE(results.at(1).status, BatchGrader::Result::Status::Passed);
+    QCOMPARE(results.at(3).status, BatchGrader::Result::Status::Passed);
+
+    QCOMPARE(results.at(2).status, BatchGrader::Result::Status::Failed);
+    QCOMPARE(results.at(2).mismatches, 1);
+    QCOMPARE(results.at(2).firstColumn, 5);
+    QCOMPARE(results.at(2).firstOutput, HeadlessCircuit(examplesDir.absoluteFilePath("display-4bits.panda")).outputLabels().at(2));
+    QCOMPARE(results.at(2).expected, wrongRows.at(2).at(5) == '1');
+
+    QCOMPARE(results.at(4).status, BatchGrader::Result::Status::Error);
+    QVERIFY(!results.at(4).error.isEmpty());
+
+    const auto json = grader.toJson(results);
+    QCOMPARE(json.value("passed").toInt(), 3);
+    QCOMPARE(json.value("failed").toInt(), 1);
+    QCOMPARE(json.value("errors").toInt(), 1);
+
+    // Native code grades sequential circuits the same, and falls back to the interpreter without a compiler.
+    BatchGrader nativeGrader({
+        {flipFlopFile, dir.filePath("flipflop.csv"), dir.filePath("flipflop-golden.csv")},
+        {examplesDir.absoluteFilePath("display-4bits.panda"), dir.filePath("display.csv"), dir.filePath("display-golden.csv")},
+    });
+    nativeGrader.setNative(true);
+
+    const auto nativeResults = nativeGrader.run();
+    QCOMPARE(nativeResults.at(0).status, BatchGrader::Result::Status::Passed);
+    QCOMPARE(nativeResults.at(1).status, BatchGrader::Result::Status::Passed);
+    QVERIFY(!nativeResults.at(1).native);
+}
+
+void TestSimulation::testFaultCoverage()
+{
+    const QDir examplesDir(QString(CURRENTDIR) + "/../examples/");
+    const QTemporaryDir temporaryDir;
+    QVERIFY(temporaryDir.isValid());
+    const QDir dir(temporaryDir.path());
+
+    // Every input combination of the display, and only the first one of them.
+    QStringList inputRows;
+    QStringList outputRows;
+    QVERIFY(readWaveform(examplesDir.absoluteFilePath("display-4bits.txt"), inputRows, outputRows));
+
+    QStringList firstRows;
+
+    for (auto &row : inputRows) {
+        row = row.left(row.indexOf(' '));
+        firstRows.append(row.left(1));
+    }
+
+    QVERIFY(writeWaveform(dir.filePath("all.csv"), inputRows));
+    QVERIFY(writeWaveform(dir.filePath("first.csv"), firstRows));
+
+    const QString circuitFile = examplesDir.absoluteFilePath("display-4bits.panda");
+    QVERIFY_EXCEPTION_THROWN(FaultCoverage faultCoverage(circuitFile, dir.filePath("missing.csv")), Pandaception);
+
+    const FaultCoverage allCoverage(circuitFile, dir.filePath("all.csv"));
+    QCOMPARE(allCoverage.vectors().size(), 16);
+    const auto allReport = allCoverage.run();
+    QVERIFY(!allReport.faults.isEmpty());
+
+    const FaultCoverage firstCoverage(circuitFile, dir.filePath("first.csv"));
+    QCOMPARE(firstCoverage.vectors().size(), 1);
+    const auto firstReport = firstCoverage.run();
+    QCOMPARE(firstReport.faults.size(), allReport.faults.size());
+    QVERIFY(firstReport.detectedCount() < allReport.detectedCount());
+
+    // The report lists every undetected fault by the element it is on, after the summary.
+    const auto undetected = firstReport.undetected();
+    const QStringList lines = firstCoverage.report(firstReport).trimmed().split('\n');
+    QCOMPARE(lines.size(), undetected.size() + 2);
+    QCOMPARE(lines.constFirst(), firstReport.summary());
+
+    for (int index = 0; index < undetected.size(); ++index) {
+        const auto &fault = undetected.at(index);
+        const QString elementName = firstCoverage.circuit().elementName(fault.logic);
+        QVERIFY(!elementName.isEmpty());
+        QVERIFY(lines.at(index + 2).trimmed().startsWith(elementName + ","));
+        QCOMPARE(lines.at(index + 2).trimmed(), firstCoverage.faultName(fault));
+    }
+
+    // An AND with a grounded input always drives 0, which an optimized netlist folds away, but its output stuck at 1
+    // still shows on the LED and must be counted.
+    WorkSpace workspace;
+
+    InputSwitch inputSwitch;
+    InputGnd gnd;
+    And andItem;
+    Led led;
+    QNEConnection connection1;
+    QNEConnection connection2;
+    QNEConnection connection3;
+
+    auto *scene = workspace.scene();
+    scene->addItem(&led);
+    scene->addItem(&andItem);
+    scene->addItem(&gnd);
+    scene->addItem(&inputSwitch);
+    scene->addItem(&connection1);
+    scene->addItem(&connection2);
+    scene->addItem(&connection3);
+
+    connection1.setStartPort(inputSwitch.outputPort());
+    connection1.setEndPort(andItem.inputPort(0));
+    connection2.setStartPort(gnd.outputPort());
+    connection2.setEndPort(andItem.inputPort(1));
+    connection3.setStartPort(andItem.outputPort());
+    connection3.setEndPort(led.inputPort());
+
+    workspace.save(dir.filePath("grounded.panda"));
+    QVERIFY(writeWaveform(dir.filePath("grounded.csv"), {"01"}));
+
+    const FaultCoverage groundedCoverage(dir.filePath("grounded.panda"), dir.filePath("grounded.csv"));
+    const auto groundedReport = groundedCoverage.run();
+    int stuckAtOne = -1;
+
+    for (int index = 0; index < groundedReport.faults.size(); ++index) {
+        const auto &fault = groundedReport.faults.at(index);
+
+        if (fault.stuckAt && groundedCoverage.circuit().elementName(fault.logic).startsWith("And")) {
+            stuckAtOne = index;
+        }
+    }
+
+    QVERIFY(stuckAtOne >= 0);
+    QCOMPARE(groundedReport.detectedBy.at(stuckAtOne), 0);
+}
+
+void TestSimulation::testTruthTable()
+{
+    const QDir examplesDir(QString(CURRENTDIR) + "/../examples/");
+
+    const HeadlessCircuit sequential(examplesDir.absoluteFilePath("counter.panda"));
+    QVERIFY_EXCEPTION_THROWN(TruthTable truthTable(sequential), Pandaception);
+
+    const HeadlessCircuit circuit(examplesDir.absoluteFilePath("display-4bits.panda"));
+    const TruthTable truthTable(circuit);
+    QCOMPARE(truthTable.rowCount(), quint64(16));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    truthTable.write(buffer);
+
+    const QStringList lines = QString(buffer.data()).trimmed().split('\n');
+    QCOMPARE(lines.size(), 17);
+    QVERIFY(lines.constFirst().startsWith("\"" + circuit.inputLabels().constFirst() + "\""));
+
+    // Row N of the table is column N of the waveform beWavedDolphin saves.
+    QStringList inputRows;
+    QStringList outputRows;
+    QVERIFY(readWaveform(examplesDir.absoluteFilePath("display-4bits.txt"), inputRows, outputRows));
+
+    for (int column = 0; column < 16; ++column) {
+        const QStringList row = lines.at(column + 1).split(" : ");
+        QCOMPARE(row.size(), 2);
+
+        for (int input = 0; input < inputRows.size(); ++input) {
+            QCOMPARE(row.at(0).at(input), inputRows.at(input).at(column));
+        }
+
+        for (int output = 0; output < outputRows.size(); ++output) {
+            QCOMPARE(row.at(1).at(output), outputRows.at(output).at(column));
+        }
+    }
+}
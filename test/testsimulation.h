@@ -11,4 +11,13 @@ class TestSimulation : public QObject
 
 private slots:
     void testCase1();
+    void testSelectiveUpdate();
+    void testEquivalenceChecker();
+    void testHeadlessCircuit();
+    void testHeadlessExamples();
+    void testHeadlessExamples_data();
+    void testSimulationThread();
+    void testBatchGrader();
+    void testFaultCoverage();
+    void testTruthTable();
 };